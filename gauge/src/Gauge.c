@@ -148,7 +148,12 @@ MENU_DESC diskMenuDesc[] =
 	{	NULL,					harddiskCallback,		NULL,			0x1007, NULL,	0,	1	},
 	{	NULL,					harddiskCallback,		NULL,			0x1008, NULL,	0,	1	},
 	{	NULL,					harddiskCallback,		NULL,			0x1009, NULL,	0,	1	},
-	{	NULL,					harddiskCallback,		NULL,			0x1010, NULL,	0,	1	},
+	{	NULL,					harddiskCallback,		NULL,			0x100A, NULL,	0,	1	},
+	{	NULL,					harddiskCallback,		NULL,			0x100B, NULL,	0,	1	},
+	{	NULL,					harddiskCallback,		NULL,			0x100C, NULL,	0,	1	},
+	{	NULL,					harddiskCallback,		NULL,			0x100D, NULL,	0,	1	},
+	{	NULL,					harddiskCallback,		NULL,			0x100E, NULL,	0,	1	},
+	{	NULL,					harddiskCallback,		NULL,			0x100F, NULL,	0,	1	},
 	{	NULL,					NULL,					NULL,			0	}
 };
 
@@ -158,6 +163,13 @@ MENU_DESC harddiskMenuDesc[] =
 	{	"-",					NULL,					NULL,				0		},
 	{	__("Sector Reads"),		harddiskCallback,		NULL,				0x100	},
 	{	__("Sector Writes"),	harddiskCallback,		NULL,				0x200	},
+	{	__("Read Operations"),	harddiskCallback,		NULL,				0x300	},
+	{	__("Write Operations"),	harddiskCallback,		NULL,				0x400	},
+	{	__("In Flight"),		harddiskCallback,		NULL,				0x500	},
+	{	__("Busy Time"),		harddiskCallback,		NULL,				0x600	},
+	{	__("Read Latency"),		harddiskCallback,		NULL,				0x700	},
+	{	__("Write Latency"),	harddiskCallback,		NULL,				0x800	},
+	{	__("Queue Depth"),		harddiskCallback,		NULL,				0x900	},
 	{	"-",					NULL,					NULL,				0		},
 	{	__("Which Disk"),		NULL,					diskMenuDesc,		0		},
 	{	NULL,					NULL,					NULL,				0		}
@@ -232,6 +244,11 @@ MENU_DESC networkDevDesc[] =
 	{	NULL,					networkCallback,		NULL,				0x1008, NULL,	0,	1	},
 	{	NULL,					networkCallback,		NULL,				0x1009, NULL,	0,	1	},
 	{	NULL,					networkCallback,		NULL,				0x100A, NULL,	0,	1	},
+	{	NULL,					networkCallback,		NULL,				0x100B, NULL,	0,	1	},
+	{	NULL,					networkCallback,		NULL,				0x100C, NULL,	0,	1	},
+	{	NULL,					networkCallback,		NULL,				0x100D, NULL,	0,	1	},
+	{	NULL,					networkCallback,		NULL,				0x100E, NULL,	0,	1	},
+	{	NULL,					networkCallback,		NULL,				0x100F, NULL,	0,	1	},
 	{	NULL,					NULL,					NULL,				0	}
 };
 
@@ -254,45 +271,18 @@ MENU_DESC memoryMenuDesc[] =
 	{	NULL,					NULL,					NULL,				0	}
 };
 
-MENU_DESC pickCPUMenuDesc[] =
-{
-	{	__("All"),				loadCallback,			NULL,				0x1000	},
-	{	__("CPU1"),				loadCallback,			NULL,				0x1001	},
-	{	__("CPU2"),				loadCallback,			NULL,				0x1002, NULL,	0,	1	},
-	{	__("CPU3"),				loadCallback,			NULL,				0x1003, NULL,	0,	1	},
-	{	__("CPU4"),				loadCallback,			NULL,				0x1004, NULL,	0,	1	},
-	{	__("CPU5"),				loadCallback,			NULL,				0x1005, NULL,	0,	1	},
-	{	__("CPU6"),				loadCallback,			NULL,				0x1006, NULL,	0,	1	},
-	{	__("CPU7"),				loadCallback,			NULL,				0x1007, NULL,	0,	1	},
-	{	__("CPU8"),				loadCallback,			NULL,				0x1008, NULL,	0,	1	},
-	{	__("CPU9"),				loadCallback,			NULL,				0x1009,	NULL,	0,	1	},
-	{	__("CPU10"),			loadCallback,			NULL,				0x100A, NULL,	0,	1	},
-	{	__("CPU11"),			loadCallback,			NULL,				0x100B, NULL,	0,	1	},
-	{	__("CPU12"),			loadCallback,			NULL,				0x100C, NULL,	0,	1	},
-	{	__("CPU13"),			loadCallback,			NULL,				0x100D, NULL,	0,	1	},
-	{	__("CPU14"),			loadCallback,			NULL,				0x100E, NULL,	0,	1	},
-	{	__("CPU15"),			loadCallback,			NULL,				0x100F, NULL,	0,	1	},
-	{	__("CPU16"),			loadCallback,			NULL,				0x1010, NULL,	0,	1	},
-	{	__("CPU17"),			loadCallback,			NULL,				0x1011, NULL,	0,	1	},
-	{	__("CPU18"),			loadCallback,			NULL,				0x1012, NULL,	0,	1	},
-	{	__("CPU19"),			loadCallback,			NULL,				0x1013, NULL,	0,	1	},
-	{	__("CPU20"),			loadCallback,			NULL,				0x1014, NULL,	0,	1	},
-	{	__("CPU21"),			loadCallback,			NULL,				0x1015, NULL,	0,	1	},
-	{	__("CPU22"),			loadCallback,			NULL,				0x1016, NULL,	0,	1	},
-	{	__("CPU23"),			loadCallback,			NULL,				0x1017, NULL,	0,	1	},
-	{	__("CPU24"),			loadCallback,			NULL,				0x1018, NULL,	0,	1	},
-	{	__("CPU25"),			loadCallback,			NULL,				0x1019, NULL,	0,	1	},
-	{	__("CPU26"),			loadCallback,			NULL,				0x101A, NULL,	0,	1	},
-	{	__("CPU27"),			loadCallback,			NULL,				0x101B, NULL,	0,	1	},
-	{	__("CPU28"),			loadCallback,			NULL,				0x101C, NULL,	0,	1	},
-	{	__("CPU29"),			loadCallback,			NULL,				0x101D, NULL,	0,	1	},
-	{	__("CPU30"),			loadCallback,			NULL,				0x101E, NULL,	0,	1	},
-	{	__("CPU31"),			loadCallback,			NULL,				0x101F, NULL,	0,	1	},
-	{	__("CPU32"),			loadCallback,			NULL,				0x1020, NULL,	0,	1	},
-
-	{	NULL,					NULL,					NULL,				0x1000	}
+MENU_DESC busyCPUMenuDesc[] =
+{
+	{	__("Busiest 2"),		loadCallback,			NULL,				0x4002	},
+	{	__("Busiest 4"),		loadCallback,			NULL,				0x4004	},
+	{	__("Busiest 8"),		loadCallback,			NULL,				0x4008	},
+	{	__("Busiest 16"),		loadCallback,			NULL,				0x4010	},
+	{	NULL,					NULL,					NULL,				0		}
 };
 
+/*----------------------------------------------------------------------------------------------------*
+ * The Which CPU menu is built by readCPUInit, sized for the number of processors                     *
+ *----------------------------------------------------------------------------------------------------*/
 MENU_DESC cpuMenuDesc[] =
 {
 	{	__("Average"),			loadCallback,			NULL,				0x2000	},
@@ -304,7 +294,8 @@ MENU_DESC cpuMenuDesc[] =
 	{	__("Idle"),				loadCallback,			NULL,				0x0400	},
 	{	__("ioWait"),			loadCallback,			NULL,				0x0500	},
 	{	"-",					NULL,					NULL,				0		},
-	{	__("Which CPU"),		NULL,					pickCPUMenuDesc,	0		},
+	{	__("Busiest Cores"),	NULL,					busyCPUMenuDesc,	0		},
+	{	__("Which CPU"),		NULL,					NULL,				0		},
 	{	NULL,					NULL,					NULL,				0		}
 };
 
@@ -384,6 +375,9 @@ int weHaveFocus					=  0;
 int currentFace					=  0;			/* Saved in the config file */
 int toolTipFace					=  0;
 int sysUpdateID					=  100;
+static int handsSliding			=  0;
+static int wasHidden			=  0;
+static int hiddenSlowDown		=  1;			/* Read from the config file */
 int allowSaveDisp				=  0;
 FACE_SETTINGS *faceSettings[MAX_FACES];
 char fontName[101]				=  "Sans";		// Saved in the config file
@@ -411,9 +405,17 @@ DIAL_CONFIG dialConfig =
 	&fontName[0],				/* Font name pointer */
 	updateGauge,				/* Update func. */
 	dialSave,					/* Save func. */
-	&colourNames[0]				/* Colour details */
+	&colourNames[0],			/* Colour details */
+	FALSE,						/* Hand sprites */
+	TRUE						/* Tile render */
 };
 
+/*----------------------------------------------------------------------------------------------------*
+ * Length of a tick, and the longest the main loop sleeps when no face needs to read                 *
+ *----------------------------------------------------------------------------------------------------*/
+#define GAUGE_TICK				200000
+#define GAUGE_IDLE_TICKS		300
+
 GAUGE_ENABLED gaugeEnabled[FACE_TYPE_MAX + 1] =
 {
 	{	"cpu_load",		1	},	{	"sensor_temp",	1	},	{	"sensor_fan",	1	},
@@ -430,7 +432,8 @@ static void processCommandLine		(int argc, char *argv[], int *posX, int *posY);
 static void howTo					(FILE * outFile, char *format, ...);
 static int	updateMaxMinValues		(FACE_SETTINGS *faceSetting, int firstValue);
 
-static gboolean clockTickCallback	(gpointer data);
+static int	faceTickPeriod			(FACE_SETTINGS *faceSetting);
+static gint64 clockTickCallback		(void);
 static gboolean windowClickCallback (GtkWidget * widget, GdkEventButton * event);
 static gboolean windowKeyCallback	(GtkWidget * widget, GdkEventKey * event);
 static gboolean focusInEvent		(GtkWidget *widget, GdkEventFocus *event, gpointer data);
@@ -442,6 +445,11 @@ char thermoServer[41] = "tinyfour";
 int thermoPort = 30302;
 char powerServer[41] = "littleone";
 int powerPort = 30303;
+char networkInclude[101] = "";
+char networkExclude[101] = "";
+bool networkNetlink = false;
+int rateSmoothing = 0;
+bool diskPartitions = false;
 
 /**********************************************************************************************************************
  *                                                                                                                    *
@@ -603,9 +611,17 @@ lockCallback (guint data)
 void
 aboutCallback (guint data)
 {
+	char comment[256];
 	char verString[81];
+	unsigned long textHits, textMisses;
 
+	dialTextCacheStats (&textHits, &textMisses);
 	sprintf (verString, _("Version: %s"), VERSION);
+	sprintf (comment, _("Gauge is a highly configurable analogue gauge,\n"
+					  "capable of monitoring many different system\n"
+					  "and environmental values.\n"
+					  "Labels reused: %lu, shaped: %lu"), textHits, textMisses);
+
 	/*------------------------------------------------------------------------------------------------*
      * Nice dialog that can be used with newer versions of the GTK API.                               *
      *------------------------------------------------------------------------------------------------*/
@@ -616,9 +632,7 @@ aboutCallback (guint data)
 #endif
 			"artists", artists,
 			"authors", authors,
-			"comments", _("Gauge is a highly configurable analogue gauge,\n"
-						  "capable of monitoring many different system\n"
-						  "and environmental values."),
+			"comments", comment,
 			"copyright", "Copyright © 2005 - 2020 Chris Knight <chris@theknight.co.uk>",
 			"logo", defaultIcon,
 			"version", verString,
@@ -739,6 +753,7 @@ windowClickCallback (GtkWidget * widget, GdkEventButton * event)
 	{
 		currentFace = ((int)event -> x / dialConfig.dialSize) + (((int)event -> y / dialConfig.dialSize) * dialConfig.dialWidth);
 		lastTime = -1;
+		dialTickWake ();
 
 		switch (event->button)
 		{
@@ -872,6 +887,7 @@ windowKeyCallback (GtkWidget * widget, GdkEventKey * event)
 			{
 				currentFace = keyPressFaceNum;
 				lastTime = -1;
+				dialTickWake ();
 			}
 		}
 	}
@@ -933,6 +949,8 @@ int calcShowValues (FACE_SETTINGS *faceSetting)
 	if (faceSetting -> shownFirstValue != firstValue)
 	{
 		faceSetting -> shownFirstValue = slideValues (faceSetting -> shownFirstValue, firstValue);
+		if (faceSetting -> shownFirstValue != firstValue)
+			++handsSliding;
 		++update;
 	}
 	if (faceSetting -> secondValue != DONT_SHOW)
@@ -944,6 +962,8 @@ int calcShowValues (FACE_SETTINGS *faceSetting)
 	if (faceSetting -> shownSecondValue != secondValue)
 	{
 		faceSetting -> shownSecondValue = slideValues (faceSetting -> shownSecondValue, secondValue);
+		if (faceSetting -> shownSecondValue != secondValue)
+			++handsSliding;
 		++update;
 	}
 	if (faceSetting -> faceFlags & FACE_REDRAW)
@@ -957,6 +977,50 @@ int calcShowValues (FACE_SETTINGS *faceSetting)
 	return update;
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  F A C E  T I C K  P E R I O D                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************//**
+ *  \brief How often a face reads, asked of the reader so the main loop wakes on the ticks it reads on.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks, 0 for the collector faces that are woken by their samplers.
+ */
+static int faceTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	switch (faceSetting -> showFaceType)
+	{
+	case FACE_TYPE_CPU_LOAD:
+		return cpuTickPeriod (faceSetting);
+	case FACE_TYPE_MEMORY:
+		return memoryTickPeriod (faceSetting);
+	case FACE_TYPE_BATTERY:
+		return batteryTickPeriod (faceSetting);
+	case FACE_TYPE_ENTROPY:
+		return entropyTickPeriod (faceSetting);
+	case FACE_TYPE_NETWORK:
+		return networkTickPeriod (faceSetting);
+	case FACE_TYPE_HARDDISK:
+		return harddiskTickPeriod (faceSetting);
+	case FACE_TYPE_SENSOR_TEMP:
+	case FACE_TYPE_SENSOR_FAN:
+		return sensorTickPeriod (faceSetting);
+	case FACE_TYPE_TIDE:
+		return tideTickPeriod (faceSetting);
+	case FACE_TYPE_WEATHER:
+		return weatherTickPeriod (faceSetting);
+	case FACE_TYPE_MOONPHASE:
+		return moonPhaseTickPeriod (faceSetting);
+	case FACE_TYPE_THERMO:
+	case FACE_TYPE_POWER:
+	case FACE_TYPE_WIFI:
+	default:
+		break;
+	}
+	return 0;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  C L O C K  T I C K  C A L L B A C K                                                                               *
@@ -965,13 +1029,36 @@ int calcShowValues (FACE_SETTINGS *faceSetting)
  **********************************************************************************************************************/
 /**
  *  \brief The timer when off.
- *  \param data Not used.
- *  \result None.
+ *  \result Monotonic time of the next tick a face or sampler needs.
  */
-gboolean
-clockTickCallback (gpointer data)
+static gint64
+clockTickCallback (void)
 {
-	int update = 0, i, j, face = 0;
+	int update = 0, i, j, face = 0, nextID, period, slow = 1;
+	gint64 due;
+	bool visible = dialVisible ();
+
+	/*------------------------------------------------------------------------------------------------*
+     * The readers count in ticks, work out which one this is from the time as ticks can be skipped   *
+     *------------------------------------------------------------------------------------------------*/
+	sysUpdateID = (int)(g_get_monotonic_time () / GAUGE_TICK);
+	handsSliding = 0;
+
+	/*------------------------------------------------------------------------------------------------*
+     * While the window can not be seen keep reading but do not draw, optionally reading less often.  *
+     * The shown values are left alone so the hands slide from there when it is seen again.           *
+     *------------------------------------------------------------------------------------------------*/
+	if (!visible)
+	{
+		slow = hiddenSlowDown;
+		wasHidden = 1;
+	}
+	else if (wasHidden)
+	{
+		lastTime = -1;
+		wasHidden = 0;
+	}
+	collectorSlowDown (slow);
 
 	for (j = 0; j < dialConfig.dialHeight; j++)
 	{
@@ -1047,24 +1134,66 @@ clockTickCallback (gpointer data)
 				faceSettings[face] -> firstValue = 0;
 				break;
 			}
-			update += calcShowValues (faceSettings[face]);
+			if (visible && calcShowValues (faceSettings[face]))
+			{
+				dialFaceDirty (face);
+				++update;
+			}
 			++face;
 		}
 	}
-	if (lastTime == -1)
+	if (!visible)
 	{
-		++update;
+		;
+	}
+	else if (lastTime == -1)
+	{
+		/*--------------------------------------------------------------------------------------------*
+         * Focus or the current face changed, so redraw everything                                    *
+         *--------------------------------------------------------------------------------------------*/
+		for (face = 0; face < dialConfig.dialWidth * dialConfig.dialHeight; ++face)
+			dialFaceDirty (face);
+		dialQueueDirtyFaces ();
+		lastTime = time (NULL);
+	}
+	else if (update)
+	{
+		/*--------------------------------------------------------------------------------------------*
+         * Only redraw the faces that have changed                                                    *
+         *--------------------------------------------------------------------------------------------*/
+		dialQueueDirtyFaces ();
+		lastTime = time (NULL);
 	}
-	if (update)
+	collectorSchedule ();
+
+	/*------------------------------------------------------------------------------------------------*
+     * Sleep until the next tick a face reads on, or the next sample is due, unless a hand is still   *
+     * sliding to its new value                                                                       *
+     *------------------------------------------------------------------------------------------------*/
+	if (handsSliding)
 	{
-		if (dialConfig.drawingArea)
+		nextID = sysUpdateID + 1;
+	}
+	else
+	{
+		nextID = sysUpdateID + GAUGE_IDLE_TICKS;
+		for (face = 0; face < dialConfig.dialWidth * dialConfig.dialHeight; ++face)
 		{
-			gtk_widget_queue_draw (dialConfig.drawingArea);
+			if (!faceSettings[face] || faceSettings[face] -> showFaceType < 0 ||
+					faceSettings[face] -> showFaceType > FACE_TYPE_MAX)
+				continue;
+			period = faceTickPeriod (faceSettings[face]) * slow;
+			if (period > 0)
+			{
+				if (sysUpdateID - (sysUpdateID % period) + period < nextID)
+					nextID = sysUpdateID - (sysUpdateID % period) + period;
+			}
 		}
-		lastTime = time (NULL);
 	}
-	++sysUpdateID;
-	return TRUE;
+	due = (gint64)nextID * GAUGE_TICK;
+	if (collectorNextRun () < due)
+		due = collectorNextRun ();
+	return due;
 }
 
 /**********************************************************************************************************************
@@ -1084,6 +1213,7 @@ gboolean
 focusInEvent (GtkWidget *widget, GdkEventFocus *event, gpointer data)
 {
 	lastTime = -1;
+	dialTickWake ();
 	weHaveFocus = 1;
 	return TRUE;
 }
@@ -1105,6 +1235,7 @@ gboolean
 focusOutEvent (GtkWidget *widget, GdkEventFocus *event, gpointer data)
 {
 	lastTime = -1;
+	dialTickWake ();
 	weHaveFocus = 0;
 	return TRUE;
 }
@@ -1172,6 +1303,8 @@ void gaugeReset (int face, int type, int subType)
 	faceSettings[face] -> faceFlags = FACE_REDRAW;
 	faceSettings[face] -> faceScaleMin = 0;
 	faceSettings[face] -> faceScaleMax = 100;
+	dialFaceCacheInvalidate (face);
+	dialTickWake ();
 
 	sprintf (value, "show_face_type_%d", face + 1);
 	configSetIntValue (value, type);
@@ -1199,20 +1332,31 @@ loadCallback (guint data)
 	{
 		faceSubType = 0x0F00;
 	}
+	else if (data & 0x4000)
+	{
+		/*--------------------------------------------------------------------------------------------*
+         * Busiest N cores, N is in the processor number bits                                         *
+         *--------------------------------------------------------------------------------------------*/
+		faceSubType = 0x0E00 | (data & 0x00FF);
+	}
 	else if (faceSettings[currentFace] -> showFaceType == FACE_TYPE_CPU_LOAD)
 	{
-		if (data & 0x1000)
+		int oldType = faceSettings[currentFace] -> faceSubType & 0x0F00;
+
+		if (oldType == 0x0E00 || oldType == 0x0F00)
+			faceSubType = (data & 0x1000) ? (data & 0xFF00FF) : (data & 0x0F00);
+		else if (data & 0x1000)
 		{
-			faceSubType = faceSettings[currentFace] -> faceSubType & 0x0F00;
-			faceSubType |= (data & 0x00FF);
+			faceSubType = oldType;
+			faceSubType |= (data & 0xFF00FF);
 		}
 		else
 		{
-			faceSubType = faceSettings[currentFace] -> faceSubType & 0x00FF;
+			faceSubType = faceSettings[currentFace] -> faceSubType & 0xFF00FF;
 			faceSubType |= (data & 0x0F00);
 		}
 	}
-	faceSubType &= 0x0FFF;
+	faceSubType &= 0xFF0FFF;
 
 	gaugeReset (currentFace, FACE_TYPE_CPU_LOAD, faceSubType);
 	faceSettings[currentFace] -> faceFlags |= FACE_HOT_COLD;
@@ -1644,6 +1788,7 @@ userActive (GtkWidget *widget, GdkEvent* event, gpointer data)
 	{
 		toolTipFace = newFace;
 		lastTime = -1;
+		dialTickWake ();
 	}
 	return TRUE;
 }
@@ -2044,6 +2189,7 @@ void updateGauge (void)
 	configSetIntValue ("gradient", dialConfig.dialGradient);
 	configSetValue ("font_name", fontName);
 	lastTime = -1;
+	dialTickWake ();
 }
 
 /**********************************************************************************************************************
@@ -2081,6 +2227,11 @@ void loadConfig (int *posX, int *posY)
 	configGetIntValue ("gauge_mark_step", &dialConfig.markerStep);
 	configGetIntValue ("opacity", &dialConfig.dialOpacity);
 	configGetIntValue ("gradient", &dialConfig.dialGradient);
+	configGetBoolValue ("hand_sprites", &dialConfig.handSprites);
+	configGetBoolValue ("tile_render", &dialConfig.tileRender);
+	configGetIntValue ("hidden_slow_down", &hiddenSlowDown);
+	if (hiddenSlowDown < 1)
+		hiddenSlowDown = 1;
 	configGetIntValue ("gauge_x_pos", posX);
 	configGetIntValue ("gauge_y_pos", posY);
 	configGetValue ("font_name", fontName, 100);
@@ -2091,6 +2242,11 @@ void loadConfig (int *posX, int *posY)
 	configGetIntValue ("thermo_port", &thermoPort);
 	configGetValue ("power_server", powerServer, 40);
 	configGetIntValue ("power_port", &powerPort);
+	configGetValue ("network_include", networkInclude, 100);
+	configGetValue ("network_exclude", networkExclude, 100);
+	configGetBoolValue ("network_netlink", &networkNetlink);
+	configGetIntValue ("rate_smoothing", &rateSmoothing);
+	configGetBoolValue ("disk_partitions", &diskPartitions);
 
 	for (i = 2; i < MAX__COLOURS; i++)
 	{
@@ -2427,6 +2583,7 @@ main (int argc, char *argv[])
 
 	g_signal_connect (G_OBJECT (dialConfig.mainWindow), "focus-in-event", G_CALLBACK(focusInEvent), NULL);
 	g_signal_connect (G_OBJECT (dialConfig.mainWindow), "focus-out-event", G_CALLBACK(focusOutEvent), NULL);
+	dialVisibleInit (dialConfig.mainWindow);
 	eventBox = gtk_event_box_new ();
 
 	gtk_container_add (GTK_CONTAINER (eventBox), dialConfig.drawingArea);
@@ -2499,7 +2656,7 @@ main (int argc, char *argv[])
      * OK all ready lets run it!                                                                      *
      *------------------------------------------------------------------------------------------------*/
 	gtk_widget_show_all (GTK_WIDGET (dialConfig.mainWindow));
-	g_timeout_add (200, clockTickCallback, NULL);
+	dialTickStart (clockTickCallback);
 	dialSetOpacity();
 	{
 		prepareForPopup ();
@@ -2507,6 +2664,10 @@ main (int argc, char *argv[])
 	}
 	i = nice (5);
 	gtk_main ();
+	dialTickStop ();
+	collectorFree ();
+	httpFree ();
+	dialTilesFree ();
 	exit (0);
 }
 
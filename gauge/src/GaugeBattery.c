@@ -27,6 +27,8 @@
 
 #include "GaugeDisp.h"
 
+#define BATTERY_TICKS 25
+
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
@@ -86,6 +88,22 @@ void readBatteryInit (void)
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B A T T E R Y  T I C K  P E R I O D                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a battery face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int batteryTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return BATTERY_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  B A T T E R Y  V A L U E S                                                                               *
@@ -107,7 +125,7 @@ void readBatteryValues (int face)
 		{
 			;
 		}
-		else if (sysUpdateID % 25 != 0)
+		else if (sysUpdateID % batteryTickPeriod (faceSetting) != 0)
 		{
 			return;
 		}
@@ -22,29 +22,72 @@
  */
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
 #include "GaugeDisp.h"
 
-#define CPU_COUNT 32
+#define STAT_FIELDS 9
+#define STAT_BUFF_SIZE 16384
+#define CPU_BUSIEST 0x0E
+#define CPU_AVERAGE 0x0F
+#define CPU_MAX_BUSY 16
+#define CPU_LOAD_TICKS 2
+#define CPU_AVERAGE_TICKS 5
+
+/*----------------------------------------------------------------------------------------------------*
+ * The tables are stored by field then processor, each field starts on a cache line.                  *
+ *----------------------------------------------------------------------------------------------------*/
+#define CPU_TABLE(table, field, proc) (table)[((field) * cpuStride) + (proc)]
 
 extern FACE_SETTINGS *faceSettings[];
 extern MENU_DESC gaugeMenuDesc[];
-extern MENU_DESC pickCPUMenuDesc[];
+extern MENU_DESC cpuMenuDesc[];
+extern MENU_DESC busyCPUMenuDesc[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern int sysUpdateID;
 
-void readCPULoad (int procNumber);
-int readStats (unsigned long long *stats, int procNumber);
+void readCPULoad (void);
+static void readBusyLoad (void);
+int readStats (void);
 int readAverage (float stats[]);
 int readClockRates (void);
 
 static int readCount[3];
 static float loadAverages[3];
-static int clockRates[CPU_COUNT + 1];
-static int myUpdateID[CPU_COUNT + 1];
-static int loadValues[CPU_COUNT + 1][8];
-static unsigned long long startStats[CPU_COUNT + 1][10];
-static unsigned long long endStats[CPU_COUNT + 1][10];
 static int cpuCount = 0;
+
+/*----------------------------------------------------------------------------------------------------*
+ * Sized at start up from the number of configured processors, plus one for the total.               *
+ *----------------------------------------------------------------------------------------------------*/
+static int cpuTotal = 0;
+static int cpuStride = 0;
+static int loadUpdateID = -1;
+static int *clockRates = NULL;
+static int *loadValues = NULL;
+static float *loadScale = NULL;
+static int *clockFiles = NULL;
+static int clockUpdateID = -1;
+static int clockReadCount = 0;
+static MENU_DESC *pickCPUMenuDesc = NULL;
+
+/*----------------------------------------------------------------------------------------------------*
+ * /proc/stat is read once per update into statTicks, all the CPU faces use that. The fields are:    *
+ * [0] total busy, [1] user, [2] nice, [3] system, [4] idle, [5] ioWait, [6] irq, [7] softIrq, ...   *
+ *----------------------------------------------------------------------------------------------------*/
+static int statFile = -1;
+static char *statBuffer = NULL;
+static size_t statBuffSize = 0;
+static int statUpdateID = -1;
+static int statCPUs = 0;
+static unsigned long long *statTicks = NULL;
+static unsigned long long *startStats = NULL;
+static unsigned long long *totalTicks = NULL;
+
+/*----------------------------------------------------------------------------------------------------*
+ * The busiest faces keep their own start point, so they do not cut short the other faces' windows    *
+ *----------------------------------------------------------------------------------------------------*/
+static unsigned long long *busyStats = NULL;
+static int *busyLoads = NULL;
+static int busyUpdateID = -1;
 char *name[8] =
 {
 	__("Total"),
@@ -57,6 +100,98 @@ char *name[8] =
 	__("softIrq")
 };
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C P U  A L L O C  T A B L E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Allocate a zeroed table aligned to a cache line.
+ *  \param size Size of the table in bytes.
+ *  \result Pointer to the table, or NULL.
+ */
+static void *cpuAllocTable (size_t size)
+{
+	void *table = NULL;
+
+	if (posix_memalign (&table, 64, size) != 0)
+		return NULL;
+
+	memset (table, 0, size);
+	return table;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C P U  C R E A T E  M E N U                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Build the pick CPU menu, entries are enabled as the processors are found in /proc/stat.
+ *  \result True if the menu was built.
+ */
+static int cpuCreateMenu (void)
+{
+	int i;
+	char menuName[21];
+
+	if ((pickCPUMenuDesc = calloc (cpuTotal + 1, sizeof (MENU_DESC))) == NULL)
+		return 0;
+
+	for (i = 0; i < cpuTotal; ++i)
+	{
+		if (i == 0)
+			strcpy (menuName, __("All"));
+		else
+			sprintf (menuName, "%s%d", _("CPU"), i);
+
+		pickCPUMenuDesc[i].menuName = strdup (menuName);
+		pickCPUMenuDesc[i].funcCallBack = loadCallback;
+		pickCPUMenuDesc[i].param = 0x1000 | (i & 0x00FF) | ((i & 0xFF00) << 8);
+		pickCPUMenuDesc[i].disable = (i > 1);
+	}
+	cpuMenuDesc[MENU_CPU_PICK].subMenuDesc = pickCPUMenuDesc;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Only offer busiest N cores if there are more than N cores                                      *
+     *------------------------------------------------------------------------------------------------*/
+	for (i = 0; busyCPUMenuDesc[i].menuName; ++i)
+	{
+		if ((int)(busyCPUMenuDesc[i].param & 0x00FF) >= cpuTotal - 1)
+			busyCPUMenuDesc[i].disable = 1;
+	}
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  C L O C K  I N I T                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Open the cpufreq files once, they are read with pread on each update.
+ *  \result None.
+ */
+static void readClockInit (void)
+{
+	int i;
+	char fileName[81];
+
+	cpuCount = 0;
+	for (i = 0; i < cpuTotal - 1; ++i)
+	{
+		sprintf (fileName, "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", i);
+		if ((clockFiles[i] = open (fileName, O_RDONLY)) == -1)
+			break;
+		++cpuCount;
+	}
+	for (; i < cpuTotal; ++i)
+		clockFiles[i] = -1;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  C P U I N I T                                                                                            *
@@ -71,16 +206,89 @@ void readCPUInit (void)
 {
 	if (gaugeEnabled[FACE_TYPE_CPU_LOAD].enabled)
 	{
-		int i = 0;
-		for (i = 0; i < CPU_COUNT; ++i)
+		long configured = sysconf (_SC_NPROCESSORS_CONF);
+
+		cpuTotal = (configured > 0 ? (int)configured : 1) + 1;
+		if (cpuTotal > 0xFFFF)
+			cpuTotal = 0xFFFF;
+		cpuStride = (cpuTotal + 15) & ~15;
+
+		statTicks = cpuAllocTable (STAT_FIELDS * cpuStride * sizeof (unsigned long long));
+		startStats = cpuAllocTable (STAT_FIELDS * cpuStride * sizeof (unsigned long long));
+		busyStats = cpuAllocTable (STAT_FIELDS * cpuStride * sizeof (unsigned long long));
+		busyLoads = cpuAllocTable (cpuStride * sizeof (int));
+		totalTicks = cpuAllocTable (cpuStride * sizeof (unsigned long long));
+		loadScale = cpuAllocTable (cpuStride * sizeof (float));
+		loadValues = cpuAllocTable (8 * cpuStride * sizeof (int));
+		clockRates = cpuAllocTable (cpuStride * sizeof (int));
+		clockFiles = cpuAllocTable (cpuStride * sizeof (int));
+
+		if (statTicks == NULL || startStats == NULL || busyStats == NULL || busyLoads == NULL ||
+				totalTicks == NULL || loadScale == NULL || loadValues == NULL || clockRates == NULL ||
+				clockFiles == NULL || !cpuCreateMenu ())
 		{
-			myUpdateID[i] = 100;
-			readStats (&startStats[i][0], i);
+			gaugeEnabled[FACE_TYPE_CPU_LOAD].enabled = 0;
+			return;
 		}
+		readClockInit ();
+		readStats ();
+		memcpy (startStats, statTicks, STAT_FIELDS * cpuStride * sizeof (unsigned long long));
+		memcpy (busyStats, statTicks, STAT_FIELDS * cpuStride * sizeof (unsigned long long));
 		gaugeMenuDesc[MENU_GAUGE_LOAD].disable = 0;
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  B U S I E S T                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find the busiest processors.
+ *  \param busyCount How many to find.
+ *  \param busyProcs Save the processor numbers here, busiest first.
+ *  \result The number found.
+ */
+static int readBusiest (int busyCount, int *busyProcs)
+{
+	int i, j, found = 0;
+
+	for (i = 1; i < statCPUs; ++i)
+	{
+		int load = busyLoads[i];
+
+		for (j = found; j > 0 && busyLoads[busyProcs[j - 1]] < load; --j)
+		{
+			if (j < busyCount)
+				busyProcs[j] = busyProcs[j - 1];
+		}
+		if (j < busyCount)
+		{
+			busyProcs[j] = i;
+			if (found < busyCount)
+				++found;
+		}
+	}
+	return found;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C P U  T I C K  P E R I O D                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a CPU face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int cpuTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return ((faceSetting -> faceSubType >> 8) & 0x000F) == CPU_AVERAGE ? CPU_AVERAGE_TICKS : CPU_LOAD_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  C P U V A L U E S                                                                                        *
@@ -99,9 +307,9 @@ void readCPUValues (int face)
 		FACE_SETTINGS *faceSetting = faceSettings[face];
 		int i, update = 0;
 		int faceType = (faceSetting -> faceSubType >> 8) & 0x000F;
-		int procNumber = faceSetting -> faceSubType & 0x00FF;
+		int procNumber = (faceSetting -> faceSubType & 0x00FF) | ((faceSetting -> faceSubType >> 8) & 0xFF00);
 		unsigned int step, newVal = 0;
-		char cpuName[10];
+		char cpuName[21];
 
 		if (faceSetting -> faceFlags & FACE_REDRAW)
 		{
@@ -109,22 +317,70 @@ void readCPUValues (int face)
 			faceSetting -> firstValue = newVal;
 			update = 1;
 		}
-		if (faceType != 0x0F)
+		if (faceType == CPU_BUSIEST)
 		{
-			if (!update && sysUpdateID % 2 != 0)
+			int busyProcs[CPU_MAX_BUSY], busyCount, totalLoad = 0;
+			char busyText[CPU_MAX_BUSY * 30 + 1];
+
+			if (!update && sysUpdateID % CPU_LOAD_TICKS != 0)
 				return;
 
-			strcpy (cpuName, _("CPU"));
-			if (procNumber)
+			if (procNumber < 1)
+				procNumber = 1;
+			if (procNumber > CPU_MAX_BUSY)
+				procNumber = CPU_MAX_BUSY;
+
+			readBusyLoad ();
+			busyCount = readBusiest (procNumber, busyProcs);
+			for (i = 0; i < busyCount; ++i)
+				totalLoad += busyLoads[busyProcs[i]];
+			newVal = busyCount ? (totalLoad + (busyCount / 2)) / busyCount : 0;
+
+			if (!update)
 			{
-				sprintf (&cpuName[3], "%d", procNumber);
+				step = abs (faceSetting -> firstValue - newVal);
+				if (--faceSetting -> nextUpdate <= 0 || step > 10)
+				{
+					faceSetting -> nextUpdate = (5 - (step / 2));
+					update = 1;
+				}
 			}
-			if (myUpdateID[procNumber] != sysUpdateID)
+			if (update)
 			{
-				readCPULoad (procNumber);
-				myUpdateID[procNumber] = sysUpdateID;
+				int busiestLoad = busyCount ? busyLoads[busyProcs[0]] : 0;
+
+				faceSetting -> firstValue = newVal;
+				faceSetting -> secondValue = busiestLoad;
+
+				busyText[0] = 0;
+				for (i = 0; i < busyCount; ++i)
+				{
+					sprintf (&busyText[strlen (busyText)], _("\n<b>CPU%d</b>: %d%%"), busyProcs[i],
+							busyLoads[busyProcs[i]]);
+				}
+				setFaceString (faceSetting, FACESTR_TOP, 0, _("Busiest %d\nCPUs"), procNumber);
+				setFaceString (faceSetting, FACESTR_WIN, 0, _("Busiest %d CPUs - Gauge"), procNumber);
+				setFaceString (faceSetting, FACESTR_BOT, 0, _("%d%%\n(%d%%)"), newVal, busiestLoad);
+				setFaceString (faceSetting, FACESTR_TIP, 0, _("<b>Busiest %d CPUs</b>: %d%%\n<b>CPU Count</b>: %d%s"),
+						procNumber, newVal, statCPUs - 1, busyText);
+				memcpy (busyStats, statTicks, STAT_FIELDS * cpuStride * sizeof (unsigned long long));
+			}
+		}
+		else if (faceType != CPU_AVERAGE)
+		{
+			if (!update && sysUpdateID % CPU_LOAD_TICKS != 0)
+				return;
+
+			if (procNumber >= cpuTotal)
+				procNumber = 0;
+
+			strcpy (cpuName, _("CPU"));
+			if (procNumber)
+			{
+				sprintf (&cpuName[strlen (cpuName)], "%d", procNumber);
 			}
-			newVal = loadValues[procNumber][faceType];
+			readCPULoad ();
+			newVal = CPU_TABLE (loadValues, faceType, procNumber);
 			if (!update)
 			{
 				step = abs (faceSetting -> firstValue - newVal);
@@ -141,16 +397,16 @@ void readCPUValues (int face)
 				readClockRates ();
 				setFaceString (faceSetting, FACESTR_TOP, 0, _("%s\n(%s)"), cpuName, name[faceType]);
 				setFaceString (faceSetting, FACESTR_WIN, 0, _("%s %s - Gauge"), cpuName, name[faceType]);
-				setFaceString (faceSetting, FACESTR_BOT, 0, _("%0.2f MHz\n%d%%"), (float)clockRates[faceType] / 1000, percent);
+				setFaceString (faceSetting, FACESTR_BOT, 0, _("%0.2f MHz\n%d%%"), (float)clockRates[procNumber] / 1000, percent);
 				setFaceString (faceSetting, FACESTR_TIP, 0, _("<b>%s %s</b>: %d%%\n<b>CPU Count</b>: %d\n<b>Clock</b>: %0.2f MHz"), 
-						cpuName, name[faceType], percent, cpuCount, (float)clockRates[faceType] / 1000);
+						cpuName, name[faceType], percent, cpuCount, (float)clockRates[procNumber] / 1000);
 				for (i = 0; i < 8; i++)
-					startStats[procNumber][i] = endStats[procNumber][i];
+					CPU_TABLE (startStats, i, procNumber) = CPU_TABLE (statTicks, i, procNumber);
 			}
 		}
 		else
 		{
-			if (!update && sysUpdateID % 5 != 0)
+			if (!update && sysUpdateID % CPU_AVERAGE_TICKS != 0)
 				return;
 
 			setFaceString (faceSetting, FACESTR_TOP, 0, _("Load\nAverage"));
@@ -182,6 +438,52 @@ void readCPUValues (int face)
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C P U  L O A D  W I N D O W                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Work out the load on every processor from a start point to the latest ticks. The loops run
+ *  over all the processors for one field at a time so the compiler can vectorise them.
+ *  \param fromStats Start point of the window, a table like statTicks.
+ *  \param loadTable Save the loads here, a table like loadValues.
+ *  \param fields How many fields to work out, from the total.
+ *  \param procs Number of processors (including the total) read.
+ *  \result None.
+ */
+static void cpuLoadWindow (const unsigned long long *fromStats, int *loadTable, int fields, int procs)
+{
+	int i, j;
+
+	for (j = 0; j < procs; ++j)
+		totalTicks[j] = 0;
+	for (i = 1; i < 8; i++)
+	{
+		const unsigned long long *endPtr = &CPU_TABLE (statTicks, i, 0);
+		const unsigned long long *startPtr = &CPU_TABLE (fromStats, i, 0);
+
+		for (j = 0; j < procs; ++j)
+			totalTicks[j] += endPtr[j] - startPtr[j];
+	}
+	for (j = 0; j < procs; ++j)
+		loadScale[j] = totalTicks[j] ? 100.0f / (float)totalTicks[j] : 0.0f;
+
+	for (i = 0; i < fields; i++)
+	{
+		const unsigned long long *endPtr = &CPU_TABLE (statTicks, i, 0);
+		const unsigned long long *startPtr = &CPU_TABLE (fromStats, i, 0);
+		int *loadPtr = &CPU_TABLE (loadTable, i, 0);
+
+		for (j = 0; j < procs; ++j)
+		{
+			int load = (int)(((float)(long long)(endPtr[j] - startPtr[j]) * loadScale[j]) + 0.5f);
+			loadPtr[j] = totalTicks[j] ? load : loadPtr[j];
+		}
+	}
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  C P U L O A D                                                                                            *
@@ -189,93 +491,142 @@ void readCPUValues (int face)
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Which processor to read from.
- *  \param procNumber Which processor to read from.
+ *  \brief Work out the load on every processor since its last start point, once per update.
  *  \result none.
  */
-void readCPULoad (int procNumber)
+void readCPULoad (void)
 {
-	int i, totalTicks = 0;
+	int procs;
 
-	readStats (&endStats[procNumber][0], procNumber);
-	for (i = 1; i < 8; i++)
-		totalTicks += (endStats[procNumber][i] - startStats[procNumber][i]);
-	if (totalTicks == 0)
+	if (loadUpdateID == sysUpdateID)
 		return;
-	for (i = 0; i < 8; i++)
-	{
-		loadValues[procNumber][i] = ((endStats[procNumber][i] - startStats[procNumber][i]) * 100) + (totalTicks / 2);
-		loadValues[procNumber][i] /= totalTicks;
-	}
-	return;
+
+	procs = readStats ();
+	loadUpdateID = sysUpdateID;
+	cpuLoadWindow (startStats, loadValues, 8, procs);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  R E A D  S T A T S                                                                                                *
- *  ==================                                                                                                *
+ *  R E A D  B U S Y  L O A D                                                                                         *
+ *  =========================                                                                                         *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Open the /proc/stat file and read the CPU status.
- *  \param stats Where to read the stats to.
- *  \param procNumber Which processor to read from.
- *  \result Number of words read.
+ *  \brief Work out the total load on every processor since the busiest faces last updated.
+ *  \result None.
  */
-int readStats (unsigned long long *stats, int procNumber)
+static void readBusyLoad (void)
 {
-	int i, j, n = 0, found = 0;
-	char readBuff[1025], word[254], procName[41];
-	FILE *inCPUFile = fopen ("/proc/stat", "r");
+	int procs;
 
-	strcpy (procName, "cpu");
-	if (procNumber) sprintf (&procName[3], "%d", procNumber - 1);
+	if (busyUpdateID == sysUpdateID)
+		return;
 
-	while (inCPUFile != NULL && !found)
+	procs = readStats ();
+	busyUpdateID = sysUpdateID;
+	cpuLoadWindow (busyStats, busyLoads, 1, procs);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  P A R S E  S T A T S                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Parse all the cpu lines at the start of /proc/stat in to the tick table.
+ *  \result 1 if the end of the cpu lines was found, 0 if the buffer was too small.
+ */
+static int parseStats (void)
+{
+	char *readPtr = statBuffer;
+	int n, procNumber;
+
+	statCPUs = 0;
+	while (strncmp (readPtr, "cpu", 3) == 0)
 	{
-		word[i = j = n = 0] = 0;
-		if (!fgets (readBuff, 1024, inCPUFile))
-			break;
+		readPtr += 3;
+		procNumber = 0;
+		if (*readPtr >= '0' && *readPtr <= '9')
+			procNumber = (int)strtol (readPtr, &readPtr, 10) + 1;
 
-		while (n < 9)
+		if (procNumber < cpuTotal)
 		{
-			if (readBuff[i] == ' ' || readBuff[i] == 0)
-			{
-				if (word[0] != 0)
-				{
-					if (n == 0)
-					{
-						if (strcmp (word, procName) != 0)
-							break;
-						pickCPUMenuDesc[procNumber].disable = 0;
-						stats[0] = 0;
-						found = 1;
-					}
-					else
-					{
-						stats[n] = atoll (word);
-						if (n != 4)					/* Ignore Idle ticks */
-							stats[0] += stats[n];	/* Count all other ticks */
-					}
-					word[j = 0] = 0;
-					n ++;
-				}
-				if (readBuff[i] == 0)
-					break;
-			}
-			else
+			CPU_TABLE (statTicks, 0, procNumber) = 0;
+			for (n = 1; n < STAT_FIELDS; ++n)
 			{
-				word[j++] = readBuff[i];
-				word[j] = 0;
+				CPU_TABLE (statTicks, n, procNumber) = strtoull (readPtr, &readPtr, 10);
+				if (n != 4)															/* Ignore Idle ticks */
+					CPU_TABLE (statTicks, 0, procNumber) += CPU_TABLE (statTicks, n, procNumber);	/* Count all other ticks */
 			}
-			i ++;
+			pickCPUMenuDesc[procNumber].disable = 0;
+			if (procNumber >= statCPUs)
+				statCPUs = procNumber + 1;
 		}
+		if ((readPtr = strchr (readPtr, '\n')) == NULL)
+			return 0;
+		++readPtr;
 	}
-	if (inCPUFile != NULL)
+	return *readPtr != 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  S T A T S                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read /proc/stat once per update and fill in the tick table for every processor.
+ *  \result Number of processors (including the total) read.
+ */
+int readStats (void)
+{
+	ssize_t readSize;
+	char *newBuffer;
+
+	if (statUpdateID == sysUpdateID && statCPUs)
+		return statCPUs;
+	if (statTicks == NULL)
+		return 0;
+
+	if (statFile == -1)
+	{
+		if ((statFile = open ("/proc/stat", O_RDONLY)) == -1)
+			return 0;
+	}
+	if (statBuffer == NULL)
 	{
-		fclose (inCPUFile);
+		if ((statBuffer = malloc (STAT_BUFF_SIZE)) == NULL)
+			return 0;
+		statBuffSize = STAT_BUFF_SIZE;
+	}
+
+	while (1)
+	{
+		if ((readSize = pread (statFile, statBuffer, statBuffSize - 1, 0)) < 0)
+		{
+			close (statFile);
+			statFile = -1;
+			return 0;
+		}
+		statBuffer[readSize] = 0;
+
+		/*--------------------------------------------------------------------------------------------*
+         * If all the cpu lines did not fit then make the buffer bigger and try again                 *
+         *--------------------------------------------------------------------------------------------*/
+		if (parseStats () || (size_t)readSize < statBuffSize - 1)
+			break;
+
+		newBuffer = realloc (statBuffer, statBuffSize * 2);
+		if (newBuffer == NULL)
+			break;
+		statBuffer = newBuffer;
+		statBuffSize *= 2;
 	}
-	return n;
+	statUpdateID = sysUpdateID;
+	return statCPUs;
 }
 
 /**********************************************************************************************************************
@@ -311,37 +662,37 @@ int readAverage (float readAvs[])
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Read the cpuinfo clock speed.
- *  \result None.
+ *  \brief Read the cpufreq clock speeds, at most once per update.
+ *  \result Number of clock speeds read.
  */
 int readClockRates ()
 {
 	int i = 0, retn = 0;
-	char readBuff[512];
-	FILE *readFile;
+	char readBuff[41];
+	ssize_t readSize;
 
-	cpuCount = 0;
+	if (clockUpdateID == sysUpdateID)
+		return clockReadCount;
+
+	clockUpdateID = sysUpdateID;
 	clockRates[0] = 0;
-	for (i = 0; i < CPU_COUNT; ++i)
+	for (i = 0; i < cpuCount; ++i)
 	{
-		sprintf (readBuff, "/sys/devices/system/cpu/cpu%d/cpufreq/scaling_cur_freq", i);
-		if ((readFile = fopen (readBuff, "r")) != NULL)
-		{
-			++cpuCount;
-			if (fgets(readBuff, 510, readFile))
-			{
-				clockRates[++retn] = atoi (readBuff) / 1000;
-				clockRates[0] += clockRates[retn];
-			}
-			fclose (readFile);
+		if (clockFiles[i] == -1)
 			continue;
+
+		if ((readSize = pread (clockFiles[i], readBuff, 40, 0)) > 0)
+		{
+			readBuff[readSize] = 0;
+			clockRates[i + 1] = atoi (readBuff) / 1000;
+			clockRates[0] += clockRates[i + 1];
+			++retn;
 		}
-		break;
 	}
 	if (retn)
 	{
 		clockRates[0] /= retn;
 	}
+	clockReadCount = retn;
 	return retn;
 }
-
@@ -72,6 +72,7 @@ char *removeExtra (char *tempBuff)
  **********************************************************************************************************************/
 /**
  *  \brief Draw the gauge face.
+ *  \param dialContext Drawing context to use.
  *  \param cr Cairo handle.
  *  \param face Which face to draw.
  *  \param posX Corner position X.
@@ -80,68 +81,81 @@ char *removeExtra (char *tempBuff)
  *  \result None.
  */
 gboolean
-drawFace (cairo_t *cr, int face, int posX, int posY, char circ)
+drawFace (DIAL_CONTEXT *dialContext, cairo_t *cr, int face, int posX, int posY, char circ)
 {
 	int i, maxVal, minVal, col;
 	FACE_SETTINGS *faceSetting = faceSettings[face];
+	char cacheKey[161];
 
 	/*------------------------------------------------------------------------------------------------*
-     * Draw the face, it is made up of 3 overlapping circles                                          *
+     * Everything except the hands only changes with these, so it can come from the face cache        *
      *------------------------------------------------------------------------------------------------*/
-	dialDrawStart (cr, posX, posY);
-
 	col = (weHaveFocus && face == currentFace) ? FACE3_COLOUR : FACE4_COLOUR;
-	if (circ)
+	snprintf (cacheKey, 160, "%d|%d|%X|%g|%g|%s|%s", col, circ,
+			faceSetting -> faceFlags & (FACE_SHOWHOT | FACE_SHOWCOLD | FACE_HC_REVS),
+			faceSetting -> faceScaleMin, faceSetting -> faceScaleMax,
+			faceSetting -> text[FACESTR_TOP] ? faceSetting -> text[FACESTR_TOP] : "",
+			faceSetting -> text[FACESTR_BOT] ? faceSetting -> text[FACESTR_BOT] : "");
+
+	dialCtxDrawStart (dialContext, cr, posX, posY);
+	if (dialCtxFaceCacheStart (dialContext, face, cacheKey))
 	{
-		dialCircleGradient (64, col, 1);
+		/*--------------------------------------------------------------------------------------------*
+         * Draw the face, it is made up of 3 overlapping circles                                      *
+         *--------------------------------------------------------------------------------------------*/
+		if (circ)
+		{
+			dialCtxCircleGradient (dialContext, 64, col, 1);
 /*      dialDrawCircle (64, col, -1); */
-	}
-	else
-	{
-		dialSquareGradient (64, col, 1);
+		}
+		else
+		{
+			dialCtxSquareGradient (dialContext, 64, col, 1);
 /*      dialDrawSquare (64, col, -1); */
-	}
+		}
 
-	dialCircleGradient (62, FACE2_COLOUR, 0);
-	dialCircleGradient (58, FACE1_COLOUR, 1);
+		dialCtxCircleGradient (dialContext, 62, FACE2_COLOUR, 0);
+		dialCtxCircleGradient (dialContext, 58, FACE1_COLOUR, 1);
 
 /*  dialDrawCircle (62, FACE3_COLOUR, -1); */
 /*  dialDrawCircle (60, FACE4_COLOUR, -1); */
 
-	/*------------------------------------------------------------------------------------------------*
-     * Draw the hot and cold markers                                                                  *
-     *------------------------------------------------------------------------------------------------*/
-	if (faceSetting -> faceFlags & FACE_SHOWHOT)
-	{
-		col = (faceSetting -> faceFlags & FACE_HC_REVS) ? COLD__COLOUR : HOT___COLOUR;
-		dialHotCold (54, col, 0);
-	}
-	if (faceSetting -> faceFlags & FACE_SHOWCOLD)
-	{
-		col = (faceSetting -> faceFlags & FACE_HC_REVS) ? HOT___COLOUR : COLD__COLOUR;
-		dialHotCold (54, col, 1);
-	}
+		/*--------------------------------------------------------------------------------------------*
+         * Draw the hot and cold markers                                                              *
+         *--------------------------------------------------------------------------------------------*/
+		if (faceSetting -> faceFlags & FACE_SHOWHOT)
+		{
+			col = (faceSetting -> faceFlags & FACE_HC_REVS) ? COLD__COLOUR : HOT___COLOUR;
+			dialCtxHotCold (dialContext, 54, col, 0);
+		}
+		if (faceSetting -> faceFlags & FACE_SHOWCOLD)
+		{
+			col = (faceSetting -> faceFlags & FACE_HC_REVS) ? HOT___COLOUR : COLD__COLOUR;
+			dialCtxHotCold (dialContext, 54, col, 1);
+		}
 
-	/*------------------------------------------------------------------------------------------------*
-     * Add the text, ether the date or the timezone, plus an AM/PM indicator                          *
-     *------------------------------------------------------------------------------------------------*/
-	if (faceSetting -> text[FACESTR_TOP])
-		dialDrawText (0, faceSetting -> text[FACESTR_TOP], TEXT__COLOUR);
-	if (faceSetting -> text[FACESTR_BOT])
-		dialDrawText (1, faceSetting -> text[FACESTR_BOT], TEXT__COLOUR);
+		/*--------------------------------------------------------------------------------------------*
+         * Add the text, ether the date or the timezone, plus an AM/PM indicator                      *
+         *--------------------------------------------------------------------------------------------*/
+		if (faceSetting -> text[FACESTR_TOP])
+			dialCtxDrawText (dialContext, 0, faceSetting -> text[FACESTR_TOP], TEXT__COLOUR);
+		if (faceSetting -> text[FACESTR_BOT])
+			dialCtxDrawText (dialContext, 1, faceSetting -> text[FACESTR_BOT], TEXT__COLOUR);
 
-	/*------------------------------------------------------------------------------------------------*
-     * Draw the hour markers                                                                          *
-     *------------------------------------------------------------------------------------------------*/
-	for (i = 0; i <= 10 ; ++i)
-	{
-		char tempBuff[15];
-		int markAngle = i * 90;
-		float scale = ((faceSetting -> faceScaleMax - faceSetting -> faceScaleMin) * i) / 10;
+		/*--------------------------------------------------------------------------------------------*
+         * Draw the hour markers                                                                      *
+         *--------------------------------------------------------------------------------------------*/
+		for (i = 0; i <= 10 ; ++i)
+		{
+			char tempBuff[15];
+			int markAngle = i * 90;
+			float scale = ((faceSetting -> faceScaleMax - faceSetting -> faceScaleMin) * i) / 10;
 
-		sprintf (tempBuff, "%0.3f", scale + faceSetting -> faceScaleMin);
-		dialDrawMark (markAngle, 29, QMARK_COLOUR, QMARK_COLOUR, removeExtra (tempBuff));
-		dialDrawMinute (29, 1, markAngle, HMARK_COLOUR);
+			sprintf (tempBuff, "%0.3f", scale + faceSetting -> faceScaleMin);
+			dialCtxDrawMark (dialContext, markAngle, 29, QMARK_COLOUR, QMARK_COLOUR, removeExtra (tempBuff));
+			dialCtxDrawMinute (dialContext, 29, 1, markAngle, HMARK_COLOUR);
+		}
+		dialCtxFaceCacheFinish (dialContext);
 	}
 
 	/*------------------------------------------------------------------------------------------------*
@@ -150,22 +164,42 @@ drawFace (cairo_t *cr, int face, int posX, int posY, char circ)
 	maxVal = faceSetting -> savedMaxMin.shownMaxValue;
 	minVal = faceSetting -> savedMaxMin.shownMinValue;
 	if (minVal != -1)
-		dialDrawHand (minVal, &handStyle[(faceSetting -> faceFlags & FACE_HC_REVS) ? HAND_MAX : HAND_MIN]);
+		dialCtxDrawHand (dialContext, minVal, &handStyle[(faceSetting -> faceFlags & FACE_HC_REVS) ? HAND_MAX : HAND_MIN]);
 
 	if (maxVal != -1)
-		dialDrawHand (maxVal, &handStyle[(faceSetting -> faceFlags & FACE_HC_REVS) ? HAND_MIN : HAND_MAX]);
+		dialCtxDrawHand (dialContext, maxVal, &handStyle[(faceSetting -> faceFlags & FACE_HC_REVS) ? HAND_MIN : HAND_MAX]);
 
 	if (faceSetting -> shownSecondValue != DONT_SHOW)
-		dialDrawHand (faceSetting -> shownSecondValue, &handStyle[HAND_SECOND]);
+		dialCtxDrawHand (dialContext, faceSetting -> shownSecondValue, &handStyle[HAND_SECOND]);
 
 	if (faceSetting -> shownFirstValue != DONT_SHOW)
-		dialDrawHand (faceSetting -> shownFirstValue, &handStyle[HAND_FIRST]);
+		dialCtxDrawHand (dialContext, faceSetting -> shownFirstValue, &handStyle[HAND_FIRST]);
 
-	dialDrawCircle (4, CFILL_COLOUR, CIRC__COLOUR);
-	dialDrawFinish ();
+	dialCtxDrawCircle (dialContext, 4, CFILL_COLOUR, CIRC__COLOUR);
+	dialCtxDrawFinish (dialContext);
 	return TRUE;
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D R A W  G R I D  F A C E                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw one face of the window grid, called by dialDrawFaces maybe on a worker thread.
+ *  \param dialContext Drawing context to use.
+ *  \param cr Cairo handle.
+ *  \param face Which face to draw.
+ *  \param posX Corner position X.
+ *  \param posY Corner position Y.
+ *  \result None.
+ */
+static void drawGridFace (DIAL_CONTEXT *dialContext, cairo_t *cr, int face, int posX, int posY)
+{
+	drawFace (dialContext, cr, face, posX, posY, 0);
+}
+
 #if GTK_MAJOR_VERSION == 2
 
 /**********************************************************************************************************************
@@ -184,11 +218,11 @@ void clockExpose (GtkWidget *widget)
 	int i, j, face = 0;
 	cairo_t *cr = gdk_cairo_create (dialConfig.drawingArea -> window);
 
+	dialDrawFaces (cr, drawGridFace);
 	for (j = 0; j < dialConfig.dialHeight; j++)
 	{
 		for (i = 0; i < dialConfig.dialWidth; i++)
 		{
-			drawFace (cr, face, (i * dialConfig.dialSize), (j * dialConfig.dialSize), 0);
 			if (face == currentFace)
 			{
 				if (faceSettings[face] -> text[FACESTR_WIN])
@@ -231,11 +265,11 @@ void clockExpose (cairo_t *cr)
 {
 	int i, j, face = 0;
 
+	dialDrawFaces (cr, drawGridFace);
 	for (j = 0; j < dialConfig.dialHeight; j++)
 	{
 		for (i = 0; i < dialConfig.dialWidth; i++)
 		{
-			drawFace (cr, face, (i * dialConfig.dialSize), (j * dialConfig.dialSize), 0);
 			if (face == currentFace)
 			{
 				if (faceSettings[face] -> text[FACESTR_WIN])
@@ -279,7 +313,7 @@ void dialSave(char *fileName)
 	{
 		for (i = 0; i < dialConfig.dialWidth; i++)
 		{
-			drawFace (cr, face++, (i * dialConfig.dialSize), (j * dialConfig.dialSize), 1);
+			drawFace (dialDefaultContext (), cr, face++, (i * dialConfig.dialSize), (j * dialConfig.dialSize), 1);
 		}
 	}
 
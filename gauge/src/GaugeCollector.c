@@ -0,0 +1,338 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  G A U G E  C O L L E C T O R . C                                                                                  *
+ *  ================================                                                                                  *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Run the slow data sources on worker threads so the tick never blocks.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <libxml/parser.h>
+
+#include "config.h"
+#include "GaugeDisp.h"
+
+#define COLLECTOR_MAX		16
+#define COLLECTOR_THREADS	2
+
+typedef struct _collectorSampler
+{
+	const char *name;
+	COLLECTOR_SAMPLE sampleFunc;
+	size_t snapSize;
+	gint64 period;
+	gint64 nextRun;
+	gint64 lastWanted;
+	gint running;
+	gint sequence;
+	int readSequence;
+	void *snapshot[2];
+}
+COLLECTOR_SAMPLER;
+
+static COLLECTOR_SAMPLER collectors[COLLECTOR_MAX];
+static int collectorCount = 0;
+static GThreadPool *collectorPool = NULL;
+static gint collectorSlow = 1;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  W A K E                                                                                        *
+ *  ==========================                                                                                        *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called on the main loop after a sample so the tick can show it.
+ *  \param data Not used.
+ *  \result FALSE so it only runs once.
+ */
+static gboolean collectorWake (gpointer data)
+{
+	dialTickWake ();
+	return FALSE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  W O R K E R                                                                                    *
+ *  ==============================                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called on a pool thread to take a new sample.
+ *  \param data Sampler number plus one.
+ *  \param userData Not used.
+ *  \result None.
+ */
+static void collectorWorker (gpointer data, gpointer userData)
+{
+	COLLECTOR_SAMPLER *sampler = &collectors[GPOINTER_TO_INT (data) - 1];
+	int sequence = g_atomic_int_get (&sampler -> sequence);
+	void *backBuffer = sampler -> snapshot[(sequence + 1) & 1];
+
+	/*------------------------------------------------------------------------------------------------*
+     * Only this thread writes, so the front buffer is stable while we copy it to the back buffer.    *
+     * Samplers that only fill in some fields keep the rest of the last reading.                      *
+     *------------------------------------------------------------------------------------------------*/
+	memcpy (backBuffer, sampler -> snapshot[sequence & 1], sampler -> snapSize);
+	sampler -> sampleFunc (backBuffer);
+
+	sampler -> nextRun = g_get_monotonic_time () + sampler -> period * g_atomic_int_get (&collectorSlow);
+	g_atomic_int_inc (&sampler -> sequence);
+	g_atomic_int_set (&sampler -> running, 0);
+	g_idle_add (collectorWake, NULL);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  I N I T                                                                                        *
+ *  ==========================                                                                                        *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Create the worker pool, called once before any sampler is registered.
+ *  \result None.
+ */
+void collectorInit (void)
+{
+	if (collectorPool == NULL)
+	{
+#if !GLIB_CHECK_VERSION(2,32,0)
+		if (!g_thread_supported ())
+			g_thread_init (NULL);
+#endif
+		/*--------------------------------------------------------------------------------------------*
+         * libxml must be set up on the main thread before the workers use it.                        *
+         *--------------------------------------------------------------------------------------------*/
+		xmlInitParser ();
+		collectorPool = g_thread_pool_new (collectorWorker, NULL, COLLECTOR_THREADS, FALSE, NULL);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  R E G I S T E R                                                                                *
+ *  ==================================                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Add a data source to be sampled on the worker pool.
+ *  \param name Name of the source, for debugging.
+ *  \param sampleFunc Function that fills in a snapshot, called on a worker thread.
+ *  \param snapSize Size of the snapshot the sampler fills in.
+ *  \param period Milli-seconds between samples.
+ *  \result Sampler number or -1 on error.
+ */
+int collectorRegister (const char *name, COLLECTOR_SAMPLE sampleFunc, size_t snapSize, int period)
+{
+	COLLECTOR_SAMPLER *sampler;
+
+	if (collectorCount == COLLECTOR_MAX)
+		return -1;
+
+	sampler = &collectors[collectorCount];
+	sampler -> snapshot[0] = calloc (1, snapSize);
+	sampler -> snapshot[1] = calloc (1, snapSize);
+	if (sampler -> snapshot[0] == NULL || sampler -> snapshot[1] == NULL)
+	{
+		free (sampler -> snapshot[0]);
+		free (sampler -> snapshot[1]);
+		sampler -> snapshot[0] = sampler -> snapshot[1] = NULL;
+		return -1;
+	}
+	sampler -> name = name;
+	sampler -> sampleFunc = sampleFunc;
+	sampler -> snapSize = snapSize;
+	sampler -> period = (gint64)period * 1000;
+	sampler -> nextRun = 0;
+	sampler -> lastWanted = 0;
+	sampler -> running = 0;
+	sampler -> sequence = 0;
+	sampler -> readSequence = 0;
+	return collectorCount++;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  R E A D                                                                                        *
+ *  ==========================                                                                                        *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Copy the latest published snapshot, called on the tick.
+ *  \param id Sampler number from collectorRegister.
+ *  \param snapshot Where to copy the sample, only written when there is a new one.
+ *  \result Update number of the sample now in snapshot, -1 on error.
+ */
+int collectorRead (int id, void *snapshot)
+{
+	COLLECTOR_SAMPLER *sampler;
+	int before, after;
+
+	if (id < 0 || id >= collectorCount)
+		return -1;
+
+	sampler = &collectors[id];
+	sampler -> lastWanted = g_get_monotonic_time ();
+
+	/*------------------------------------------------------------------------------------------------*
+     * The worker writes the buffer not shown by the sequence then bumps it. If it moved while we     *
+     * were copying the worker may have started on our buffer, so copy again.                         *
+     *------------------------------------------------------------------------------------------------*/
+	before = g_atomic_int_get (&sampler -> sequence);
+	while (before != sampler -> readSequence)
+	{
+		memcpy (snapshot, sampler -> snapshot[before & 1], sampler -> snapSize);
+		after = g_atomic_int_get (&sampler -> sequence);
+		if (after == before)
+		{
+			sampler -> readSequence = before;
+			break;
+		}
+		before = after;
+	}
+	return sampler -> readSequence & 0x7FFF;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  S C H E D U L E                                                                                *
+ *  ==================================                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Queue any samplers that are due, called at the end of each tick.
+ *  \result None.
+ */
+void collectorSchedule (void)
+{
+	gint64 now = g_get_monotonic_time ();
+	int i;
+
+	for (i = 0; i < collectorCount; ++i)
+	{
+		COLLECTOR_SAMPLER *sampler = &collectors[i];
+
+		/*--------------------------------------------------------------------------------------------*
+         * Only sample sources that a face has asked for recently.                                    *
+         *--------------------------------------------------------------------------------------------*/
+		if (sampler -> lastWanted == 0 || now - sampler -> lastWanted > sampler -> period * collectorSlow * 2)
+			continue;
+		if (g_atomic_int_get (&sampler -> running) || now < sampler -> nextRun)
+			continue;
+
+		g_atomic_int_set (&sampler -> running, 1);
+		if (collectorPool == NULL || !g_thread_pool_push (collectorPool, GINT_TO_POINTER (i + 1), NULL))
+		{
+			collectorWorker (GINT_TO_POINTER (i + 1), NULL);
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  S L O W  D O W N                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Sample less often, such as while the window can not be seen, called on the tick.
+ *  \param slow How many times longer to wait between samples, 1 for the normal rate.
+ *  \result None.
+ */
+void collectorSlowDown (int slow)
+{
+	gint64 now = g_get_monotonic_time ();
+	int i;
+
+	if (slow < 1)
+		slow = 1;
+	if (slow == g_atomic_int_get (&collectorSlow))
+		return;
+
+	g_atomic_int_set (&collectorSlow, slow);
+	for (i = 0; i < collectorCount; ++i)
+	{
+		COLLECTOR_SAMPLER *sampler = &collectors[i];
+
+		/*--------------------------------------------------------------------------------------------*
+         * Samples put off at the slow rate are due now if they would be late at the new one.         *
+         *--------------------------------------------------------------------------------------------*/
+		if (!g_atomic_int_get (&sampler -> running) && sampler -> nextRun > now + sampler -> period * slow)
+			sampler -> nextRun = now;
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  N E X T  R U N                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find when the next wanted sampler is due, so the tick can sleep until then.
+ *  \result Monotonic time of the next sample, G_MAXINT64 if nothing is wanted.
+ */
+gint64 collectorNextRun (void)
+{
+	gint64 now = g_get_monotonic_time (), nextRun = G_MAXINT64;
+	int i;
+
+	for (i = 0; i < collectorCount; ++i)
+	{
+		COLLECTOR_SAMPLER *sampler = &collectors[i];
+
+		if (sampler -> lastWanted == 0 || now - sampler -> lastWanted > sampler -> period * collectorSlow * 2)
+			continue;
+		if (g_atomic_int_get (&sampler -> running))
+			continue;
+		if (sampler -> nextRun < nextRun)
+			nextRun = sampler -> nextRun;
+	}
+	return nextRun;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O L L E C T O R  F R E E                                                                                        *
+ *  ==========================                                                                                        *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Wait for running samplers and free everything, called on exit.
+ *  \result None.
+ */
+void collectorFree (void)
+{
+	int i;
+
+	if (collectorPool != NULL)
+	{
+		g_thread_pool_free (collectorPool, TRUE, TRUE);
+		collectorPool = NULL;
+	}
+	for (i = 0; i < collectorCount; ++i)
+	{
+		free (collectors[i].snapshot[0]);
+		free (collectors[i].snapshot[1]);
+		collectors[i].snapshot[0] = collectors[i].snapshot[1] = NULL;
+	}
+	collectorCount = 0;
+}
+
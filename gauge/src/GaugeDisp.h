@@ -109,6 +109,8 @@
 #define MENU_GAUGE_WEATHER		11
 #define MENU_GAUGE_WIFI			12
 
+#define MENU_CPU_PICK			10
+
 #define MENU_PREF_ONTOP			0
 #define MENU_PREF_STUCK			1
 #define MENU_PREF_LOCK			2
@@ -194,6 +196,17 @@ typedef struct _gaugeEnabled
 }
 GAUGE_ENABLED;
 
+typedef void (*COLLECTOR_SAMPLE) (void *snapshot);
+typedef void (*HTTP_DONE) (void *data, char *buffer, size_t size);
+typedef int (*HTTP_WRITE) (void *data, char *buffer, size_t size);
+
+typedef struct _rateTimer
+{
+	gint64 lastRead;
+	double seconds;
+}
+RATE_TIMER;
+
 #define LOCATION_COUNT			6
 
 /*----------------------------------------------------------------------------------------------------*
@@ -248,29 +261,53 @@ void setFaceString (FACE_SETTINGS *faceSetting, int str, int shorten, char *form
 
 void readCPUInit (void);
 void readCPUValues (int face);
+int cpuTickPeriod (FACE_SETTINGS *faceSetting);
 void readMemoryInit (void);
 void readMemoryValues (int face);
+int memoryTickPeriod (FACE_SETTINGS *faceSetting);
 void readNetworkInit (void);
 void readNetworkValues (int face);
+int networkTickPeriod (FACE_SETTINGS *faceSetting);
 void readHarddiskInit (void);
 void readHarddiskValues (int face);
+int harddiskTickPeriod (FACE_SETTINGS *faceSetting);
 void readBatteryInit (void);
 void readBatteryValues (int face);
+int batteryTickPeriod (FACE_SETTINGS *faceSetting);
 void readMoonPhaseInit (void);
 void readMoonPhaseValues (int face);
+int moonPhaseTickPeriod (FACE_SETTINGS *faceSetting);
 void readWifiInit (void);
 void readWifiValues (int face);
 void readEntropyInit (void);
 void readEntropyValues (int face);
+int entropyTickPeriod (FACE_SETTINGS *faceSetting);
 void readTideInit (void);
 void readTideValues (int face);
+int tideTickPeriod (FACE_SETTINGS *faceSetting);
 void readSensorInit (void);
 void readSensorValues (int face);
+int sensorTickPeriod (FACE_SETTINGS *faceSetting);
 void readWeatherInit (void);
 void readWeatherValues (int face);
+int weatherTickPeriod (FACE_SETTINGS *faceSetting);
 void readThermometerInit (void);
 void readThermometerValues (int face);
 void readPowerMeterInit (void);
 void readPowerMeterValues (int face);
 void weatherGetMaxMin (FACE_SETTINGS *faceSetting);
 
+void collectorInit (void);
+int collectorRegister (const char *name, COLLECTOR_SAMPLE sampleFunc, size_t snapSize, int period);
+int collectorRead (int id, void *snapshot);
+void collectorSchedule (void);
+gint64 collectorNextRun (void);
+void collectorSlowDown (int slow);
+void collectorFree (void);
+int httpFetch (char *url, int gzip, HTTP_DONE doneFunc, void *data);
+int httpStream (char *url, int gzip, HTTP_WRITE writeFunc, HTTP_DONE doneFunc, void *data);
+void httpFree (void);
+double rateTimerRead (RATE_TIMER *timer);
+unsigned long long rateCounterDiff (unsigned long long oldValue, unsigned long long newValue);
+float rateSmooth (float oldRate, double newRate, double seconds);
+
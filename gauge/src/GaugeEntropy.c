@@ -26,6 +26,8 @@
 
 #include "GaugeDisp.h"
 
+#define ENTROPY_TICKS 5
+
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
@@ -56,6 +58,22 @@ void readEntropyInit (void)
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  E N T R O P Y  T I C K  P E R I O D                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often an entropy face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int entropyTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return ENTROPY_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  E N T R O P Y  V A L U E S                                                                               *
@@ -77,7 +95,7 @@ void readEntropyValues (int face)
 		{
 			;
 		}
-		else if (sysUpdateID % 5 != 0)
+		else if (sysUpdateID % entropyTickPeriod (faceSetting) != 0)
 		{
 			return;
 		}
@@ -22,13 +22,51 @@
  */
 #include <stdio.h>
 #include <string.h>
+#include <fcntl.h>
+#include <sys/stat.h>
 #include <sys/statvfs.h>
 
 #include "GaugeDisp.h"
 
 #define MAX_PARTITIONS	10
-#define MAX_DISKS		10
+#define MAX_DISKS		15
 #define MAX_SCALE_MEM	20
+#define STATS_BUFF_SIZE	8192
+#define HARDDISK_TICKS	10
+#define PARTITION_TICKS	50
+
+/*----------------------------------------------------------------------------------------------------*
+ * The fields after the name in /proc/diskstats that are used                                         *
+ *----------------------------------------------------------------------------------------------------*/
+#define STAT_READS		0
+#define STAT_SECT_READ	2
+#define STAT_READ_TIME	3
+#define STAT_WRITES		4
+#define STAT_SECT_WRITE	6
+#define STAT_WRITE_TIME	7
+#define STAT_IN_FLIGHT	8
+#define STAT_IO_TIME	9
+#define STAT_WEIGHTED	10
+#define STAT_FIELDS		11
+
+/*----------------------------------------------------------------------------------------------------*
+ * What is shown, the face sub-type is (value + 1) << 8                                               *
+ *----------------------------------------------------------------------------------------------------*/
+#define DISK_SECT_READ	0
+#define DISK_SECT_WRITE	1
+#define DISK_READS		2
+#define DISK_WRITES		3
+#define DISK_IN_FLIGHT	4
+#define DISK_BUSY		5
+#define DISK_READ_WAIT	6
+#define DISK_WRITE_WAIT	7
+#define DISK_QUEUE		8
+#define DISK_VALUES		9
+
+#define DISK_WHOLE		0
+#define DISK_PART		1
+#define DISK_STACKED	2
+#define DISK_IGNORE		3
 
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
@@ -36,11 +74,13 @@ extern MENU_DESC gaugeMenuDesc[];
 extern MENU_DESC spaceMenuDesc[];
 extern MENU_DESC diskMenuDesc[];
 extern int sysUpdateID;
+extern bool diskPartitions;
 
 struct diskValues
 {
 	float rate;
 	unsigned long long value;
+	unsigned long long count;
 	int useScale;
 	int oldScales[MAX_SCALE_MEM];
 };
@@ -48,24 +88,60 @@ struct diskValues
 typedef struct _diskInfo
 {
 	char name[41];
-	struct diskValues secRead;
-	struct diskValues secWrite;
+	struct diskValues values[DISK_VALUES];
+	int diskKind;
+	int menuSlot;
+	int seenID;
 }
 DISK_INFO;
 
+typedef struct _diskValueInfo
+{
+	char *typeName;
+	char *longName;
+	char *units;
+	int statField;
+	int countValue;
+}
+DISK_VALUE_INFO;
+
 static int myUpdateID = 100;
-static long lastTime;
+static RATE_TIMER activityTimer;
 static char diskNames[MAX_PARTITIONS][81];
 static char tidyNames[MAX_PARTITIONS][41];
 static char *diskTypes[] = { "ext2","ext3","ext4","btrfs","xfs","cifs","nfs","usbfs","vfat","fuseblk",NULL };
 static char *diskInfo = "/proc/mounts"; /* /etc/fstab */
 static char *diskStats = "/proc/diskstats";
-static char *typeNames[] = { "Reads", "Writes" };
-DISK_INFO diskActivity[MAX_DISKS + 1] =
+static char *diskClass = "/sys/class/block";
+static DISK_INFO allDisks = { __("All") };
+static DISK_INFO noDisk;
+static int wholeDisks = 0;
+
+static DISK_VALUE_INFO diskValueInfo[DISK_VALUES] =
 {
-	{ __("All") }
+	{	__("Reads"),		__("Sector Reads"),		"/sec",		STAT_SECT_READ,		-1				},
+	{	__("Writes"),		__("Sector Writes"),	"/sec",		STAT_SECT_WRITE,	-1				},
+	{	__("Read Ops"),		__("Read Operations"),	"/sec",		STAT_READS,			-1				},
+	{	__("Write Ops"),	__("Write Operations"),	"/sec",		STAT_WRITES,		-1				},
+	{	__("In Flight"),	__("In Flight"),		"",			STAT_IN_FLIGHT,		-1				},
+	{	__("Busy"),			__("Busy Time"),		"%",		STAT_IO_TIME,		-1				},
+	{	__("Read Wait"),	__("Read Latency"),		"ms",		STAT_READ_TIME,		DISK_READS		},
+	{	__("Write Wait"),	__("Write Latency"),	"ms",		STAT_WRITE_TIME,	DISK_WRITES		},
+	{	__("Queue"),		__("Queue Depth"),		"",			STAT_WEIGHTED,		-1				}
 };
 
+/*----------------------------------------------------------------------------------------------------*
+ * Every device in /proc/diskstats is kept in the table by name. Whole disks and dm or md devices get *
+ * a slot in the menu, partitions only if disk_partitions is set. The file is read with pread.        *
+ *----------------------------------------------------------------------------------------------------*/
+static GHashTable *diskTable = NULL;
+static DISK_INFO *diskActivity[MAX_DISKS + 1] = { &allDisks };
+static int diskSlots = 1;
+static int diskSeenID = 0;
+static int diskStatsFile = -1;
+static char *statsBuffer = NULL;
+static size_t statsBuffSize = 0;
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  T I D Y  P A R T I T I O N  N A M E                                                                               *
@@ -237,6 +313,195 @@ void setActivityScale (struct diskValues *values)
 	values -> oldScales[i] = scale;
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I S K  C L A S S I F Y                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Work out what sort of device this is, only called the first time it is seen.
+ *  \param name Name of the device.
+ *  \result DISK_WHOLE, DISK_PART, DISK_STACKED or DISK_IGNORE.
+ */
+static int diskClassify (const char *name)
+{
+	char path[81], parent[41];
+	struct stat statBuf;
+	int i;
+
+	if (strncmp (name, "ram", 3) == 0 || strncmp (name, "loop", 4) == 0 || strncmp (name, "zram", 4) == 0)
+		return DISK_IGNORE;
+
+	snprintf (path, 80, "%s/%s/partition", diskClass, name);
+	if (stat (path, &statBuf) == 0)
+		return DISK_PART;
+	if (strncmp (name, "dm-", 3) == 0 || (strncmp (name, "md", 2) == 0 && isdigit (name[2])))
+		return DISK_STACKED;
+
+	snprintf (path, 80, "%s/%s", diskClass, name);
+	if (stat (path, &statBuf) == 0)
+		return DISK_WHOLE;
+
+	/*------------------------------------------------------------------------------------------------*
+     * No sysfs, so it is a partition if the name without the number, and any "p" before it as in     *
+     * nvme0n1p1, is a disk we have already seen                                                      *
+     *------------------------------------------------------------------------------------------------*/
+	strncpy (parent, name, 40);
+	parent[40] = 0;
+	i = strlen (parent);
+	while (i > 0 && isdigit (parent[i - 1]))
+		parent[--i] = 0;
+	if (i == (int)strlen (name))
+		return DISK_WHOLE;
+	if (g_hash_table_lookup (diskTable, parent) != NULL)
+		return DISK_PART;
+	if (i > 1 && parent[i - 1] == 'p' && isdigit (parent[i - 2]))
+	{
+		parent[i - 1] = 0;
+		if (g_hash_table_lookup (diskTable, parent) != NULL)
+			return DISK_PART;
+	}
+	return DISK_WHOLE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I S K  A D D                                                                                                    *
+ *  ==============                                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Add a device the first time it is seen.
+ *  \param name Name of the device.
+ *  \result Pointer to the new device, NULL if out of memory.
+ */
+static DISK_INFO *diskAdd (const char *name)
+{
+	DISK_INFO *diskInfo;
+
+	if ((diskInfo = calloc (1, sizeof (DISK_INFO))) == NULL)
+		return NULL;
+
+	strncpy (diskInfo -> name, name, 40);
+	diskInfo -> seenID = -1;
+	diskInfo -> diskKind = diskClassify (name);
+	if (diskInfo -> diskKind == DISK_IGNORE || (diskInfo -> diskKind == DISK_PART && !diskPartitions))
+		;
+	else if (diskSlots < MAX_DISKS + 1)
+	{
+		diskInfo -> menuSlot = diskSlots;
+		diskActivity[diskSlots++] = diskInfo;
+		diskMenuDesc[diskInfo -> menuSlot].disable = 0;
+		diskMenuDesc[diskInfo -> menuSlot].menuName = diskInfo -> name;
+	}
+	g_hash_table_insert (diskTable, diskInfo -> name, diskInfo);
+	return diskInfo;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I S K  G O N E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Drop devices not seen on the last read, devices on the menu are kept but show nothing.
+ *  \param key Name of the device.
+ *  \param value Device information.
+ *  \param userData Not used.
+ *  \result TRUE if the device should be removed.
+ */
+static gboolean diskGone (gpointer key, gpointer value, gpointer userData)
+{
+	DISK_INFO *diskInfo = (DISK_INFO *)value;
+	int i;
+
+	if (diskInfo -> seenID == diskSeenID)
+		return FALSE;
+	if (diskInfo -> menuSlot)
+	{
+		for (i = 0; i < DISK_VALUES; ++i)
+			diskInfo -> values[i].rate = 0;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I S K  S A M P L E                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Save the counters read for one device and work out its rates.
+ *  \param diskInfo Device to update.
+ *  \param stats Fields after the name in /proc/diskstats.
+ *  \param seconds Seconds since the last read, 0 if the device was not there last time.
+ *  \result None.
+ */
+static void diskSample (DISK_INFO *diskInfo, unsigned long long stats[], double seconds)
+{
+	unsigned long long diff, count;
+	struct diskValues *values;
+	DISK_VALUE_INFO *valueInfo;
+	double newRate;
+	int i;
+
+	for (i = 0; i < DISK_VALUES; ++i)
+	{
+		values = &diskInfo -> values[i];
+		valueInfo = &diskValueInfo[i];
+		if (i == DISK_IN_FLIGHT)
+		{
+			values -> rate = (float)stats[STAT_IN_FLIGHT];
+		}
+		else if (seconds > 0)
+		{
+			diff = rateCounterDiff (values -> value, stats[valueInfo -> statField]);
+			switch (i)
+			{
+			case DISK_BUSY:
+				newRate = (double)diff / (seconds * 10);
+				break;
+			case DISK_QUEUE:
+				newRate = (double)diff / (seconds * 1000);
+				break;
+			case DISK_READ_WAIT:
+			case DISK_WRITE_WAIT:
+				/*---------------------------------------------------------------------------------------*
+                 * Time spent on the requests finished since last time, over how many there were      *
+                 *------------------------------------------------------------------------------------*/
+				count = rateCounterDiff (values -> count, stats[diskValueInfo[valueInfo -> countValue].statField]);
+				newRate = count ? (double)diff / count : 0;
+				break;
+			default:
+				newRate = (double)diff / seconds;
+				break;
+			}
+			values -> rate = rateSmooth (values -> rate, newRate, seconds);
+		}
+		values -> value = stats[valueInfo -> statField];
+		if (valueInfo -> countValue != -1)
+			values -> count = stats[diskValueInfo[valueInfo -> countValue].statField];
+
+		/*--------------------------------------------------------------------------------------------*
+         * Partitions and stacked devices are part of a whole disk, so only add in the whole disks,   *
+         * the waits are weighted by how many requests there were so they can be averaged after       *
+         *--------------------------------------------------------------------------------------------*/
+		if (diskInfo -> diskKind == DISK_WHOLE)
+		{
+			if (valueInfo -> countValue != -1)
+				allDisks.values[i].rate += values -> rate * diskInfo -> values[valueInfo -> countValue].rate;
+			else
+				allDisks.values[i].rate += values -> rate;
+		}
+		if (diskInfo -> menuSlot)
+			setActivityScale (values);
+	}
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  A C T I V I T Y  V A L U E S                                                                             *
@@ -244,118 +509,115 @@ void setActivityScale (struct diskValues *values)
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Read the number of sectors read.
+ *  \brief Read /proc/diskstats once per update, the whole file is read however long the lines are.
  *  \result None.
  */
 void readActivityValues()
 {
-	FILE *diskstats;
-	struct timeval tvTaken;
-	char readBuff[256], readWord[256];
-	long thisTime = 0, readTime;
-	int disk = 1;
+	double seconds = rateTimerRead (&activityTimer);
+	unsigned long long stats[STAT_FIELDS];
+	char *readPtr, *namePtr, *endPtr, *newBuffer;
+	DISK_INFO *diskInfo;
+	ssize_t readSize;
+	int i, seen = 0;
 
-	gettimeofday (&tvTaken, NULL);
-	thisTime = ((tvTaken.tv_sec % 100000) * 1000) + (tvTaken.tv_usec / 1000);
-	readTime = thisTime - lastTime;
-	lastTime = thisTime;
-	if (!readTime) return;
+	if (diskTable == NULL)
+	{
+		diskTable = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, free);
+	}
+	if (statsBuffer == NULL)
+	{
+		if ((statsBuffer = malloc (STATS_BUFF_SIZE)) == NULL)
+			return;
+		statsBuffSize = STATS_BUFF_SIZE;
+	}
+	if (diskStatsFile == -1)
+	{
+		if ((diskStatsFile = open (diskStats, O_RDONLY)) == -1)
+			return;
+	}
+	while ((readSize = pread (diskStatsFile, statsBuffer, statsBuffSize - 1, 0)) == (ssize_t)statsBuffSize - 1)
+	{
+		if ((newBuffer = realloc (statsBuffer, statsBuffSize * 2)) == NULL)
+			break;
+		statsBuffer = newBuffer;
+		statsBuffSize *= 2;
+	}
+	if (readSize < 0)
+	{
+		close (diskStatsFile);
+		diskStatsFile = -1;
+		return;
+	}
+	statsBuffer[readSize] = 0;
 
-	diskActivity[0].secRead.value = diskActivity[0].secRead.rate = 0;
-	diskActivity[0].secWrite.value = diskActivity[0].secWrite.rate = 0;
+	for (i = 0; i < DISK_VALUES; ++i)
+		allDisks.values[i].rate = 0;
+	wholeDisks = 0;
+	++diskSeenID;
 
-	if ((diskstats = fopen (diskStats, "r")) != NULL)
+	/*------------------------------------------------------------------------------------------------*
+     * Each line is "major minor name" then the counters, newer kernels add more at the end           *
+     *------------------------------------------------------------------------------------------------*/
+	readPtr = statsBuffer;
+	while (*readPtr)
 	{
-		while (fgets (readBuff, 255, diskstats) && disk < (MAX_DISKS + 1))
+		strtoul (readPtr, &endPtr, 10);
+		strtoul (endPtr, &endPtr, 10);
+		while (*endPtr == ' ')
+			++endPtr;
+		namePtr = endPtr;
+		while (*endPtr > ' ')
+			++endPtr;
+		if (*endPtr != ' ')
+			break;
+		*endPtr++ = 0;
+
+		for (i = 0; i < STAT_FIELDS; ++i)
+			stats[i] = strtoull (endPtr, &endPtr, 10);
+		if ((readPtr = strchr (endPtr, '\n')) == NULL)
+			readPtr = endPtr + strlen (endPtr);
+		else
+			++readPtr;
+
+		if ((diskInfo = g_hash_table_lookup (diskTable, namePtr)) == NULL)
 		{
-			int i = 0, j = 0, w = 0;
-			while (readBuff[i])
-			{
-				if (readBuff[0] == '#' && w == 0)
-					break;
-				if (readBuff[i] > ' ')
-				{
-					if (j == 0)
-					{
-						if (++w == 11)
-							break;
-					}
-					readWord[j] = readBuff[i];
-					readWord[++j] = 0;
-				}
-				else if (j)
-				{
-					if (w == 3)
-					{
-						int k, f = 0;
-						if (strncmp (readWord, "ram", 3) == 0 || strncmp (readWord, "loop", 4) == 0)
-						{
-							/* Ignore ram and loop diska */
-							break;
-						}
-						for (k = 1; k < disk; ++k)
-						{
-							if (strncmp (diskActivity[k].name, readWord, strlen (diskActivity[k].name)) == 0)
-							{
-								f = 1;
-								break;
-							}
-						}
-						if (f)
-						{
-							break;
-						}
-						else
-						{
-							strncpy (diskActivity[disk].name, readWord, 40);
-						}
-					}
-					if (w == 6)
-					{
-						unsigned long long diff;
-						unsigned long long value = atoll (readWord);
-						if (value < diskActivity[disk].secRead.value)
-						{
-							diskActivity[disk].secRead.value = value;
-							break;
-						}
-						diff = value - diskActivity[disk].secRead.value;
-						diskActivity[disk].secRead.rate = (diff * 1000) / readTime;
-						diskActivity[disk].secRead.value = value;
-						diskActivity[0].secRead.value += diff;
-					}
-					if (w == 10)
-					{
-						unsigned long long diff;
-						unsigned long long value = atoll (readWord);
-						if (value < diskActivity[disk].secWrite.value)
-						{
-							diskActivity[disk].secWrite.value = value;
-							break;
-						}
-						diff = value - diskActivity[disk].secWrite.value;
-						diskActivity[disk].secWrite.rate = (diff * 1000) / readTime;
-						diskActivity[disk].secWrite.value = value;
-						diskActivity[0].secWrite.value += diff;
+			if ((diskInfo = diskAdd (namePtr)) == NULL)
+				continue;
+		}
+		++seen;
+		if (diskInfo -> diskKind != DISK_IGNORE)
+		{
+			diskSample (diskInfo, stats, diskInfo -> seenID == diskSeenID - 1 ? seconds : 0);
+			if (diskInfo -> diskKind == DISK_WHOLE)
+				++wholeDisks;
+		}
+		diskInfo -> seenID = diskSeenID;
+	}
+	if (seen != (int)g_hash_table_size (diskTable))
+	{
+		g_hash_table_foreach_remove (diskTable, diskGone, NULL);
+	}
 
-						setActivityScale (&diskActivity[disk].secRead);
-						setActivityScale (&diskActivity[disk].secWrite);
+	/*------------------------------------------------------------------------------------------------*
+     * Show how busy the disks are on average, not added together, and the average wait per request   *
+     *------------------------------------------------------------------------------------------------*/
+	if (wholeDisks)
+		allDisks.values[DISK_BUSY].rate /= wholeDisks;
+	for (i = 0; i < DISK_VALUES; ++i)
+	{
+		int countValue = diskValueInfo[i].countValue;
 
-						diskMenuDesc[disk].disable = 0;
-						diskMenuDesc[disk].menuName = diskActivity[disk].name;
-						++disk;
-					}
-					j = 0;
-				}
-				++i;
-			}
+		if (countValue != -1)
+		{
+			if (allDisks.values[countValue].rate > 0)
+				allDisks.values[i].rate /= allDisks.values[countValue].rate;
+			else
+				allDisks.values[i].rate = 0;
 		}
-		fclose (diskstats);
 	}
-	diskActivity[0].secRead.rate = (diskActivity[0].secRead.value * 1000) / readTime;
-	diskActivity[0].secWrite.rate = (diskActivity[0].secWrite.value * 1000) / readTime;
-	setActivityScale (&diskActivity[0].secRead);
-	setActivityScale (&diskActivity[0].secWrite);
+	for (i = 0; i < DISK_VALUES; ++i)
+		setActivityScale (&allDisks.values[i]);
 }
 
 /**********************************************************************************************************************
@@ -410,6 +672,22 @@ char *sizeToString (unsigned long long partSize, char *sizeStr)
 	return sizeStr;
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H A R D D I S K  T I C K  P E R I O D                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a disk activity or partition face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int harddiskTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return faceSetting -> faceSubType & 0x0F00 ? HARDDISK_TICKS : PARTITION_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  H A R D D I S K  V A L U E S                                                                             *
@@ -431,7 +709,7 @@ void readHarddiskValues (int face)
 		{
 			;
 		}
-		else if (sysUpdateID % (faceSetting -> faceSubType & 0x0300 ? 10 : 50) != 0)
+		else if (sysUpdateID % harddiskTickPeriod (faceSetting) != 0)
 		{
 			return;
 		}
@@ -440,33 +718,34 @@ void readHarddiskValues (int face)
 			readActivityValues();
 			myUpdateID = sysUpdateID;
 		}
-		if (faceSetting -> faceSubType & 0x0300)
+		if (faceSetting -> faceSubType & 0x0F00)
 		{
 			int scale, disk = faceSetting -> faceSubType & 0x00FF;
+			int type = ((faceSetting -> faceSubType >> 8) & 0x0F) - 1;
+			DISK_INFO *diskInfo = disk < diskSlots ? diskActivity[disk] : &noDisk;
+			DISK_VALUE_INFO *valueInfo;
 			unsigned long value = 0;
-			char *nameT, *nameD;
+			char *nameD;
+
+			if (type >= DISK_VALUES)
+				type = DISK_SECT_READ;
+			valueInfo = &diskValueInfo[type];
+			nameD = diskInfo -> name;
+			scale = diskInfo -> values[type].useScale;
+			faceSetting -> firstValue = value = diskInfo -> values[type].rate;
+			if (scale < 1)
+				scale = 1;
 
-			nameD = diskActivity[disk].name;
-			if (faceSetting -> faceSubType & 0x0100)
-			{
-				nameT = typeNames[0];
-				scale = diskActivity[disk].secRead.useScale;
-				faceSetting -> firstValue = value = diskActivity[disk].secRead.rate;
-			}
-			else
-			{
-				nameT = typeNames[1];
-				scale = diskActivity[disk].secWrite.useScale;
-				faceSetting -> firstValue = value = diskActivity[disk].secWrite.rate;
-			}
 			faceSetting -> firstValue /= scale;
-			setFaceString (faceSetting, FACESTR_TOP, 0, _("%s\n(%s)"), gettext (nameT), nameD);
-			setFaceString (faceSetting, FACESTR_TIP, 0, _("<b>Sector %s</b>: %lu/sec (%s)"), gettext (nameT), value, nameD);
+			setFaceString (faceSetting, FACESTR_TOP, 0, _("%s\n(%s)"), gettext (valueInfo -> typeName), nameD);
+			setFaceString (faceSetting, FACESTR_TIP, 0, _("<b>%s</b>: %lu%s (%s)"), gettext (valueInfo -> longName), value,
+					valueInfo -> units, nameD);
 			if (scale > 1)
-				setFaceString (faceSetting, FACESTR_BOT, 0, _("%0.1f/sec\nx%d"), faceSetting -> firstValue, scale);
+				setFaceString (faceSetting, FACESTR_BOT, 0, _("%0.1f%s\nx%d"), faceSetting -> firstValue,
+						valueInfo -> units, scale);
 			else
-				setFaceString (faceSetting, FACESTR_BOT, 0, _("%0.1f/sec"), faceSetting -> firstValue);
-			setFaceString (faceSetting, FACESTR_WIN, 0, _("Sector %s - Gauge"), nameT);
+				setFaceString (faceSetting, FACESTR_BOT, 0, _("%0.1f%s"), faceSetting -> firstValue, valueInfo -> units);
+			setFaceString (faceSetting, FACESTR_WIN, 0, _("%s - Gauge"), gettext (valueInfo -> longName));
 
 			if (faceSetting -> updateNum != scale)
 			{
@@ -0,0 +1,456 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  G A U G E  H T T P . C                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Fetch web pages without blocking, driven from the GLib main loop.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <stdlib.h>
+#include <curl/curl.h>
+
+#include "config.h"
+#include "GaugeDisp.h"
+
+typedef struct _httpRequest
+{
+	struct _httpRequest *next;
+	CURL *curlHandle;
+	HTTP_WRITE writeFunc;
+	HTTP_DONE doneFunc;
+	void *data;
+	char *memory;
+	size_t size;
+	size_t allocated;
+}
+HTTP_REQUEST;
+
+static CURLM *multiHandle = NULL;
+static CURLSH *shareHandle = NULL;
+static HTTP_REQUEST *httpRequests = NULL;
+static guint timerSource = 0;
+static int runningHandles = 0;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  W R I T E  C A L L B A C K                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by curl to save the data read.
+ *  \param ptr Data to save.
+ *  \param size Size of the data parts.
+ *  \param nmemb Number of data parts.
+ *  \param data The request being read.
+ *  \result Amount we saved, anything else stops the transfer.
+ */
+static size_t httpWriteCallback (void *ptr, size_t size, size_t nmemb, void *data)
+{
+	HTTP_REQUEST *request = (HTTP_REQUEST *)data;
+	size_t realSize = size * nmemb;
+
+	if (request -> writeFunc != NULL)
+	{
+		if (!request -> writeFunc (request -> data, (char *)ptr, realSize))
+			return 0;
+		request -> size += realSize;
+		return realSize;
+	}
+	if (request -> size + realSize + 1 > request -> allocated)
+	{
+		size_t newSize = request -> allocated ? request -> allocated : 4096;
+		char *newMemory;
+
+		while (request -> size + realSize + 1 > newSize)
+			newSize *= 2;
+		if ((newMemory = realloc (request -> memory, newSize)) == NULL)
+			return 0;
+		request -> memory = newMemory;
+		request -> allocated = newSize;
+	}
+	memcpy (&request -> memory[request -> size], ptr, realSize);
+	request -> size += realSize;
+	request -> memory[request -> size] = 0;
+	return realSize;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  C H E C K  D O N E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Pass any finished transfers to their owners.
+ *  \result None.
+ */
+static void httpCheckDone (void)
+{
+	CURLMsg *message;
+	int pending;
+
+	while ((message = curl_multi_info_read (multiHandle, &pending)) != NULL)
+	{
+		if (message -> msg == CURLMSG_DONE)
+		{
+			CURL *curlHandle = message -> easy_handle;
+			CURLcode result = message -> data.result;
+			HTTP_REQUEST *request = NULL;
+
+			curl_easy_getinfo (curlHandle, CURLINFO_PRIVATE, (char **)&request);
+			curl_multi_remove_handle (multiHandle, curlHandle);
+			curl_easy_cleanup (curlHandle);
+
+			if (request != NULL)
+			{
+				HTTP_REQUEST **link = &httpRequests;
+
+				while (*link != NULL && *link != request)
+					link = &(*link) -> next;
+				if (*link != NULL)
+					*link = request -> next;
+
+				if (result == CURLE_OK && request -> size)
+					request -> doneFunc (request -> data, request -> memory, request -> size);
+				else
+					request -> doneFunc (request -> data, NULL, 0);
+
+				free (request -> memory);
+				free (request);
+			}
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  E V E N T  C A L L B A C K                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by GLib when one of curl's sockets is ready.
+ *  \param channel Channel for the socket.
+ *  \param condition What the socket is ready for.
+ *  \param data Not used.
+ *  \result TRUE to keep the watch, curl removes it when done.
+ */
+static gboolean httpEventCallback (GIOChannel *channel, GIOCondition condition, gpointer data)
+{
+	int action = 0;
+
+	if (condition & G_IO_IN)
+		action |= CURL_CSELECT_IN;
+	if (condition & G_IO_OUT)
+		action |= CURL_CSELECT_OUT;
+	if (condition & (G_IO_ERR | G_IO_HUP))
+		action |= CURL_CSELECT_ERR;
+
+	curl_multi_socket_action (multiHandle, g_io_channel_unix_get_fd (channel), action, &runningHandles);
+	httpCheckDone ();
+	return TRUE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  T I M E O U T  C A L L B A C K                                                                           *
+ *  =======================================                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by GLib when curl's timer runs out.
+ *  \param data Not used.
+ *  \result FALSE, curl sets a new timer if it needs one.
+ */
+static gboolean httpTimeoutCallback (gpointer data)
+{
+	timerSource = 0;
+	curl_multi_socket_action (multiHandle, CURL_SOCKET_TIMEOUT, 0, &runningHandles);
+	httpCheckDone ();
+	return FALSE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  S O C K E T  C A L L B A C K                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by curl to say which sockets to watch.
+ *  \param curlHandle Transfer using the socket.
+ *  \param sock The socket.
+ *  \param what What to wait for, or CURL_POLL_REMOVE.
+ *  \param userp Not used.
+ *  \param socketp Watch ID saved by curl_multi_assign.
+ *  \result 0.
+ */
+static int httpSocketCallback (CURL *curlHandle, curl_socket_t sock, int what, void *userp, void *socketp)
+{
+	guint *watchID = (guint *)socketp;
+
+	if (watchID != NULL && *watchID)
+	{
+		g_source_remove (*watchID);
+		*watchID = 0;
+	}
+	if (what == CURL_POLL_REMOVE)
+	{
+		if (watchID != NULL)
+		{
+			curl_multi_assign (multiHandle, sock, NULL);
+			free (watchID);
+		}
+	}
+	else
+	{
+		GIOChannel *channel;
+		int condition = G_IO_ERR | G_IO_HUP;
+
+		if (watchID == NULL)
+		{
+			if ((watchID = (guint *)malloc (sizeof (guint))) == NULL)
+				return -1;
+			curl_multi_assign (multiHandle, sock, watchID);
+		}
+		if (what & CURL_POLL_IN)
+			condition |= G_IO_IN;
+		if (what & CURL_POLL_OUT)
+			condition |= G_IO_OUT;
+
+		channel = g_io_channel_unix_new (sock);
+		*watchID = g_io_add_watch (channel, (GIOCondition)condition, httpEventCallback, NULL);
+		g_io_channel_unref (channel);
+	}
+	return 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  T I M E R  C A L L B A C K                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by curl to change when it next wants to be called.
+ *  \param multi The multi handle.
+ *  \param timeoutMs Milli-seconds to wait, -1 to stop the timer.
+ *  \param userp Not used.
+ *  \result 0.
+ */
+static int httpTimerCallback (CURLM *multi, long timeoutMs, void *userp)
+{
+	if (timerSource)
+	{
+		g_source_remove (timerSource);
+		timerSource = 0;
+	}
+	if (timeoutMs >= 0)
+	{
+		timerSource = g_timeout_add (timeoutMs, httpTimeoutCallback, NULL);
+	}
+	return 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  I N I T                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Set up curl once, the connections, DNS and TLS sessions are kept between requests.
+ *  \result 1 if curl is ready, 0 if not.
+ */
+static int httpInit (void)
+{
+	if (multiHandle != NULL)
+		return 1;
+
+	if (curl_global_init (CURL_GLOBAL_ALL) != CURLE_OK)
+		return 0;
+
+	if ((multiHandle = curl_multi_init ()) == NULL)
+	{
+		curl_global_cleanup ();
+		return 0;
+	}
+	curl_multi_setopt (multiHandle, CURLMOPT_SOCKETFUNCTION, httpSocketCallback);
+	curl_multi_setopt (multiHandle, CURLMOPT_TIMERFUNCTION, httpTimerCallback);
+
+	if ((shareHandle = curl_share_init ()) != NULL)
+	{
+		curl_share_setopt (shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_DNS);
+		curl_share_setopt (shareHandle, CURLSHOPT_SHARE, CURL_LOCK_DATA_SSL_SESSION);
+	}
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  S T A R T                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Start reading a web page, doneFunc is called from the main loop when it is read.
+ *  \param url Address of the page.
+ *  \param gzip Ask for the page to be compressed.
+ *  \param writeFunc Passed each block as it is read, NULL to save the whole page.
+ *  \param doneFunc Called when the transfer has finished.
+ *  \param data Passed to writeFunc and doneFunc.
+ *  \result 1 if the request was started, 0 if not.
+ */
+static int httpStart (char *url, int gzip, HTTP_WRITE writeFunc, HTTP_DONE doneFunc, void *data)
+{
+	HTTP_REQUEST *request;
+	CURL *curlHandle;
+
+	if (!httpInit ())
+		return 0;
+
+	if ((request = (HTTP_REQUEST *)calloc (1, sizeof (HTTP_REQUEST))) == NULL)
+		return 0;
+
+	if ((curlHandle = curl_easy_init ()) == NULL)
+	{
+		free (request);
+		return 0;
+	}
+	request -> curlHandle = curlHandle;
+	request -> writeFunc = writeFunc;
+	request -> doneFunc = doneFunc;
+	request -> data = data;
+
+	curl_easy_setopt (curlHandle, CURLOPT_URL, url);
+	if (gzip)
+	{
+		/*--------------------------------------------------------------------------------------------*
+         * The options are enums not macros, so check the version to see which ones curl has          *
+         *--------------------------------------------------------------------------------------------*/
+#if LIBCURL_VERSION_NUM >= 0x071506
+		curl_easy_setopt (curlHandle, CURLOPT_TRANSFER_ENCODING, 1L);
+		curl_easy_setopt (curlHandle, CURLOPT_ACCEPT_ENCODING, "gzip");
+#else
+		curl_easy_setopt (curlHandle, CURLOPT_ENCODING, "gzip");
+#endif
+	}
+	curl_easy_setopt (curlHandle, CURLOPT_WRITEFUNCTION, httpWriteCallback);
+	curl_easy_setopt (curlHandle, CURLOPT_WRITEDATA, (void *)request);
+	curl_easy_setopt (curlHandle, CURLOPT_PRIVATE, (char *)request);
+	curl_easy_setopt (curlHandle, CURLOPT_USERAGENT, "libcurl-agent/1.0");
+	curl_easy_setopt (curlHandle, CURLOPT_NOSIGNAL, 1L);
+	curl_easy_setopt (curlHandle, CURLOPT_CONNECTTIMEOUT, 30L);
+	curl_easy_setopt (curlHandle, CURLOPT_TIMEOUT, 120L);
+	if (shareHandle != NULL)
+	{
+		curl_easy_setopt (curlHandle, CURLOPT_SHARE, shareHandle);
+	}
+
+	if (curl_multi_add_handle (multiHandle, curlHandle) != CURLM_OK)
+	{
+		curl_easy_cleanup (curlHandle);
+		free (request);
+		return 0;
+	}
+	request -> next = httpRequests;
+	httpRequests = request;
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  F E T C H                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read a whole web page.
+ *  \param url Address of the page.
+ *  \param gzip Ask for the page to be compressed.
+ *  \param doneFunc Called with the page, or a NULL buffer if it could not be read.
+ *  \param data Passed to doneFunc.
+ *  \result 1 if the request was started, 0 if not.
+ */
+int httpFetch (char *url, int gzip, HTTP_DONE doneFunc, void *data)
+{
+	return httpStart (url, gzip, NULL, doneFunc, data);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  S T R E A M                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read a web page a block at a time without saving it.
+ *  \param url Address of the page.
+ *  \param gzip Ask for the page to be compressed.
+ *  \param writeFunc Passed each block as it is read, return 0 to stop the transfer.
+ *  \param doneFunc Called with a NULL buffer and the number of bytes read, 0 if it failed.
+ *  \param data Passed to writeFunc and doneFunc.
+ *  \result 1 if the request was started, 0 if not.
+ */
+int httpStream (char *url, int gzip, HTTP_WRITE writeFunc, HTTP_DONE doneFunc, void *data)
+{
+	return httpStart (url, gzip, writeFunc, doneFunc, data);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  F R E E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Drop any transfers still running and free curl, called on exit.
+ *  \result None.
+ */
+void httpFree (void)
+{
+	if (multiHandle != NULL)
+	{
+		while (httpRequests != NULL)
+		{
+			HTTP_REQUEST *request = httpRequests;
+
+			httpRequests = request -> next;
+			curl_multi_remove_handle (multiHandle, request -> curlHandle);
+			curl_easy_cleanup (request -> curlHandle);
+			free (request -> memory);
+			free (request);
+		}
+		curl_multi_cleanup (multiHandle);
+		multiHandle = NULL;
+		if (shareHandle != NULL)
+		{
+			curl_share_cleanup (shareHandle);
+			shareHandle = NULL;
+		}
+		if (timerSource)
+		{
+			g_source_remove (timerSource);
+			timerSource = 0;
+		}
+		curl_global_cleanup ();
+	}
+}
+
@@ -24,6 +24,8 @@
 #include <string.h>
 #include "GaugeDisp.h"
 
+#define MEMORY_TICKS 15
+
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
@@ -72,6 +74,22 @@ void readMemoryInit (void)
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M E M O R Y  T I C K  P E R I O D                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a memory face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int memoryTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return MEMORY_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  M E M O R Y  V A L U E S                                                                                 *
@@ -96,7 +114,7 @@ void readMemoryValues (int face)
 		{
 			;
 		}
-		else if (sysUpdateID % 15 != 0)
+		else if (sysUpdateID % memoryTickPeriod (faceSetting) != 0)
 		{
 			return;
 		}
@@ -40,6 +40,8 @@ TimePlace;
 
 #include "GaugeDisp.h"
 
+#define MOON_PHASE_TICKS 25
+
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
@@ -261,6 +263,22 @@ double moon_phase(int year, int month, int day, double hour, int *ip)
 	return (1.0 - cos((lm - ls) * RAD)) / 2;
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M O O N  P H A S E  T I C K  P E R I O D                                                                          *
+ *  ========================================                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a moon phase face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int moonPhaseTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return MOON_PHASE_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  M O O N  P H A S E  V A L U E S                                                                          *
@@ -282,7 +300,7 @@ void readMoonPhaseValues (int face)
 		{
 			;
 		}
-		else if (sysUpdateID % 25 != 0)
+		else if (sysUpdateID % moonPhaseTickPeriod (faceSetting) != 0)
 		{
 			return;
 		}
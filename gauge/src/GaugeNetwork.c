@@ -23,17 +23,29 @@
 #include <stdio.h>
 #include <string.h>
 #include <dirent.h>
+#include <fcntl.h>
+#include <fnmatch.h>
+#include <sys/socket.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
 
 #include "GaugeDisp.h"
 
-#define MAX_DEVICES		10
+#define MAX_DEVICES		15
 #define MAX_SCALE_MEM	20
+#define DEV_BUFF_SIZE	8192
+#define NL_BUFF_SIZE	32768
+#define NETWORK_TICKS	10
 
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
 extern MENU_DESC networkDevDesc[];
 extern int sysUpdateID;
+extern char networkInclude[];
+extern char networkExclude[];
+extern bool networkNetlink;
 
 struct devValues
 {
@@ -48,17 +60,39 @@ typedef struct _devInfo
 	char name[41];
 	struct devValues dataRead;
 	struct devValues dataWrite;
+	int menuSlot;
+	int seenID;
+	bool skip;
 }
 DEVICE_INFO;
 
 static int myUpdateID = 100;
-static long lastTime;
+static RATE_TIMER deviceTimer;
 static char *deviceStats = "/proc/net/dev";
 static char *typeNames[] = { "Rx", "Tx" };
-DEVICE_INFO deviceActivity[MAX_DEVICES + 1] =
-{
-	{ "All" }
-};
+static DEVICE_INFO allDevices = { "All" };
+static DEVICE_INFO noDevice;
+
+/*----------------------------------------------------------------------------------------------------*
+ * Every interface in /proc/net/dev is kept in the table by name, the first ones that pass the        *
+ * filters also get a slot in the menu. The file is kept open and read with pread.                    *
+ *----------------------------------------------------------------------------------------------------*/
+static GHashTable *deviceTable = NULL;
+static DEVICE_INFO *deviceActivity[MAX_DEVICES + 1] = { &allDevices };
+static int deviceSlots = 1;
+static int deviceSeenID = 0;
+static int devStatsFile = -1;
+static char *devBuffer = NULL;
+static size_t devBuffSize = 0;
+
+/*----------------------------------------------------------------------------------------------------*
+ * With network_netlink set the counters are dumped over rtnetlink instead, falling back to the file  *
+ * if that fails. A second socket hears links come and go so the menu is kept up to date.             *
+ *----------------------------------------------------------------------------------------------------*/
+static int netlinkSock = -1;
+static int netlinkEvents = -1;
+static unsigned int netlinkSeq = 0;
+static bool netlinkFailed = false;
 
 static char *speedName[] =
 {
@@ -133,108 +167,525 @@ void setDeviceScale (struct devValues *values, int lockScale)
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  R E A D  D E V I C E  V A L U E S                                                                                 *
- *  =================================                                                                                 *
+ *  D E V I C E  M A T C H                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check a device name against a list of glob patterns.
+ *  \param patterns Patterns split by spaces or commas, such as "veth* lo".
+ *  \param name Name of the device.
+ *  \result True if any of the patterns match.
+ */
+static bool deviceMatch (const char *patterns, const char *name)
+{
+	char pattern[101], *savePtr = NULL, *token;
+
+	strncpy (pattern, patterns, 100);
+	pattern[100] = 0;
+	for (token = strtok_r (pattern, " ,", &savePtr); token != NULL; token = strtok_r (NULL, " ,", &savePtr))
+	{
+		if (fnmatch (token, name, 0) == 0)
+			return true;
+	}
+	return false;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D E V I C E  A D D                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Add a device the first time it is seen, the filters are only checked here.
+ *  \param name Name of the device.
+ *  \result Pointer to the new device, NULL if out of memory.
+ */
+static DEVICE_INFO *deviceAdd (const char *name)
+{
+	DEVICE_INFO *devInfo;
+
+	if ((devInfo = calloc (1, sizeof (DEVICE_INFO))) == NULL)
+		return NULL;
+
+	strncpy (devInfo -> name, name, 40);
+	devInfo -> seenID = -1;
+	if (networkInclude[0] && !deviceMatch (networkInclude, name))
+		devInfo -> skip = true;
+	else if (networkExclude[0] && deviceMatch (networkExclude, name))
+		devInfo -> skip = true;
+	else if (deviceSlots < MAX_DEVICES + 1)
+	{
+		devInfo -> menuSlot = deviceSlots;
+		deviceActivity[deviceSlots++] = devInfo;
+		networkDevDesc[devInfo -> menuSlot].disable = 0;
+		networkDevDesc[devInfo -> menuSlot].menuName = devInfo -> name;
+		gaugeMenuDesc[MENU_GAUGE_NETWORK].disable = 0;
+	}
+	g_hash_table_insert (deviceTable, devInfo -> name, devInfo);
+	return devInfo;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D E V I C E  G O N E                                                                                              *
+ *  ====================                                                                                              *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Read the number of sectors read.
+ *  \brief Drop devices not seen on the last read, devices on the menu are kept but show nothing.
+ *  \param key Name of the device.
+ *  \param value Device information.
+ *  \param userData Not used.
+ *  \result TRUE if the device should be removed.
+ */
+static gboolean deviceGone (gpointer key, gpointer value, gpointer userData)
+{
+	DEVICE_INFO *devInfo = (DEVICE_INFO *)value;
+
+	if (devInfo -> seenID == deviceSeenID)
+		return FALSE;
+	if (devInfo -> menuSlot)
+	{
+		devInfo -> dataRead.rate = devInfo -> dataWrite.rate = 0;
+		return FALSE;
+	}
+	return TRUE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D E V I C E  U P D A T E                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Work out the rate for one direction of a device.
+ *  \param values Values to update.
+ *  \param total Values for all the devices.
+ *  \param value Counter just read.
+ *  \param seconds Seconds since the last read, 0 for the first read.
  *  \result None.
  */
-void readDeviceValues(int lockScale)
+static void deviceUpdate (struct devValues *values, struct devValues *total, unsigned long long value, double seconds)
 {
-	FILE *devstats;
-	struct timeval tvTaken;
-	char readBuff[1025], readWord[256];
-	long thisTime = 0, readTime;
-	int device = 1;
-
-	gettimeofday (&tvTaken, NULL);
-	thisTime = ((tvTaken.tv_sec % 100000) * 1000) + (tvTaken.tv_usec / 1000);
-	readTime = thisTime - lastTime;
-	lastTime = thisTime;
-	if (!readTime) return;
-
-	deviceActivity[0].dataRead.value = deviceActivity[0].dataRead.rate = 0;
-	deviceActivity[0].dataWrite.value = deviceActivity[0].dataWrite.rate = 0;
-
-	if ((devstats = fopen (deviceStats, "r")) != NULL)
+	unsigned long long diff;
+
+	if (seconds > 0)
 	{
-		while (fgets (readBuff, 1024, devstats) && device < (MAX_DEVICES + 1))
+		diff = rateCounterDiff (values -> value, value);
+		values -> rate = rateSmooth (values -> rate, (double)diff / seconds, seconds);
+		total -> value += diff;
+	}
+	else
+	{
+		values -> rate = 0;
+	}
+	values -> value = value;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D E V I C E  S A M P L E                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Save the counters read for one device, from either the file or netlink.
+ *  \param name Name of the device.
+ *  \param readBytes Bytes received.
+ *  \param writeBytes Bytes sent.
+ *  \param seconds Seconds since the last read.
+ *  \param lockScale Do not make the scale smaller.
+ *  \result 1 if the device is in the table, 0 if it could not be added.
+ */
+static int deviceSample (const char *name, unsigned long long readBytes, unsigned long long writeBytes,
+		double seconds, int lockScale)
+{
+	DEVICE_INFO *devInfo;
+	double thisRead;
+
+	if ((devInfo = g_hash_table_lookup (deviceTable, name)) == NULL)
+	{
+		if ((devInfo = deviceAdd (name)) == NULL)
+			return 0;
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * A device that was not there last time only has its counters saved                              *
+     *------------------------------------------------------------------------------------------------*/
+	thisRead = devInfo -> seenID == deviceSeenID - 1 ? seconds : 0;
+	devInfo -> seenID = deviceSeenID;
+	if (devInfo -> skip)
+		return 1;
+
+	deviceUpdate (&devInfo -> dataRead, &allDevices.dataRead, readBytes, thisRead);
+	deviceUpdate (&devInfo -> dataWrite, &allDevices.dataWrite, writeBytes, thisRead);
+	if (devInfo -> menuSlot)
+	{
+		setDeviceScale (&devInfo -> dataRead, lockScale);
+		setDeviceScale (&devInfo -> dataWrite, lockScale);
+	}
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  P R O C  D E V I C E S                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read and parse /proc/net/dev, only the rx and tx byte counts are used.
+ *  \param seconds Seconds since the last read.
+ *  \param lockScale Do not make the scale smaller.
+ *  \result Number of devices seen, -1 if the file could not be read.
+ */
+static int readProcDevices (double seconds, int lockScale)
+{
+	char *readPtr, *namePtr, *endPtr, *newBuffer;
+	unsigned long long readBytes, writeBytes;
+	ssize_t readSize;
+	int i, seen = 0;
+
+	if (devStatsFile == -1)
+	{
+		if ((devStatsFile = open (deviceStats, O_RDONLY)) == -1)
+			return -1;
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * Keep making the buffer bigger until the whole file fits, there can be hundreds of devices      *
+     *------------------------------------------------------------------------------------------------*/
+	while ((readSize = pread (devStatsFile, devBuffer, devBuffSize - 1, 0)) == (ssize_t)devBuffSize - 1)
+	{
+		if ((newBuffer = realloc (devBuffer, devBuffSize * 2)) == NULL)
+			break;
+		devBuffer = newBuffer;
+		devBuffSize *= 2;
+	}
+	if (readSize < 0)
+	{
+		close (devStatsFile);
+		devStatsFile = -1;
+		return -1;
+	}
+	devBuffer[readSize] = 0;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Skip the two header lines, then each line is "name: rx bytes, 7 more rx fields, tx bytes..."   *
+     *------------------------------------------------------------------------------------------------*/
+	readPtr = devBuffer;
+	for (i = 0; i < 2 && readPtr != NULL; ++i)
+	{
+		if ((readPtr = strchr (readPtr, '\n')) != NULL)
+			++readPtr;
+	}
+	while (readPtr != NULL && *readPtr)
+	{
+		while (*readPtr == ' ')
+			++readPtr;
+		namePtr = readPtr;
+		if ((readPtr = strchr (readPtr, ':')) == NULL)
+			break;
+		*readPtr++ = 0;
+
+		readBytes = strtoull (readPtr, &endPtr, 10);
+		for (i = 0; i < 7; ++i)
 		{
-			int i = 0, j = 0, w = 0;
+			while (*endPtr == ' ')
+				++endPtr;
+			while (*endPtr > ' ')
+				++endPtr;
+		}
+		writeBytes = strtoull (endPtr, &endPtr, 10);
+		readPtr = strchr (endPtr, '\n');
+		if (readPtr != NULL)
+			++readPtr;
+
+		seen += deviceSample (namePtr, readBytes, writeBytes, seconds, lockScale);
+	}
+	return seen;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  N E T L I N K  L I N K  I N F O                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find the name and byte counts in a link message.
+ *  \param nlh The RTM_NEWLINK or RTM_DELLINK message.
+ *  \param readBytes Return bytes received, may be NULL.
+ *  \param writeBytes Return bytes sent, may be NULL.
+ *  \result Name of the link, NULL if it has none.
+ */
+static const char *netlinkLinkInfo (struct nlmsghdr *nlh, unsigned long long *readBytes,
+		unsigned long long *writeBytes)
+{
+	struct ifinfomsg *ifi = NLMSG_DATA (nlh);
+	struct rtattr *rta = IFLA_RTA (ifi);
+	int rtaLen = IFLA_PAYLOAD (nlh);
+	const char *name = NULL;
+	bool have64 = false;
+
+	if (readBytes != NULL)
+		*readBytes = *writeBytes = 0;
 
-			if (strncmp (readBuff, "Inter", 5) == 0 || strncmp (readBuff, " face", 5) == 0)
+	for (; RTA_OK (rta, rtaLen); rta = RTA_NEXT (rta, rtaLen))
+	{
+		if (rta -> rta_type == IFLA_IFNAME)
+		{
+			name = (const char *)RTA_DATA (rta);
+		}
+		else if (readBytes == NULL)
+		{
+			;
+		}
+		else if (rta -> rta_type == IFLA_STATS64 && RTA_PAYLOAD (rta) >= sizeof (struct rtnl_link_stats64))
+		{
+			/*----------------------------------------------------------------------------------------*
+             * The attribute is only four byte aligned so copy it out                                 *
+             *----------------------------------------------------------------------------------------*/
+			struct rtnl_link_stats64 stats;
+
+			memcpy (&stats, RTA_DATA (rta), sizeof (stats));
+			*readBytes = stats.rx_bytes;
+			*writeBytes = stats.tx_bytes;
+			have64 = true;
+		}
+		else if (rta -> rta_type == IFLA_STATS && !have64 && RTA_PAYLOAD (rta) >= sizeof (struct rtnl_link_stats))
+		{
+			struct rtnl_link_stats *stats = RTA_DATA (rta);
+
+			*readBytes = stats -> rx_bytes;
+			*writeBytes = stats -> tx_bytes;
+		}
+	}
+	return name;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  N E T L I N K  O P E N                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Open a route netlink socket.
+ *  \param groups Multicast groups to listen to, 0 for requests only.
+ *  \result Socket, -1 on error.
+ */
+static int netlinkOpen (unsigned int groups)
+{
+	struct sockaddr_nl addr;
+	int sock;
+
+	if ((sock = socket (AF_NETLINK, SOCK_RAW | SOCK_CLOEXEC, NETLINK_ROUTE)) == -1)
+		return -1;
+
+	memset (&addr, 0, sizeof (addr));
+	addr.nl_family = AF_NETLINK;
+	addr.nl_groups = groups;
+	if (bind (sock, (struct sockaddr *)&addr, sizeof (addr)) == -1)
+	{
+		close (sock);
+		return -1;
+	}
+	return sock;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  N E T L I N K  D E V I C E S                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Dump the counters for every link in one request, the reply is in binary so there is no parsing.
+ *  \param seconds Seconds since the last read.
+ *  \param lockScale Do not make the scale smaller.
+ *  \result Number of devices seen, -1 if netlink did not work.
+ */
+static int readNetlinkDevices (double seconds, int lockScale)
+{
+	struct
+	{
+		struct nlmsghdr nlh;
+		struct ifinfomsg ifm;
+	}
+	request;
+	unsigned long long readBytes, writeBytes;
+	struct nlmsghdr *nlh;
+	const char *name;
+	ssize_t readSize;
+	char *newBuffer;
+	int seen = 0;
+
+	if (netlinkSock == -1)
+	{
+		if ((netlinkSock = netlinkOpen (0)) == -1)
+			return -1;
+	}
+	if (devBuffSize < NL_BUFF_SIZE)
+	{
+		if ((newBuffer = realloc (devBuffer, NL_BUFF_SIZE)) == NULL)
+			return -1;
+		devBuffer = newBuffer;
+		devBuffSize = NL_BUFF_SIZE;
+	}
+
+	memset (&request, 0, sizeof (request));
+	request.nlh.nlmsg_len = NLMSG_LENGTH (sizeof (struct ifinfomsg));
+	request.nlh.nlmsg_type = RTM_GETLINK;
+	request.nlh.nlmsg_flags = NLM_F_REQUEST | NLM_F_DUMP;
+	request.nlh.nlmsg_seq = ++netlinkSeq;
+	request.ifm.ifi_family = AF_UNSPEC;
+	if (send (netlinkSock, &request, request.nlh.nlmsg_len, 0) < 0)
+		return -1;
+
+	/*------------------------------------------------------------------------------------------------*
+     * The dump comes back over several reads, each holding as many links as fit, until NLMSG_DONE    *
+     *------------------------------------------------------------------------------------------------*/
+	while ((readSize = recv (netlinkSock, devBuffer, devBuffSize, 0)) > 0)
+	{
+		for (nlh = (struct nlmsghdr *)devBuffer; NLMSG_OK (nlh, readSize); nlh = NLMSG_NEXT (nlh, readSize))
+		{
+			if (nlh -> nlmsg_seq != netlinkSeq)
+				continue;
+			if (nlh -> nlmsg_type == NLMSG_DONE)
+				return seen;
+			if (nlh -> nlmsg_type == NLMSG_ERROR)
+				return -1;
+			if (nlh -> nlmsg_type != RTM_NEWLINK)
+				continue;
+
+			if ((name = netlinkLinkInfo (nlh, &readBytes, &writeBytes)) != NULL)
+				seen += deviceSample (name, readBytes, writeBytes, seconds, lockScale);
+		}
+	}
+	return -1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  N E T L I N K  E V E N T  C A L L B A C K                                                                         *
+ *  =========================================                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called from the main loop when a link has been added or removed.
+ *  \param channel Channel for the event socket.
+ *  \param condition Why we were called.
+ *  \param data Not used.
+ *  \result TRUE to keep listening, FALSE if the socket has failed.
+ */
+static gboolean netlinkEventCallback (GIOChannel *channel, GIOCondition condition, gpointer data)
+{
+	static char eventBuffer[8192];
+	struct nlmsghdr *nlh;
+	DEVICE_INFO *devInfo;
+	const char *name;
+	ssize_t readSize;
+
+	if (condition & (G_IO_ERR | G_IO_HUP))
+	{
+		close (netlinkEvents);
+		netlinkEvents = -1;
+		return FALSE;
+	}
+	while ((readSize = recv (netlinkEvents, eventBuffer, sizeof (eventBuffer), MSG_DONTWAIT)) > 0)
+	{
+		for (nlh = (struct nlmsghdr *)eventBuffer; NLMSG_OK (nlh, readSize); nlh = NLMSG_NEXT (nlh, readSize))
+		{
+			if (nlh -> nlmsg_type != RTM_NEWLINK && nlh -> nlmsg_type != RTM_DELLINK)
+				continue;
+			if ((name = netlinkLinkInfo (nlh, NULL, NULL)) == NULL)
 				continue;
 
-			while (readBuff[i])
+			devInfo = g_hash_table_lookup (deviceTable, name);
+			if (nlh -> nlmsg_type == RTM_NEWLINK && devInfo == NULL)
 			{
-				if (readBuff[0] == '#' && w == 0)
-					break;
-				if (readBuff[i] > ' ' && readBuff[i] != ':')
-				{
-					if (j == 0)
-					{
-						if (++w == 11)
-							break;
-					}
-					readWord[j] = readBuff[i];
-					readWord[++j] = 0;
-				}
-				else if (j)
-				{
-					if (w == 1)
-					{
-						readWord[40] = 0;
-						strcpy (deviceActivity[device].name, readWord);
-					}
-					if (w == 2)
-					{
-						unsigned long long diff;
-						unsigned long long value = atoll (readWord);
-						if (value < deviceActivity[device].dataRead.value)
-						{
-							deviceActivity[device].dataRead.value = value;
-							break;
-						}
-						diff = value - deviceActivity[device].dataRead.value;
-						deviceActivity[device].dataRead.rate = (diff * 1000) / readTime;
-						deviceActivity[device].dataRead.value = value;
-						deviceActivity[0].dataRead.value += diff;
-					}
-					if (w == 10)
-					{
-						unsigned long long diff;
-						unsigned long long value = atoll (readWord);
-						if (value < deviceActivity[device].dataWrite.value)
-						{
-							deviceActivity[device].dataWrite.value = value;
-							break;
-						}
-						diff = value - deviceActivity[device].dataWrite.value;
-						deviceActivity[device].dataWrite.rate = (diff * 1000) / readTime;
-						deviceActivity[device].dataWrite.value = value;
-						deviceActivity[0].dataWrite.value += diff;
-
-						setDeviceScale (&deviceActivity[device].dataRead, lockScale);
-						setDeviceScale (&deviceActivity[device].dataWrite, lockScale);
-
-						networkDevDesc[device].disable = 0;
-						networkDevDesc[device].menuName = deviceActivity[device].name;
-						gaugeMenuDesc[MENU_GAUGE_NETWORK].disable = 0;
-						++device;
-					}
-					j = 0;
-				}
-				++i;
+				deviceAdd (name);
+			}
+			else if (nlh -> nlmsg_type == RTM_DELLINK && devInfo != NULL)
+			{
+				devInfo -> seenID = -1;
+				if (devInfo -> menuSlot)
+					devInfo -> dataRead.rate = devInfo -> dataWrite.rate = 0;
+				else
+					g_hash_table_remove (deviceTable, name);
 			}
 		}
-		fclose (devstats);
 	}
-	deviceActivity[0].dataRead.rate = (deviceActivity[0].dataRead.value * 1000) / readTime;
-	deviceActivity[0].dataWrite.rate = (deviceActivity[0].dataWrite.value * 1000) / readTime;
-	setDeviceScale (&deviceActivity[0].dataRead, lockScale);
-	setDeviceScale (&deviceActivity[0].dataWrite, lockScale);
+	return TRUE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  D E V I C E  V A L U E S                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the bytes sent and received by each network device.
+ *  \param lockScale Do not make the scale smaller.
+ *  \result None.
+ */
+void readDeviceValues(int lockScale)
+{
+	double seconds = rateTimerRead (&deviceTimer);
+	int seen = -1;
+
+	allDevices.dataRead.value = 0;
+	allDevices.dataWrite.value = 0;
+
+	if (deviceTable == NULL)
+	{
+		deviceTable = g_hash_table_new_full (g_str_hash, g_str_equal, NULL, free);
+	}
+	if (devBuffer == NULL)
+	{
+		if ((devBuffer = malloc (DEV_BUFF_SIZE)) == NULL)
+			return;
+		devBuffSize = DEV_BUFF_SIZE;
+	}
+
+	++deviceSeenID;
+	if (networkNetlink && !netlinkFailed)
+	{
+		if ((seen = readNetlinkDevices (seconds, lockScale)) == -1)
+		{
+			/*----------------------------------------------------------------------------------------*
+             * No netlink, such as in a sandbox, so use the file from now on                          *
+             *----------------------------------------------------------------------------------------*/
+			if (netlinkSock != -1)
+				close (netlinkSock);
+			netlinkSock = -1;
+			netlinkFailed = true;
+			allDevices.dataRead.value = allDevices.dataWrite.value = 0;
+			++deviceSeenID;
+		}
+	}
+	if (seen == -1 && (seen = readProcDevices (seconds, lockScale)) == -1)
+		return;
+
+	if (seen != (int)g_hash_table_size (deviceTable))
+	{
+		g_hash_table_foreach_remove (deviceTable, deviceGone, NULL);
+	}
+
+	if (seconds > 0)
+	{
+		allDevices.dataRead.rate = rateSmooth (allDevices.dataRead.rate,
+				(double)allDevices.dataRead.value / seconds, seconds);
+		allDevices.dataWrite.rate = rateSmooth (allDevices.dataWrite.rate,
+				(double)allDevices.dataWrite.value / seconds, seconds);
+	}
+	setDeviceScale (&allDevices.dataRead, lockScale);
+	setDeviceScale (&allDevices.dataWrite, lockScale);
 }
 
 /**********************************************************************************************************************
@@ -252,9 +703,32 @@ void readNetworkInit (void)
 	if (gaugeEnabled[FACE_TYPE_NETWORK].enabled)
 	{
 		readDeviceValues(0);
+		if (networkNetlink && !netlinkFailed && (netlinkEvents = netlinkOpen (RTMGRP_LINK)) != -1)
+		{
+			GIOChannel *channel = g_io_channel_unix_new (netlinkEvents);
+
+			g_io_add_watch (channel, G_IO_IN | G_IO_ERR | G_IO_HUP, netlinkEventCallback, NULL);
+			g_io_channel_unref (channel);
+		}
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  N E T W O R K  T I C K  P E R I O D                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a network face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int networkTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return NETWORK_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  N E T W O R K  V A L U E S                                                                               *
@@ -277,12 +751,13 @@ void readNetworkValues (int face)
 		unsigned long value = 0;
 		unsigned short shift;
 		char *nameT, *nameD;
+		DEVICE_INFO *devInfo;
 
 		if (faceSetting -> faceFlags & FACE_REDRAW)
 		{
 			;
 		}
-		else if (sysUpdateID % 10 != 0)
+		else if (sysUpdateID % networkTickPeriod (faceSetting) != 0)
 		{
 			return;
 		}
@@ -292,18 +767,19 @@ void readNetworkValues (int face)
 			myUpdateID = sysUpdateID;
 		}
 
-		nameD = deviceActivity[device].name;
+		devInfo = device < deviceSlots ? deviceActivity[device] : &noDevice;
+		nameD = devInfo -> name;
 		if (faceType)
 		{
 			nameT = typeNames[0];
-			scale = deviceActivity[device].dataRead.useScale;
-			value = faceSetting -> firstValue = deviceActivity[device].dataRead.rate;
+			scale = devInfo -> dataRead.useScale;
+			value = faceSetting -> firstValue = devInfo -> dataRead.rate;
 		}
 		else
 		{
 			nameT = typeNames[1];
-			scale = deviceActivity[device].dataWrite.useScale;
-			value = faceSetting -> firstValue = deviceActivity[device].dataWrite.rate;
+			scale = devInfo -> dataWrite.useScale;
+			value = faceSetting -> firstValue = devInfo -> dataWrite.rate;
 		}
 		faceSetting -> firstValue /= scale;
 		shift = getScaleShiftCount(scale);
@@ -41,29 +41,7 @@ extern char powerServer[];
 extern int powerPort;
 
 double myPowerReading[8];
-
-/**********************************************************************************************************************
- *                                                                                                                    *
- *  R E A D  P O W E R  M E T E R  I N I T                                                                            *
- *  ======================================                                                                            *
- *                                                                                                                    *
- **********************************************************************************************************************/
-/**
- *  \brief Called once at the program start to find the devices.
- *  \result None 0 all is OK.
- */
-void readPowerMeterInit (void)
-{
-	if (gaugeEnabled[FACE_TYPE_POWER].enabled)
-	{
-		int clientSock = ConnectClientSocket (powerServer, powerPort, 3, USE_ANY, NULL);
-		if (SocketValid (clientSock))
-		{
-			gaugeMenuDesc[MENU_GAUGE_POWER].disable = 0;
-			CloseSocket (&clientSock);
-		}
-	}
-}
+static int powerCollector = -1;
 
 /**********************************************************************************************************************
  *                                                                                                                    *
@@ -73,29 +51,30 @@ void readPowerMeterInit (void)
  **********************************************************************************************************************/
 /**
  *  \brief Process each of the fields in the XML.
+ *  \param reading Readings to fill in.
  *  \param readLevel 0 current, 1 today, 2 tomorrow.
  *  \param name Name of the field.
  *  \param value Value of the field.
  *  \result None.
  */
-static void processPowerKey (int readLevel, const char *name, char *value)
+static void processPowerKey (double *reading, int readLevel, const char *name, char *value)
 {
 	if (readLevel == 1 && strcmp (name, "now") == 0)
-		myPowerReading[0] = atof (value);
+		reading[0] = atof (value);
 	if (readLevel == 1 && strcmp (name, "max") == 0)
-		myPowerReading[1] = atof (value);
+		reading[1] = atof (value);
 	if (readLevel == 1 && strcmp (name, "min") == 0)
-		myPowerReading[2] = atof (value);
+		reading[2] = atof (value);
 	if (readLevel == 1 && strcmp (name, "minavg") == 0)
-		myPowerReading[3] = atof (value);
+		reading[3] = atof (value);
 	if (readLevel == 1 && strcmp (name, "houravg") == 0)
-		myPowerReading[4] = atof (value);
+		reading[4] = atof (value);
 	if (readLevel == 1 && strcmp (name, "dayavg") == 0)
-		myPowerReading[5] = atof (value);
+		reading[5] = atof (value);
 	if (readLevel == 1 && strcmp (name, "monthavg") == 0)
-		myPowerReading[6] = atof (value);
+		reading[6] = atof (value);
 	if (readLevel == 1 && strcmp (name, "yearavg") == 0)
-		myPowerReading[7] = atof (value);
+		reading[7] = atof (value);
 }
 
 /**********************************************************************************************************************
@@ -106,12 +85,13 @@ static void processPowerKey (int readLevel, const char *name, char *value)
  **********************************************************************************************************************/
 /**
  *  \brief Process each of the elements in the file.
+ *  \param reading Readings to fill in.
  *  \param doc Document to read.
  *  \param aNode Current node.
  *  \param readLevel 0 current, 1 today, 2 tomorrow.
  *  \result None.
  */
-static void processElementNames (xmlDoc *doc, xmlNode * aNode, int readLevel)
+static void processElementNames (double *reading, xmlDoc *doc, xmlNode * aNode, int readLevel)
 {
 	xmlChar *key;
 	xmlNode *curNode = NULL;
@@ -127,11 +107,11 @@ static void processElementNames (xmlDoc *doc, xmlNode * aNode, int readLevel)
 			else
 			{
 				key = xmlNodeListGetString (doc, curNode -> xmlChildrenNode, 1);
-				processPowerKey (readLevel, (const char *)curNode -> name, (char *)key);
+				processPowerKey (reading, readLevel, (const char *)curNode -> name, (char *)key);
 				xmlFree (key);
 			}
 		}
-		processElementNames (doc, curNode->children, readLevel);
+		processElementNames (reading, doc, curNode->children, readLevel);
 	}
 }
 
@@ -143,11 +123,12 @@ static void processElementNames (xmlDoc *doc, xmlNode * aNode, int readLevel)
  **********************************************************************************************************************/
 /**
  *  \brief Process the down loaded buffer.
+ *  \param reading Readings to fill in.
  *  \param buffer Buffer to process.
  *  \param size Size of the buffer.
  *  \result None.
  */
-static void processBuffer (char *buffer, size_t size)
+static void processBuffer (double *reading, char *buffer, size_t size)
 {
 	xmlDoc *doc = NULL;
 	xmlNode *rootElement = NULL;
@@ -161,7 +142,7 @@ static void processBuffer (char *buffer, size_t size)
 		if (doc != NULL)
 		{
 			rootElement = xmlDocGetRootElement (doc);
-			processElementNames (doc, rootElement, 0);
+			processElementNames (reading, doc, rootElement, 0);
 			xmlFreeDoc (doc);
 		}
 		else
@@ -171,7 +152,6 @@ static void processBuffer (char *buffer, size_t size)
 		}
 		xmlFree (xmlBuffer);
 	}
-	xmlCleanupParser ();
 }
 
 /**********************************************************************************************************************
@@ -182,9 +162,10 @@ static void processBuffer (char *buffer, size_t size)
  **********************************************************************************************************************/
 /**
  *  \brief Read the current tempature from the powermeter.
+ *  \param snapshot Readings to fill in, called on a worker thread.
  *  \result None.
  */
-void readPowerMeterInfo ()
+static void readPowerMeterInfo (void *snapshot)
 {
 	char buffer[512] = "";
 	int bytesRead = 0;
@@ -200,7 +181,32 @@ void readPowerMeterInfo ()
 	}
 	if (bytesRead)
 	{
-		processBuffer (buffer, bytesRead);
+		processBuffer ((double *)snapshot, buffer, bytesRead);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  P O W E R  M E T E R  I N I T                                                                            *
+ *  ======================================                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called once at the program start to find the devices.
+ *  \result None 0 all is OK.
+ */
+void readPowerMeterInit (void)
+{
+	if (gaugeEnabled[FACE_TYPE_POWER].enabled)
+	{
+		int clientSock = ConnectClientSocket (powerServer, powerPort, 3, USE_ANY, NULL);
+		if (SocketValid (clientSock))
+		{
+			gaugeMenuDesc[MENU_GAUGE_POWER].disable = 0;
+			CloseSocket (&clientSock);
+			collectorInit ();
+			powerCollector = collectorRegister ("power", readPowerMeterInfo, sizeof (myPowerReading), 6000);
+		}
 	}
 }
 
@@ -243,22 +249,14 @@ void readPowerMeterValues (int face)
 	{
 		FACE_SETTINGS *faceSetting = faceSettings[face];
 		char powerStr[8][41];
-		int i;
+		int i, updateNum;
 
-		if (faceSetting -> faceFlags & FACE_REDRAW)
-		{
-			;
-		}
-		else if (faceSetting -> nextUpdate)
+		updateNum = collectorRead (powerCollector, myPowerReading);
+		if (!(faceSetting -> faceFlags & FACE_REDRAW) && updateNum == faceSetting -> updateNum)
 		{
-			faceSetting -> nextUpdate -= 1;
 			return;
 		}
-		else if (!faceSetting -> nextUpdate)
-		{
-			readPowerMeterInfo ();
-			faceSetting -> nextUpdate = 30;
-		}
+		faceSetting -> updateNum = updateNum;
 
 		for (i = 0; i < 8; ++i)
 			getPowerStr (myPowerReading[i], &powerStr[i][0]);
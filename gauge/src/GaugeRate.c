@@ -0,0 +1,107 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  G A U G E  R A T E . C                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Turn counters read from the system in to rates, shared by the network and disk gauges.
+ */
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include "GaugeDisp.h"
+
+extern int rateSmoothing;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R A T E  T I M E R  R E A D                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Time since the timer was last read, from the monotonic clock so it never wraps or jumps.
+ *  \param timer Timer to read, zero filled before the first read.
+ *  \result Seconds since the last read, 0 on the first read.
+ */
+double rateTimerRead (RATE_TIMER *timer)
+{
+	struct timespec now;
+	gint64 thisRead;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	thisRead = ((gint64)now.tv_sec * 1000000000) + now.tv_nsec;
+	timer -> seconds = timer -> lastRead ? (double)(thisRead - timer -> lastRead) / 1e9 : 0;
+	timer -> lastRead = thisRead;
+	return timer -> seconds;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R A T E  C O U N T E R  D I F F                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Work out how much a counter has gone up, allowing for it wrapping.
+ *  \param oldValue Counter from the last read.
+ *  \param newValue Counter just read.
+ *  \result Amount it has gone up, 0 if the counter was reset.
+ */
+unsigned long long rateCounterDiff (unsigned long long oldValue, unsigned long long newValue)
+{
+	unsigned long long diff = newValue - oldValue;
+
+	if (newValue >= oldValue)
+		return diff;
+
+	/*------------------------------------------------------------------------------------------------*
+     * A counter that went backwards has either wrapped, at 32 bits if it was still small enough or   *
+     * at 64 bits, or been reset. A wrap only moves it forward by less than half its range.           *
+     *------------------------------------------------------------------------------------------------*/
+	if (oldValue <= 0xFFFFFFFFULL)
+	{
+		diff &= 0xFFFFFFFFULL;
+		return diff < 0x80000000ULL ? diff : 0;
+	}
+	return diff < 0x8000000000000000ULL ? diff : 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R A T E  S M O O T H                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Smooth a new rate in to the last one, if rate_smoothing is set in the config file.
+ *  \param oldRate Rate shown last time.
+ *  \param newRate Rate just worked out.
+ *  \param seconds Seconds between the two, so the smoothing is the same whatever the read period.
+ *  \result Rate to show.
+ */
+float rateSmooth (float oldRate, double newRate, double seconds)
+{
+	double alpha;
+
+	if (rateSmoothing <= 0 || seconds <= 0)
+		return (float)newRate;
+
+	alpha = 1.0 - exp ((-seconds * 1000.0) / rateSmoothing);
+	return (float)(oldRate + (alpha * (newRate - oldRate)));
+}
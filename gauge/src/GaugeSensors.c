@@ -32,6 +32,8 @@
 #define SENSORS_API_VERSION 0
 #endif
 
+#define SENSOR_TICKS 10
+
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
@@ -162,6 +164,22 @@ void readSensorInit (void)
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S E N S O R  T I C K  P E R I O D                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a temperature or fan face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int sensorTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return SENSOR_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  S E N S O R  V A L U E S                                                                                 *
@@ -192,7 +210,7 @@ void readSensorValues (int face)
 		{
 			;
 		}
-		else if (sysUpdateID % 10 != 0)
+		else if (sysUpdateID % sensorTickPeriod (faceSetting) != 0)
 		{
 			return;
 		}
@@ -41,29 +41,7 @@ extern char thermoServer[];
 extern int thermoPort;
 
 double myThermoReading[5] = { 0, 0, 0, 0, 0 };
-
-/**********************************************************************************************************************
- *                                                                                                                    *
- *  R E A D  T H E R M O M E T E R  I N I T                                                                           *
- *  =======================================                                                                           *
- *                                                                                                                    *
- **********************************************************************************************************************/
-/**
- *  \brief Called once at the program start to find the devices.
- *  \result None 0 all is OK.
- */
-void readThermometerInit (void)
-{
-	if (gaugeEnabled[FACE_TYPE_THERMO].enabled)
-	{
-		int clientSock = ConnectClientSocket (thermoServer, thermoPort, 3, USE_ANY, NULL);
-		if (SocketValid (clientSock))
-		{
-			gaugeMenuDesc[MENU_GAUGE_THERMO].disable = 0;
-			CloseSocket (&clientSock);
-		}
-	}
-}
+static int thermoCollector = -1;
 
 /**********************************************************************************************************************
  *                                                                                                                    *
@@ -73,23 +51,24 @@ void readThermometerInit (void)
  **********************************************************************************************************************/
 /**
  *  \brief Process each of the fields in the XML.
+ *  \param reading Readings to fill in.
  *  \param readLevel 0 current, 1 today, 2 tomorrow.
  *  \param name Name of the field.
  *  \param value Value of the field.
  *  \result None.
  */
-static void processThermoKey (int readLevel, const char *name, char *value)
+static void processThermoKey (double *reading, int readLevel, const char *name, char *value)
 {
 	if (readLevel == 1 && strcmp (name, "outside") == 0)
-		myThermoReading[0] = atof (value);
+		reading[0] = atof (value);
 	if (readLevel == 1 && strcmp (name, "inside") == 0)
-		myThermoReading[1] = atof (value);
+		reading[1] = atof (value);
 	if (readLevel == 1 && strcmp (name, "pressure") == 0)
-		myThermoReading[2] = atof (value);
+		reading[2] = atof (value);
 	if (readLevel == 1 && strcmp (name, "light") == 0)
-		myThermoReading[3] = atof (value);
+		reading[3] = atof (value);
 	if (readLevel == 1 && strcmp (name, "humidity") == 0)
-		myThermoReading[4] = atof (value);
+		reading[4] = atof (value);
 }
 
 /**********************************************************************************************************************
@@ -100,12 +79,13 @@ static void processThermoKey (int readLevel, const char *name, char *value)
  **********************************************************************************************************************/
 /**
  *  \brief Process each of the elements in the file.
+ *  \param reading Readings to fill in.
  *  \param doc Document to read.
  *  \param aNode Current node.
  *  \param readLevel 0 current, 1 today, 2 tomorrow.
  *  \result None.
  */
-static void processElementNames (xmlDoc *doc, xmlNode * aNode, int readLevel)
+static void processElementNames (double *reading, xmlDoc *doc, xmlNode * aNode, int readLevel)
 {
 	xmlChar *key;
 	xmlNode *curNode = NULL;
@@ -121,11 +101,11 @@ static void processElementNames (xmlDoc *doc, xmlNode * aNode, int readLevel)
 			else
 			{
 				key = xmlNodeListGetString (doc, curNode -> xmlChildrenNode, 1);
-				processThermoKey (readLevel, (const char *)curNode -> name, (char *)key);
+				processThermoKey (reading, readLevel, (const char *)curNode -> name, (char *)key);
 				xmlFree (key);
 			}
 		}
-		processElementNames (doc, curNode->children, readLevel);
+		processElementNames (reading, doc, curNode->children, readLevel);
 	}
 }
 
@@ -137,11 +117,12 @@ static void processElementNames (xmlDoc *doc, xmlNode * aNode, int readLevel)
  **********************************************************************************************************************/
 /**
  *  \brief Process the down loaded buffer.
+ *  \param reading Readings to fill in.
  *  \param buffer Buffer to process.
  *  \param size Size of the buffer.
  *  \result None.
  */
-static void processBuffer (char *buffer, size_t size)
+static void processBuffer (double *reading, char *buffer, size_t size)
 {
 	xmlDoc *doc = NULL;
 	xmlNode *rootElement = NULL;
@@ -155,7 +136,7 @@ static void processBuffer (char *buffer, size_t size)
 		if (doc != NULL)
 		{
 			rootElement = xmlDocGetRootElement (doc);
-			processElementNames (doc, rootElement, 0);
+			processElementNames (reading, doc, rootElement, 0);
 			xmlFreeDoc (doc);
 		}
 		else
@@ -165,7 +146,6 @@ static void processBuffer (char *buffer, size_t size)
 		}
 		xmlFree (xmlBuffer);
 	}
-	xmlCleanupParser ();
 }
 
 /**********************************************************************************************************************
@@ -176,9 +156,10 @@ static void processBuffer (char *buffer, size_t size)
  **********************************************************************************************************************/
 /**
  *  \brief Read the current tempature from the thermometer.
+ *  \param snapshot Readings to fill in, called on a worker thread.
  *  \result None.
  */
-void readThermometerInfo ()
+static void readThermometerInfo (void *snapshot)
 {
 	char buffer[512] = "";
 	int bytesRead = 0;
@@ -194,7 +175,32 @@ void readThermometerInfo ()
 	}
 	if (bytesRead)
 	{
-		processBuffer (buffer, bytesRead);
+		processBuffer ((double *)snapshot, buffer, bytesRead);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  T H E R M O M E T E R  I N I T                                                                           *
+ *  =======================================                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called once at the program start to find the devices.
+ *  \result None 0 all is OK.
+ */
+void readThermometerInit (void)
+{
+	if (gaugeEnabled[FACE_TYPE_THERMO].enabled)
+	{
+		int clientSock = ConnectClientSocket (thermoServer, thermoPort, 3, USE_ANY, NULL);
+		if (SocketValid (clientSock))
+		{
+			gaugeMenuDesc[MENU_GAUGE_THERMO].disable = 0;
+			CloseSocket (&clientSock);
+			collectorInit ();
+			thermoCollector = collectorRegister ("thermometer", readThermometerInfo, sizeof (myThermoReading), 12000);
+		}
 	}
 }
 
@@ -214,21 +220,14 @@ void readThermometerValues (int face)
 	if (gaugeEnabled[FACE_TYPE_THERMO].enabled)
 	{
 		FACE_SETTINGS *faceSetting = faceSettings[face];
+		int updateNum;
 
-		if (faceSetting -> faceFlags & FACE_REDRAW)
-		{
-			;
-		}
-		else if (faceSetting -> nextUpdate)
+		updateNum = collectorRead (thermoCollector, myThermoReading);
+		if (!(faceSetting -> faceFlags & FACE_REDRAW) && updateNum == faceSetting -> updateNum)
 		{
-			faceSetting -> nextUpdate -= 1;
 			return;
 		}
-		else if (!faceSetting -> nextUpdate)
-		{
-			readThermometerInfo ();
-			faceSetting -> nextUpdate = 60;
-		}
+		faceSetting -> updateNum = updateNum;
 
 		setFaceString (faceSetting, FACESTR_TOP, 0, "Thermometer");
 		setFaceString (faceSetting, FACESTR_TIP, 0, _("<b>Outside</b>: %0.1f\302\260C\n<b>Inside</b>: %0.1f\302\260C\n"
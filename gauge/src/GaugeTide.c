@@ -23,13 +23,14 @@
 #include <stdio.h>
 #include <string.h>
 #include <dirent.h>
-#include <curl/curl.h>
 #include <libxml/parser.h>
 #include <libxml/tree.h>
 #include <libxml/HTMLparser.h>
 
 #include "GaugeDisp.h"
 
+#define TIDE_TICKS 60
+
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
@@ -39,12 +40,6 @@ extern char tideURL[];
 
 #define MAX_SAVE_TIDES	21
 
-struct MemoryStruct
-{
-  char *memory;
-  size_t size;
-};
-
 struct TideTime
 {
 	time_t tideTime;
@@ -67,6 +62,8 @@ static char tideReadLine[1025];
 static int lastReadTide;
 
 static int myUpdateID = 100;
+static int tideUpdateNum = 0;
+static int tideFetching = 0;
 static time_t tideDuration = 22358;
 static char removePrefix[] = "Port predictions (Standard Local Time) are ";
 static char *days[7] = { "Sun", "Mon", "Tue", "Wed", "Thu", "Fri", "Sat" };
@@ -312,36 +309,6 @@ static void processCurrentDay()
 	}
 }
 
-/**********************************************************************************************************************
- *                                                                                                                    *
- *  W R I T E  M E M O R Y  C A L L B A C K                                                                           *
- *  =======================================                                                                           *
- *                                                                                                                    *
- **********************************************************************************************************************/
-/**
- *  \brief Called back by curl to write page to memoy.
- *  \param ptr Pointer to the data.
- *  \param size Size of the data.
- *  \param nmemb Size of the data parts.
- *  \param data Pointer to my data structure.
- *  \result Total size.
- */
-static size_t
-writeMemoryCallback(void *ptr, size_t size, size_t nmemb, void *data)
-{
-	size_t realsize = size * nmemb;
-	struct MemoryStruct *mem = (struct MemoryStruct *)data;
-
-	mem -> memory = realloc (mem -> memory, mem -> size + realsize + 1);
-	if (mem -> memory == NULL)
-		return realsize;
-
-	memcpy (&(mem -> memory[mem->size]), ptr, realsize);
-	mem -> size += realsize;
-	mem -> memory[mem->size] = 0;
-	return realsize;
-}
-
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  P R O C E S S  E L E M E N T  N A M E S                                                                           *
@@ -483,7 +450,33 @@ static void processBuffer (char *buffer, size_t size)
 		}
 		xmlFree (xmlBuffer);
 	}
-	xmlCleanupParser();
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T I D E  F E T C H  D O N E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called from the main loop when the tide page has been read.
+ *  \param data Not used.
+ *  \param buffer Page that was read, NULL if it failed.
+ *  \param size Size of the page.
+ *  \result None.
+ */
+static void tideFetchDone (void *data, char *buffer, size_t size)
+{
+	tideFetching = 0;
+
+	if (size)
+	{
+		memset (&tideInfo, 0, sizeof (tideInfo));
+		processBuffer (buffer, size);
+		if (++tideUpdateNum == 100)
+			tideUpdateNum = 0;
+		dialTickWake ();
+	}
 }
 
 /**********************************************************************************************************************
@@ -493,40 +486,15 @@ static void processBuffer (char *buffer, size_t size)
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Get the tide times using curl.
+ *  \brief Start reading the tide times, tideFetchDone is called when they are read.
  *  \result None.
  */
 void getTideTimes ()
 {
-	CURL *curlHandle;
-	struct MemoryStruct chunk;
-
-	chunk.memory = malloc(1);
-	chunk.size = 0;
-
-	curl_global_init(CURL_GLOBAL_ALL);
-	curlHandle = curl_easy_init();
-	curl_easy_setopt(curlHandle, CURLOPT_URL, &tideURL[0]);
-/*  curl_easy_setopt(curlHandle, CURLOPT_URL, "http://www.ukho.gov.uk/easytide/easytide/ShowPrediction.aspx?PortID=6400&PredictionLength=3"); */
-/*  curl_easy_setopt(curlHandle, CURLOPT_URL, "http://www.ukho.gov.uk/easytide/easytide/ShowPrediction.aspx?PortID=2679&PredictionLength=3"); */
-/*  curl_easy_setopt(curlHandle, CURLOPT_URL, "http://www.ukho.gov.uk/easytide/easytide/ShowPrediction.aspx?PortID=1570&PredictionLength=3"); */
-/*  curl_easy_setopt(curlHandle, CURLOPT_URL, "http://www.ukho.gov.uk/easytide/easytide/ShowPrediction.aspx?PortID=0108&PredictionLength=3"); */
-	curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, writeMemoryCallback);
-	curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, (void *)&chunk);
-	curl_easy_setopt(curlHandle, CURLOPT_USERAGENT, "libcurl-agent/1.0");
-	curl_easy_perform(curlHandle);
-	curl_easy_cleanup(curlHandle);
-
-	if (chunk.memory)
+	if (!tideFetching)
 	{
-		if (chunk.size)
-		{
-			memset (&tideInfo, 0, sizeof (tideInfo));
-			processBuffer (chunk.memory, chunk.size);
-		}
-		free(chunk.memory);
+		tideFetching = httpFetch (&tideURL[0], 0, tideFetchDone, NULL);
 	}
-	curl_global_cleanup();
 }
 
 /**********************************************************************************************************************
@@ -549,6 +517,22 @@ void readTideInit (void)
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T I D E  T I C K  P E R I O D                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a tide face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int tideTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return TIDE_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  T I D E  V A L U E S                                                                                     *
@@ -575,10 +559,12 @@ void readTideValues (int face)
 		{
 			;
 		}
-		else if (sysUpdateID % 60 != 0 && myUpdateID != -1)
+		else if (sysUpdateID % tideTickPeriod (faceSetting) != 0 && myUpdateID != -1 &&
+				faceSetting -> updateNum == tideUpdateNum)
 		{
 			return;
 		}
+		faceSetting -> updateNum = tideUpdateNum;
 		if (myUpdateID != sysUpdateID)
 		{
 			time_t now = time (NULL);
@@ -32,10 +32,13 @@
 #include "config.h"
 #include "GaugeDisp.h"
 
+#define WEATHER_TICKS 75
+
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
 extern DIAL_CONFIG dialConfig;
+extern int sysUpdateID;
 
 enum 
 {
@@ -101,17 +104,34 @@ pressureUnits[] =
 	{2, 28, 31, "inHg"}
 };
 
-struct MemoryStruct 
-{
-	char *memory;
-	size_t size;
-};
-
 char *weatherOBSURL = "https://weather-broker-cdn.api.bbci.co.uk/en/observation/rss/%s";
 char *weatherTFCURL = "https://weather-broker-cdn.api.bbci.co.uk/en/forecast/rss/3day/%s";
 //char *weatherOBSURL = "http://open.live.bbc.co.uk/weather/feeds/en/%s/observations.rss";
 //char *weatherTFCURL = "http://open.live.bbc.co.uk/weather/feeds/en/%s/3dayforecast.rss";
 int observations = 0;
+static int weatherFetching = 0;
+
+#define WEATHER_MAX_DEPTH	32
+#define WEATHER_TEXT_SIZE	2048
+#define WEATHER_ZIP_SIZE	4096
+
+typedef struct _weatherStream
+{
+	xmlParserCtxtPtr parser;
+	z_stream zStream;
+	int zipped;
+	int zDone;
+	char head[2];
+	int headLen;
+	int depth;
+	int levels[WEATHER_MAX_DEPTH];
+	char isItem[WEATHER_MAX_DEPTH];
+	char text[WEATHER_TEXT_SIZE];
+	int textLen;
+}
+WEATHER_STREAM;
+
+static WEATHER_STREAM weatherStream;
 extern char locationKey[];
 
 char *daysOfWeek[7] = 
@@ -317,47 +337,6 @@ void readWeatherInit(void)
 	}
 }
 
-/**********************************************************************************************************************
- *                                                                                                                    *
- *  W R I T E  M E M O R Y  C A L L B A C K                                                                           *
- *  =======================================                                                                           *
- *                                                                                                                    *
- **********************************************************************************************************************/
-/**
- *  \brief Called by curl to write memory in to a buffer.
- *  \param ptr Data to save.
- *  \param size Amount of data to save.
- *  \param nmemb number of elements.
- *  \param data Pointer to buffer.
- *  \result Amount we saved.
- */
-static size_t writeMemoryCallback(void *ptr, size_t size, size_t nmemb, void *data)
-{
-	size_t realsize = size * nmemb;
-	if (realsize)
-	{
-		struct MemoryStruct *mem = (struct MemoryStruct *)data;
-		/* char *text = (char *)ptr; */
-		/* printf ("[s:%d,n:%d,%02X,%02X,%02X,%02X]\n>>>%s<<<\n", */
-		/* size, nmemb, */
-		/* text[0] & 0xFF, text[1] & 0xFF, text[2] & 0xFF, text[3] & 0xFF, */
-		/* text); */
-		mem->memory = realloc(mem->memory, mem->size + realsize + 1);
-		if (mem->memory == NULL)
-		{
-			/*
-             * out of memory!
-             */
-			printf("not enough memory (realloc returned NULL)\n");
-			exit(EXIT_FAILURE);
-		}
-		memcpy(&(mem->memory[mem->size]), ptr, realsize);
-		mem->size += realsize;
-		mem->memory[mem->size] = 0;
-	}
-	return realsize;
-}
-
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  G E T  D A Y  O F  W E E K                                                                                        *
@@ -746,145 +725,229 @@ static void processWeatherKey(int readLevel, const char *name, char *value)
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  P R O C E S S  E L E M E N T  N A M E S                                                                           *
+ *  W E A T H E R  S T A R T  E L E M E N T                                                                           *
  *  =======================================                                                                           *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Process each of the elements in the file.
- *  \param doc Document to read.
- *  \param aNode Current node.
- *  \param readLevel 0 current, 1 today, 2 tomorrow.
+ *  \brief Called by libxml at the start of each element.
+ *  \param ctx Parser context.
+ *  \param localname Name of the element.
+ *  \param prefix Not used.
+ *  \param URI Not used.
+ *  \param nbNamespaces Not used.
+ *  \param namespaces Not used.
+ *  \param nbAttributes Not used.
+ *  \param nbDefaulted Not used.
+ *  \param attributes Not used.
  *  \result None.
  */
-static void processElementNames(xmlDoc * doc, xmlNode * aNode, int readLevel)
+static void weatherStartElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI,
+		int nbNamespaces, const xmlChar **namespaces, int nbAttributes, int nbDefaulted, const xmlChar **attributes)
 {
-	xmlChar *key;
-	xmlNode *curNode = NULL;
+	int depth = weatherStream.depth++;
 
-	for (curNode = aNode; curNode; curNode = curNode->next)
+	if (depth < WEATHER_MAX_DEPTH - 1)
 	{
-		if (curNode->type == XML_ELEMENT_NODE)
-		{
-			if ((!xmlStrcmp(curNode->name, (const xmlChar *)"item")))
-			{
-				++readLevel;
-			}
-			else
-			{
-				key = xmlNodeListGetString(doc, curNode->xmlChildrenNode, 1);
-				processWeatherKey(readLevel, (const char *)curNode->name, (char *)key);
-				xmlFree(key);
-			}
-		}
-		processElementNames(doc, curNode->children, readLevel);
+		/*--------------------------------------------------------------------------------------------*
+         * Each item bumps the level for itself and the elements that follow it.                      *
+         *--------------------------------------------------------------------------------------------*/
+		weatherStream.isItem[depth] = (xmlStrcmp(localname, (const xmlChar *)"item") == 0);
+		if (weatherStream.isItem[depth])
+			++weatherStream.levels[depth];
+		weatherStream.levels[depth + 1] = weatherStream.levels[depth];
 	}
+	weatherStream.textLen = 0;
+	weatherStream.text[0] = 0;
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  G Z I P  I N F L A T E                                                                                            *
- *  ======================                                                                                            *
+ *  W E A T H E R  E N D  E L E M E N T                                                                               *
+ *  ===================================                                                                               *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Inflate a compress buffer.
- *  \param compressedBytes Buffer to inflate.
- *  \param compressedSize Size of the input buffer.
- *  \param uncompressedBytes Save the inflated data here.
- *  \param uncompressedSize Size of the inflated beffer.
- *  \result Number of output bytes, 0 on error.
+ *  \brief Called by libxml at the end of each element, pass the value on.
+ *  \param ctx Parser context.
+ *  \param localname Name of the element.
+ *  \param prefix Not used.
+ *  \param URI Not used.
+ *  \result None.
  */
-int gzipInflate (Bytef *compressedBytes, int compressedSize, Bytef *uncompressedBytes, int uncompressedSize)
+static void weatherEndElement(void *ctx, const xmlChar *localname, const xmlChar *prefix, const xmlChar *URI)
 {
-	bool done = false;
-
-	z_stream strm;
-	strm.next_in = compressedBytes;
-	strm.avail_in = compressedSize;
-	strm.next_out = uncompressedBytes;
-	strm.avail_out = uncompressedSize;
-	strm.total_out = 0;
-	strm.zalloc = Z_NULL;
-	strm.zfree = Z_NULL;
-
-	if (inflateInit2 (&strm, (16 + MAX_WBITS)) != Z_OK)
-		return 0;
+	int depth = --weatherStream.depth;
+
+	if (depth < WEATHER_MAX_DEPTH - 1 && !weatherStream.isItem[depth])
+	{
+		processWeatherKey(weatherStream.levels[depth], (const char *)localname, weatherStream.text);
+	}
+	weatherStream.textLen = 0;
+	weatherStream.text[0] = 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W E A T H E R  C H A R A C T E R S                                                                                *
+ *  ==================================                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by libxml with the text inside an element.
+ *  \param ctx Parser context.
+ *  \param ch Text read.
+ *  \param len Length of the text.
+ *  \result None.
+ */
+static void weatherCharacters(void *ctx, const xmlChar *ch, int len)
+{
+	if (len > WEATHER_TEXT_SIZE - 1 - weatherStream.textLen)
+		len = WEATHER_TEXT_SIZE - 1 - weatherStream.textLen;
 
-	int err = inflate(&strm, Z_SYNC_FLUSH);
-	if (err == Z_STREAM_END)
-		done = true;
+	if (len > 0)
+	{
+		memcpy(&weatherStream.text[weatherStream.textLen], ch, len);
+		weatherStream.textLen += len;
+		weatherStream.text[weatherStream.textLen] = 0;
+	}
+}
 
-	if (inflateEnd(&strm) != Z_OK)
-		return 0;
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W E A T H E R  S T R E A M  S T A R T                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Get ready to parse a new page.
+ *  \result 1 if the parser was created.
+ */
+static int weatherStreamStart(void)
+{
+	static xmlSAXHandler weatherSAX;
+
+	if (weatherSAX.initialized != XML_SAX2_MAGIC)
+	{
+		memset(&weatherSAX, 0, sizeof(weatherSAX));
+		weatherSAX.initialized = XML_SAX2_MAGIC;
+		weatherSAX.startElementNs = weatherStartElement;
+		weatherSAX.endElementNs = weatherEndElement;
+		weatherSAX.characters = weatherCharacters;
+		weatherSAX.cdataBlock = weatherCharacters;
+	}
 
-	return (done ? strm.total_out : 0);
+	memset(&weatherStream, 0, sizeof(weatherStream));
+	weatherStream.parser = xmlCreatePushParserCtxt(&weatherSAX, NULL, NULL, 0, NULL);
+	return (weatherStream.parser != NULL);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  P R O C E S S  B U F F E R                                                                                        *
- *  ==========================                                                                                        *
+ *  W E A T H E R  S T R E A M  E N D                                                                                 *
+ *  =================================                                                                                 *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Process the down loaded buffer.
- *  \param buffer Buffer to process.
- *  \param size Size of the buffer.
+ *  \brief Finish the parse and free the parser.
+ *  \param complete The whole page was read.
  *  \result None.
  */
-static void processBuffer(char *buffer, size_t size)
+static void weatherStreamEnd(int complete)
 {
-	xmlDoc *doc = NULL;
-	xmlNode *rootElement = NULL;
-	xmlChar *xmlBuffer = NULL;
-
-/*  printf("Init: %0X:%0X %c%c\n", buffer[0], buffer[1],
-           buffer[0] > ' ' && buffer[0] < 127 ? buffer[0] : '-',
-           buffer[1] > ' ' && buffer[1] < 127 ? buffer[1] : '-');
-*/
-	if (size > 10 && buffer[0] == '\037' && buffer[1] == '\213')
+	if (weatherStream.parser)
 	{
-		int retn = 0;
-		char *tempBuff = (char *)malloc(8001);
-		if (tempBuff == NULL)
-			return;
+		if (complete)
+		{
+			xmlParseChunk(weatherStream.parser, NULL, 0, 1);
+			if (!weatherStream.parser->wellFormed)
+				printf ("error: could not parse weather feed\n");
+		}
+		xmlFreeParserCtxt(weatherStream.parser);
+		weatherStream.parser = NULL;
+	}
+	if (weatherStream.zipped)
+	{
+		inflateEnd(&weatherStream.zStream);
+		weatherStream.zipped = 0;
+	}
+}
 
-		if ((retn = gzipInflate ((Bytef *)buffer, size, (Bytef *)tempBuff, 8000)) == 0)
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W E A T H E R  W R I T E  C A L L B A C K                                                                         *
+ *  =========================================                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called as each block of the page is read, inflate it if needed and parse it.
+ *  \param data Not used.
+ *  \param buffer Block that was read.
+ *  \param size Size of the block.
+ *  \result 1 to keep reading, 0 to stop.
+ */
+static int weatherWriteCallback(void *data, char *buffer, size_t size)
+{
+	/*------------------------------------------------------------------------------------------------*
+     * Some servers send gzip without saying so, look at the first two bytes to find out.             *
+     *------------------------------------------------------------------------------------------------*/
+	if (weatherStream.headLen < 2)
+	{
+		while (weatherStream.headLen < 2 && size)
 		{
-			free(tempBuff);
-			return;
+			weatherStream.head[weatherStream.headLen++] = *buffer++;
+			--size;
 		}
-/*      printf("Unpk: %0X:%0X %c%c\n", (unsigned int)tempBuff[0], (unsigned int)tempBuff[1],
-               tempBuff[0] > ' ' && tempBuff[0] < 127 ? tempBuff[0] : '-',
-               tempBuff[1] > ' ' && tempBuff[1] < 127 ? tempBuff[1] : '-');
-*/
-		tempBuff[retn] = 0;
-		xmlBuffer = xmlCharStrndup(tempBuff, retn);
-		free(tempBuff);
+		if (weatherStream.headLen < 2)
+			return 1;
+
+		if (weatherStream.head[0] == '\037' && (unsigned char)weatherStream.head[1] == 0x8B)
+		{
+			if (inflateInit2(&weatherStream.zStream, (16 + MAX_WBITS)) != Z_OK)
+				return 0;
+			weatherStream.zipped = 1;
+		}
+		if (!weatherWriteCallback(data, weatherStream.head, 2))
+			return 0;
 	}
-	else
+	if (!weatherStream.zipped)
 	{
-		xmlBuffer = xmlCharStrndup(buffer, size);
+		return (xmlParseChunk(weatherStream.parser, buffer, size, 0) == 0);
 	}
-	if (xmlBuffer != NULL)
+	if (weatherStream.zDone)
 	{
-		doc = xmlParseDoc (xmlBuffer);
+		return 1;
+	}
+
+	weatherStream.zStream.next_in = (Bytef *)buffer;
+	weatherStream.zStream.avail_in = size;
+	do
+	{
+		char outBuffer[WEATHER_ZIP_SIZE];
+		int err;
+
+		weatherStream.zStream.next_out = (Bytef *)outBuffer;
+		weatherStream.zStream.avail_out = WEATHER_ZIP_SIZE;
 
-		if (doc != NULL)
+		err = inflate(&weatherStream.zStream, Z_NO_FLUSH);
+		if (err != Z_OK && err != Z_STREAM_END && err != Z_BUF_ERROR)
+			return 0;
+
+		if (WEATHER_ZIP_SIZE - weatherStream.zStream.avail_out)
 		{
-			rootElement = xmlDocGetRootElement (doc);
-			processElementNames (doc, rootElement, 0);
-			xmlFreeDoc (doc);
+			if (xmlParseChunk(weatherStream.parser, outBuffer, WEATHER_ZIP_SIZE - weatherStream.zStream.avail_out, 0))
+				return 0;
 		}
-		else
+		if (err == Z_STREAM_END)
 		{
-			printf ("error: could not parse memory\n");
-			printf ("BUFF[%lu] [[[%s]]]\n", size, buffer);
+			weatherStream.zDone = 1;
+			break;
 		}
-		xmlFree (xmlBuffer);
+		if (err == Z_BUF_ERROR)
+			break;
 	}
-	xmlCleanupParser();
+	while (weatherStream.zStream.avail_in || weatherStream.zStream.avail_out == 0);
+	return 1;
 }
 
 /**********************************************************************************************************************
@@ -930,6 +993,46 @@ static void fixupShowValues()
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W E A T H E R  F E T C H  D O N E                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called from the main loop when a weather page has been read.
+ *  \param data Not used.
+ *  \param buffer Not used, the page is parsed as it is read.
+ *  \param size Size of the page, 0 if it failed.
+ *  \result None.
+ */
+static void weatherFetchDone (void *data, char *buffer, size_t size)
+{
+	weatherFetching = 0;
+	weatherStreamEnd(size != 0);
+	dialTickWake();
+
+	if (observations == 0)
+	{
+		observations = 1;
+		return;
+	}
+	observations = 0;
+
+	if (myWeather.updateTime[0])
+	{
+		myWeather.nextUpdate = time(NULL) + (15 * 60);
+		if (++myWeather.updateNum == 100)
+			myWeather.updateNum = 0;
+
+		fixupShowValues();
+	}
+	else
+	{
+		myWeather.nextUpdate = time(NULL) + 15;
+	}
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  D O  U P D A T E  W E A T H E R  I N F O                                                                          *
@@ -939,47 +1042,30 @@ static void fixupShowValues()
 /**
  *  \brief Send a request for the weather at the current location.
  *  \param weatherURL Called for each for the pages to read.
- *  \result None.
+ *  \result 1 if the request was sent, weatherFetchDone is called when it is read.
  */
-void doUpdateWeatherInfo(char *weatherURL)
+int doUpdateWeatherInfo(char *weatherURL)
 {
-	CURL *curlHandle;
 	char fullURL[512], *encodedLoc;
-	struct MemoryStruct chunk;
 
-	chunk.memory = malloc(1);
-	chunk.size = 0;
-
-	curl_global_init(CURL_GLOBAL_ALL);
-	curlHandle = curl_easy_init();
+	/*------------------------------------------------------------------------------------------------*
+     * The handle is only used for character conversion, which none of our targets need.              *
+     *------------------------------------------------------------------------------------------------*/
+	if ((encodedLoc = curl_easy_escape(NULL, locationKey, 0)) == NULL)
+		return 0;
 
-	encodedLoc = curl_easy_escape(curlHandle, locationKey, 0);
-	sprintf(fullURL, weatherURL, encodedLoc);
+	snprintf(fullURL, 512, weatherURL, encodedLoc);
 	curl_free(encodedLoc);
 
-	curl_easy_setopt(curlHandle, CURLOPT_URL, fullURL);
-#ifdef CURLOPT_TRANSFER_ENCODING
-	curl_easy_setopt(curlHandle, CURLOPT_TRANSFER_ENCODING, 1);
-#endif
-#ifdef CURLOPT_ACCEPT_ENCODING
-	curl_easy_setopt(curlHandle, CURLOPT_ACCEPT_ENCODING, "gzip");
-#endif
-	curl_easy_setopt(curlHandle, CURLOPT_WRITEFUNCTION, writeMemoryCallback);
-	curl_easy_setopt(curlHandle, CURLOPT_WRITEDATA, (void *)&chunk);
-	curl_easy_setopt(curlHandle, CURLOPT_USERAGENT, "libcurl-agent/1.0");
-	curl_easy_perform(curlHandle);
-	curl_easy_cleanup(curlHandle);
-
-	if (chunk.size)
-	{
-		processBuffer(chunk.memory, chunk.size);
-	}
+	if (!weatherStreamStart())
+		return 0;
 
-	if (chunk.memory)
+	if (!httpStream(fullURL, 1, weatherWriteCallback, weatherFetchDone, NULL))
 	{
-		free(chunk.memory);
+		weatherStreamEnd(0);
+		return 0;
 	}
-	curl_global_cleanup();
+	return 1;
 }
 
 /**********************************************************************************************************************
@@ -994,26 +1080,13 @@ void doUpdateWeatherInfo(char *weatherURL)
  */
 void updateWeatherInfo()
 {
-	if (time(NULL) >= myWeather.nextUpdate)
+	if (!weatherFetching && time(NULL) >= myWeather.nextUpdate)
 	{
 		myWeather.updateTime[0] = 0;
 
-		if (observations == 0)
+		if (doUpdateWeatherInfo(observations == 0 ? weatherTFCURL : weatherOBSURL))
 		{
-			doUpdateWeatherInfo(weatherTFCURL);
-			observations = 1;
-			return;
-		}
-		doUpdateWeatherInfo(weatherOBSURL);
-		observations = 0;
-
-		if (myWeather.updateTime[0])
-		{
-			myWeather.nextUpdate = time(NULL) + (15 * 60);
-			if (++myWeather.updateNum == 100)
-				myWeather.updateNum = 0;
-
-			fixupShowValues();
+			weatherFetching = 1;
 		}
 		else
 		{
@@ -1093,6 +1166,22 @@ void showErrorMessage(char *message)
 	gtk_widget_destroy(dialog);
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W E A T H E R  T I C K  P E R I O D                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief How often a weather face reads, so the main loop can wake on the right ticks.
+ *  \param faceSetting Face to check.
+ *  \result Period in ticks.
+ */
+int weatherTickPeriod (FACE_SETTINGS *faceSetting)
+{
+	return WEATHER_TICKS;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  W E A T H E R  V A L U E S                                                                               *
@@ -1123,15 +1212,15 @@ void readWeatherValues(int face)
 		{
 			;
 		}
-		else if (faceSetting->nextUpdate > 0)
+		else if (sysUpdateID % weatherTickPeriod (faceSetting) != 0)
 		{
-			faceSetting->nextUpdate -= 1;
-			return;
+			/* A finished fetch wakes the loop, so pick up new values on any tick */
+			if (myWeather.updateNum == faceSetting->updateNum)
+				return;
 		}
-		else if (faceSetting->nextUpdate == 0)
+		else
 		{
 			updateWeatherInfo();
-			faceSetting->nextUpdate = 10;
 			if (myWeather.updateNum == faceSetting->updateNum)
 				return;
 		}
@@ -1603,6 +1692,7 @@ void weatherSettings(guint data)
 			weatherGaugeReset();
 			myWeather.updateNum = -1;
 			myWeather.nextUpdate = 0;
+			dialTickWake();
 		}
 	}
 	gtk_widget_destroy(dialog);
@@ -27,7 +27,6 @@
 extern FACE_SETTINGS *faceSettings[];
 extern GAUGE_ENABLED gaugeEnabled[];
 extern MENU_DESC gaugeMenuDesc[];
-extern int sysUpdateID;
 
 static char *findQualityStr = "Link Quality=";
 static char *findSignalStr = "Signal level=";
@@ -43,6 +42,9 @@ struct sReadInfo
 	char rateType[11];
 };
 
+static struct sReadInfo myWifiReading;
+static int wifiCollector = -1;
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  H U N T  F O R  Q U A L I T Y                                                                                     *
@@ -129,6 +131,22 @@ int readLinkQuality(struct sReadInfo *readInfo)
 	return retn;
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W I F I  S A M P L E                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the link quality, called on a worker thread.
+ *  \param snapshot Where to save the reading.
+ *  \result None.
+ */
+static void wifiSample (void *snapshot)
+{
+	readLinkQuality ((struct sReadInfo *)snapshot);
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  R E A D  W I F I  I N I T                                                                                         *
@@ -144,9 +162,14 @@ void readWifiInit (void)
 	if (gaugeEnabled[FACE_TYPE_WIFI].enabled)
 	{
 		struct sReadInfo readInfo;
+
+		memset (&readInfo, 0, sizeof (readInfo));
 		if (readLinkQuality (&readInfo))
 		{
 			gaugeMenuDesc[MENU_GAUGE_WIFI].disable = 0;
+			myWifiReading = readInfo;
+			collectorInit ();
+			wifiCollector = collectorRegister ("wifi", wifiSample, sizeof (struct sReadInfo), 2000);
 		}
 	}
 }
@@ -164,23 +187,19 @@ void readWifiInit (void)
  */
 void readWifiValues (int face)
 {
-	int update = 0;
-
 	if (gaugeEnabled[FACE_TYPE_MOONPHASE].enabled)
 	{
 		struct sReadInfo readInfo;
 		FACE_SETTINGS *faceSetting = faceSettings[face];
+		int updateNum;
 
-		if (faceSetting -> faceFlags & FACE_REDRAW)
-		{
-			faceSetting -> nextUpdate = 5;
-			update = 1;
-		}
-		if (!update && sysUpdateID % 10 != 0)
+		updateNum = collectorRead (wifiCollector, &myWifiReading);
+		if (!(faceSetting -> faceFlags & FACE_REDRAW) && updateNum == faceSetting -> updateNum)
 		{
 			return;
 		}
-		readLinkQuality (&readInfo);
+		faceSetting -> updateNum = updateNum;
+		readInfo = myWifiReading;
 		setFaceString (faceSetting, FACESTR_TOP, 0, _("Wifi\nQuality"));
 		setFaceString (faceSetting, FACESTR_WIN, 0, _("Wifi - Gauge"));
 		setFaceString (faceSetting, FACESTR_BOT, 0, _("%0.1f%%"), readInfo.quality);
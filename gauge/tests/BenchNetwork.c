@@ -0,0 +1,181 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  N E T W O R K . C                                                                                      *
+ *  ============================                                                                                      *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Time reading the network counters from /proc/net/dev and over netlink for 10 to 1000 links.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "GaugeNetwork.c"
+#include "GaugeTest.h"
+#include "NetworkReplay.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * Enough reads are made for each backend to cover about this many links. The netlink replay is       *
+ * answered by another process, so it costs a dump's copy and wake up but not the kernel's own walk.  *
+ *----------------------------------------------------------------------------------------------------*/
+#define BENCH_LINKS		500000
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  R E A D                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Time reads of the links with one of the backends.
+ *  \param netlink True to read over netlink, false to read the file.
+ *  \param count Number of links expected on each read.
+ *  \param reads Number of reads to time.
+ *  \result Milliseconds for each read.
+ */
+static double benchRead (bool netlink, int count, int reads)
+{
+	double startTime;
+	int i, wrongCount = 0;
+
+	++deviceSeenID;
+	if ((netlink ? readNetlinkDevices (0, 0) : readProcDevices (0, 0)) != count)
+		++wrongCount;
+
+	startTime = testTimeNow ();
+	for (i = 0; i < reads; ++i)
+	{
+		++deviceSeenID;
+		if ((netlink ? readNetlinkDevices (1, 0) : readProcDevices (1, 0)) != count)
+			++wrongCount;
+	}
+	TEST_CHECK (wrongCount == 0);
+	return (testTimeNow () - startTime) * 1000 / reads;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  R E P L A Y                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Time both backends reading the same replayed links.
+ *  \param count Number of links to replay.
+ *  \result None.
+ */
+static void benchReplay (int count)
+{
+	char procName[] = "/tmp/benchNetworkXXXXXX";
+	double procTime, linkTime;
+	REPLAY_DEVICE *devices;
+	int reads = BENCH_LINKS / count;
+
+	if ((devices = replayMakeDevices (count)) == NULL)
+		return;
+	if (!replayWriteProc (devices, count, procName))
+	{
+		TEST_CHECK (!"could not write the replay file");
+		free (devices);
+		return;
+	}
+	if (devStatsFile != -1)
+		close (devStatsFile);
+	devStatsFile = -1;
+	deviceStats = procName;
+	if ((netlinkSock = replayStartNetlink (devices, count)) == -1)
+	{
+		TEST_CHECK (!"could not start the netlink replay");
+	}
+	else
+	{
+		procTime = benchRead (false, count, reads);
+		linkTime = benchRead (true, count, reads);
+		printf ("%5d  %10.4f ms  %10.4f ms  %6.2fx\n", count, procTime, linkTime, procTime / linkTime);
+		replayStopNetlink (netlinkSock);
+		netlinkSock = -1;
+	}
+	unlink (procName);
+	free (devices);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  L I V E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Time both backends reading the links on this machine, if netlink can be used here.
+ *  \result None.
+ */
+static void benchLive (void)
+{
+	double procTime, linkTime;
+	int count;
+
+	if ((netlinkSock = netlinkOpen (0)) == -1)
+	{
+		printf ("no netlink here, this machine's links were not timed\n");
+		return;
+	}
+	if (devStatsFile != -1)
+		close (devStatsFile);
+	devStatsFile = -1;
+	deviceStats = "/proc/net/dev";
+
+	++deviceSeenID;
+	if ((count = readProcDevices (0, 0)) > 0)
+	{
+		procTime = benchRead (false, count, BENCH_LINKS / count);
+		linkTime = benchRead (true, count, BENCH_LINKS / count);
+		printf ("%5d  %10.4f ms  %10.4f ms  %6.2fx  (this machine)\n", count, procTime, linkTime, procTime / linkTime);
+	}
+	close (netlinkSock);
+	netlinkSock = -1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Time the backends for 10, 100 and 1000 replayed links, then the links on this machine.
+ *  \result 0 if all the reads saw the links expected.
+ */
+int main (void)
+{
+	static const int linkCounts[] = { 10, 100, 1000, 0 };
+	int i;
+
+	/*------------------------------------------------------------------------------------------------*
+     * The first read makes the table and buffer, an empty file gives it nothing to add               *
+     *------------------------------------------------------------------------------------------------*/
+	deviceStats = "/dev/null";
+	readDeviceValues (0);
+
+	printf ("links  /proc/net/dev   netlink       speed up\n");
+	for (i = 0; linkCounts[i]; ++i)
+		benchReplay (linkCounts[i]);
+	benchLive ();
+
+	return testResult ("benchNetwork");
+}
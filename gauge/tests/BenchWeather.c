@@ -0,0 +1,334 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  W E A T H E R . C                                                                                      *
+ *  ============================                                                                                      *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Time the weather feed parse and measure its peak memory for feeds from 1 kB to 1 MB.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <libxml/parser.h>
+#include <libxml/tree.h>
+
+#include "config.h"
+#include "GaugeDisp.h"
+#include "GaugeTest.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * Blocks are replayed at curl's default buffer size, enough runs are made to parse about 16 MB       *
+ *----------------------------------------------------------------------------------------------------*/
+#define REPLAY_BLOCK	16384
+#define BENCH_BYTES		(16 * 1024 * 1024)
+
+typedef struct _oldMemory
+{
+	char *memory;
+	size_t size;
+}
+OLD_MEMORY;
+
+extern int observations;
+int doUpdateWeatherInfo (char *weatherURL);
+
+static const char *replayBuffer = NULL;
+static size_t replaySize = 0;
+static int oldElementCount = 0;
+static int streamFailed = 0;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  H T T P  S T R E A M                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Stands in for the fetcher, the feed is passed to the write function a block at a time.
+ *  \param url Not used.
+ *  \param gzip Not used.
+ *  \param writeFunc Passed each block, return 0 to stop.
+ *  \param doneFunc Called with a NULL buffer and the number of bytes passed, 0 if it was stopped.
+ *  \param data Passed to writeFunc and doneFunc.
+ *  \result 1, the feed has been read by the time this returns.
+ */
+int httpStream (char *url, int gzip, HTTP_WRITE writeFunc, HTTP_DONE doneFunc, void *data)
+{
+	size_t done = 0;
+
+	while (done < replaySize)
+	{
+		size_t block = replaySize - done > REPLAY_BLOCK ? REPLAY_BLOCK : replaySize - done;
+
+		if (!writeFunc (data, (char *)&replayBuffer[done], block))
+		{
+			++streamFailed;
+			doneFunc (data, NULL, 0);
+			return 1;
+		}
+		done += block;
+	}
+	doneFunc (data, NULL, done);
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A K E  F E E D                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make an observation feed of about the size asked for by repeating the item in the fixture.
+ *  \param fixture The observation fixture.
+ *  \param wantSize Size of feed wanted.
+ *  \param size Save the size made here.
+ *  \result The feed, free when done, or NULL if it could not be made.
+ */
+static char *makeFeed (const char *fixture, size_t wantSize, size_t *size)
+{
+	const char *itemStart = strstr (fixture, "    <item>");
+	const char *itemEnd = strstr (fixture, "</item>\n");
+	size_t headLen, itemLen, tailLen, used;
+	char *feed;
+
+	if (itemStart == NULL || itemEnd == NULL)
+		return NULL;
+
+	headLen = itemStart - fixture;
+	itemEnd += 8;
+	itemLen = itemEnd - itemStart;
+	tailLen = strlen (itemEnd);
+
+	if ((feed = malloc (wantSize + headLen + itemLen + tailLen + 1)) == NULL)
+		return NULL;
+
+	memcpy (feed, fixture, headLen);
+	used = headLen;
+	do
+	{
+		memcpy (&feed[used], itemStart, itemLen);
+		used += itemLen;
+	}
+	while (used + itemLen + tailLen <= wantSize);
+	strcpy (&feed[used], itemEnd);
+	*size = used + tailLen;
+	return feed;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  W R I T E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief A copy of the old curl write function, the whole feed is grown a block at a time.
+ *  \param data The memory to save in to.
+ *  \param buffer Block that was read.
+ *  \param size Size of the block.
+ *  \result 1 to keep reading, 0 if out of memory.
+ */
+static int oldWrite (void *data, char *buffer, size_t size)
+{
+	OLD_MEMORY *mem = (OLD_MEMORY *)data;
+
+	if ((mem -> memory = realloc (mem -> memory, mem -> size + size + 1)) == NULL)
+		return 0;
+	memcpy (&mem -> memory[mem -> size], buffer, size);
+	mem -> size += size;
+	mem -> memory[mem -> size] = 0;
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  E L E M E N T S                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Walk the tree like the old parse did, reading the text of every element.
+ *  \param node First node at this level.
+ *  \result None.
+ */
+static void oldElements (xmlNode *node)
+{
+	for (; node != NULL; node = node -> next)
+	{
+		if (node -> type == XML_ELEMENT_NODE)
+		{
+			xmlChar *value = xmlNodeGetContent (node);
+
+			++oldElementCount;
+			xmlFree (value);
+			oldElements (node -> children);
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  P A R S E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief A copy of the old parse, collect the feed then copy it and build a tree.
+ *  \result None.
+ */
+static void oldParse (void)
+{
+	OLD_MEMORY mem = { NULL, 0 };
+	size_t done = 0;
+	xmlChar *xmlBuffer;
+
+	while (done < replaySize)
+	{
+		size_t block = replaySize - done > REPLAY_BLOCK ? REPLAY_BLOCK : replaySize - done;
+
+		if (!oldWrite (&mem, (char *)&replayBuffer[done], block))
+			return;
+		done += block;
+	}
+	if ((xmlBuffer = xmlCharStrndup (mem.memory, mem.size)) != NULL)
+	{
+		xmlDoc *doc = xmlParseDoc (xmlBuffer);
+
+		if (doc != NULL)
+		{
+			oldElements (xmlDocGetRootElement (doc));
+			xmlFreeDoc (doc);
+		}
+		xmlFree (xmlBuffer);
+	}
+	free (mem.memory);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S T R E A M  P A R S E                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Parse the feed through the weather gauge as it is streamed.
+ *  \result None.
+ */
+static void streamParse (void)
+{
+	observations = 1;
+	doUpdateWeatherInfo ("http://localhost/%s");
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  P A R S E                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Time a parse and measure how far above the memory already in use it peaks.
+ *  \param parseFunc The parse to run.
+ *  \param feed Feed to parse.
+ *  \param size Size of the feed.
+ *  \param peak Save the peak memory over the start in kB here, -1 if it could not be measured.
+ *  \result Time for one parse in milli-seconds.
+ */
+static double benchParse (void (*parseFunc) (void), const char *feed, size_t size, long *peak)
+{
+	int i, runs = BENCH_BYTES / size + 1;
+	long before;
+	double start;
+
+	replayBuffer = feed;
+	replaySize = size;
+	*peak = -1;
+
+	/*------------------------------------------------------------------------------------------------*
+     * One run first so memory libxml keeps between parses is not counted                             *
+     *------------------------------------------------------------------------------------------------*/
+	parseFunc ();
+	if (testResetPeak ())
+	{
+		before = testPeakMemory ();
+		parseFunc ();
+		*peak = testPeakMemory () - before;
+	}
+	start = testTimeNow ();
+	for (i = 0; i < runs; ++i)
+		parseFunc ();
+
+	return (testTimeNow () - start) * 1000 / runs;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make feeds of each size and time the old and streamed parse on them.
+ *  \result 0 if every feed was parsed.
+ */
+int main (void)
+{
+	static const size_t wantSizes[] = { 1024, 10 * 1024, 100 * 1024, 1024 * 1024, 0 };
+	size_t fixtureSize, feedSize, zipSize;
+	char *fixture, *feed;
+	unsigned char *zipFeed;
+	int i;
+
+	if ((fixture = testReadFixture ("bbc-observation.xml", &fixtureSize)) == NULL)
+		return 1;
+
+	xmlInitParser ();
+	printf ("feed size        old parse           stream              stream gzip\n");
+	for (i = 0; wantSizes[i]; ++i)
+	{
+		double oldTime, streamTime, zipTime;
+		long oldPeak, streamPeak, zipPeak;
+		int expectElements;
+
+		if ((feed = makeFeed (fixture, wantSizes[i], &feedSize)) == NULL)
+			break;
+		if ((zipFeed = testGzip (feed, feedSize, &zipSize)) == NULL)
+		{
+			free (feed);
+			break;
+		}
+		oldElementCount = 0;
+		oldTime = benchParse (oldParse, feed, feedSize, &oldPeak);
+		expectElements = oldElementCount;
+		streamFailed = 0;
+		streamTime = benchParse (streamParse, feed, feedSize, &streamPeak);
+		zipTime = benchParse (streamParse, (char *)zipFeed, zipSize, &zipPeak);
+		TEST_CHECK (expectElements > 0);
+		TEST_CHECK (streamFailed == 0);
+
+		printf ("%8lu B  %8.3f ms %6ld kB  %8.3f ms %6ld kB  %8.3f ms %6ld kB\n", (unsigned long)feedSize,
+				oldTime, oldPeak, streamTime, streamPeak, zipTime, zipPeak);
+		free (zipFeed);
+		free (feed);
+	}
+	TEST_CHECK (wantSizes[i] == 0);
+
+	xmlCleanupParser ();
+	free (fixture);
+	return testResult ("benchWeather");
+}
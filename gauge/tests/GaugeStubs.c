@@ -0,0 +1,95 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  G A U G E  S T U B S . C                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Stand in for the parts of Gauge.c the gauge modules use, so a module can be built on its own for a check or benchmark.
+ */
+#include "config.h"
+#include "GaugeDisp.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * The globals the modules share with Gauge.c, left at their defaults                                 *
+ *----------------------------------------------------------------------------------------------------*/
+DIAL_CONFIG dialConfig;
+FACE_SETTINGS *faceSettings[MAX_FACES];
+GAUGE_ENABLED gaugeEnabled[FACE_TYPE_MAX + 1];
+MENU_DESC gaugeMenuDesc[MENU_GAUGE_WIFI + 2];
+unsigned int weatherScales;
+char locationKey[41] = "2643743";
+int sysUpdateID = 100;
+MENU_DESC networkDevDesc[17];
+char networkInclude[101] = "";
+char networkExclude[101] = "";
+bool networkNetlink = false;
+int rateSmoothing = 0;
+MENU_DESC spaceMenuDesc[11];
+MENU_DESC diskMenuDesc[17];
+bool diskPartitions = false;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A X  M I N  R E S E T                                                                                           *
+ *  =======================                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Nothing to reset, there are no faces.
+ *  \param savedMaxMin Not used.
+ *  \param count Not used.
+ *  \param interval Not used.
+ *  \result None.
+ */
+void maxMinReset (SAVED_MAX_MIN *savedMaxMin, int count, int interval)
+{
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S E T  F A C E  S T R I N G                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Nothing to show, there are no faces.
+ *  \param faceSetting Not used.
+ *  \param str Not used.
+ *  \param shorten Not used.
+ *  \param format Not used.
+ *  \result None.
+ */
+void setFaceString (FACE_SETTINGS *faceSetting, int str, int shorten, char *format, ...)
+{
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W R A P  T E X T                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief No need to wrap, nothing is shown.
+ *  \param inText Text to wrap.
+ *  \param top Not used.
+ *  \result The text as it was.
+ */
+char *wrapText (char *inText, char top)
+{
+	return inText;
+}
@@ -0,0 +1,246 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  G A U G E  T E S T . C                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Small helpers shared by the gauge check and benchmark programs.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <zlib.h>
+#include "GaugeTest.h"
+
+static int testFailed = 0;
+static int testPassed = 0;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  C H E C K                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Count a check and say where it failed.
+ *  \param passed True if the check passed.
+ *  \param testText The check as it was written.
+ *  \param fileName File the check is in.
+ *  \param line Line the check is on.
+ *  \result None.
+ */
+void testCheck (int passed, const char *testText, const char *fileName, int line)
+{
+	if (passed)
+	{
+		++testPassed;
+	}
+	else
+	{
+		fprintf (stderr, "%s:%d: check failed: %s\n", fileName, line, testText);
+		++testFailed;
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  T I M E  N O W                                                                                           *
+ *  =======================                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the monotonic clock for timing the benchmarks.
+ *  \result The time in seconds.
+ */
+double testTimeNow (void)
+{
+	struct timespec now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1000000000.0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  R E S U L T                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Print how the checks went.
+ *  \param testName Name of the program.
+ *  \result Exit status for make check, 0 if all the checks passed.
+ */
+int testResult (const char *testName)
+{
+	printf ("%s: %d passed, %d failed\n", testName, testPassed, testFailed);
+	return testFailed ? 1 : 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  F I X T U R E  P A T H                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make the path to a fixture, make check sets srcdir when building out of the source tree.
+ *  \param fileName Name of the fixture.
+ *  \param filePath Save the path here.
+ *  \param maxLen Size of the path buffer.
+ *  \result The path.
+ */
+char *testFixturePath (const char *fileName, char *filePath, int maxLen)
+{
+	const char *srcDir = getenv ("srcdir");
+
+	snprintf (filePath, maxLen, "%s/tests/fixtures/%s", srcDir != NULL ? srcDir : ".", fileName);
+	return filePath;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  R E A D  F I X T U R E                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read a whole fixture in to memory, it is followed by a zero.
+ *  \param fileName Name of the fixture.
+ *  \param size Save the size here.
+ *  \result The contents, free when done, or NULL if it could not be read.
+ */
+char *testReadFixture (const char *fileName, size_t *size)
+{
+	char filePath[1024], *buffer;
+	FILE *inFile;
+	long fileSize;
+
+	if ((inFile = fopen (testFixturePath (fileName, filePath, 1024), "rb")) == NULL)
+	{
+		fprintf (stderr, "missing fixture: %s\n", filePath);
+		return NULL;
+	}
+	fseek (inFile, 0, SEEK_END);
+	fileSize = ftell (inFile);
+	fseek (inFile, 0, SEEK_SET);
+
+	if (fileSize < 0 || (buffer = malloc (fileSize + 1)) == NULL)
+	{
+		fclose (inFile);
+		return NULL;
+	}
+	*size = fread (buffer, 1, fileSize, inFile);
+	buffer[*size] = 0;
+	fclose (inFile);
+	return buffer;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  P E A K  M E M O R Y                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the peak resident size of the program so far.
+ *  \result Peak size in kB, 0 if it is not known.
+ */
+long testPeakMemory (void)
+{
+	char readBuff[256];
+	long peak = 0;
+	FILE *inFile;
+
+	if ((inFile = fopen ("/proc/self/status", "r")) == NULL)
+		return 0;
+
+	while (fgets (readBuff, 256, inFile))
+	{
+		if (strncmp (readBuff, "VmHWM:", 6) == 0)
+		{
+			peak = atol (&readBuff[6]);
+			break;
+		}
+	}
+	fclose (inFile);
+	return peak;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  R E S E T  P E A K                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Start a new peak resident size from what is in use now, so each run can be measured on its own.
+ *  \result 1 if it was reset, 0 if the kernel does not allow it.
+ */
+int testResetPeak (void)
+{
+	FILE *outFile;
+
+	if ((outFile = fopen ("/proc/self/clear_refs", "w")) == NULL)
+		return 0;
+
+	fputs ("5", outFile);
+	return fclose (outFile) == 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  G Z I P                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Compress a page the way a web server does for Accept-Encoding: gzip.
+ *  \param buffer Page to compress.
+ *  \param size Size of the page.
+ *  \param outSize Save the compressed size here.
+ *  \result The compressed page, free when done, or NULL if it failed.
+ */
+unsigned char *testGzip (const char *buffer, size_t size, size_t *outSize)
+{
+	unsigned char *outBuffer;
+	z_stream stream;
+
+	memset (&stream, 0, sizeof (stream));
+	if (deflateInit2 (&stream, Z_DEFAULT_COMPRESSION, Z_DEFLATED, 16 + MAX_WBITS, 8, Z_DEFAULT_STRATEGY) != Z_OK)
+		return NULL;
+
+	if ((outBuffer = malloc (deflateBound (&stream, size))) != NULL)
+	{
+		stream.next_in = (unsigned char *)buffer;
+		stream.avail_in = size;
+		stream.next_out = outBuffer;
+		stream.avail_out = deflateBound (&stream, size);
+		if (deflate (&stream, Z_FINISH) == Z_STREAM_END)
+		{
+			*outSize = stream.total_out;
+		}
+		else
+		{
+			free (outBuffer);
+			outBuffer = NULL;
+		}
+	}
+	deflateEnd (&stream);
+	return outBuffer;
+}
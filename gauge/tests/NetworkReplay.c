@@ -0,0 +1,304 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  N E T W O R K  R E P L A Y . C                                                                                    *
+ *  ==============================                                                                                    *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Make the same set of network counters look like /proc/net/dev and an rtnetlink dump.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <sys/wait.h>
+#include <linux/netlink.h>
+#include <linux/rtnetlink.h>
+#include <linux/if_link.h>
+
+#include "NetworkReplay.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * The kernel sends a dump as several reads of whole messages, about this size each                   *
+ *----------------------------------------------------------------------------------------------------*/
+#define REPLAY_CHUNK	16384
+
+static pid_t replayChild = -1;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E P L A Y  M A K E  D E V I C E S                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make a table of devices with counters well past 32 bits, so a short read would be seen.
+ *  \param count Number of devices to make.
+ *  \result The devices, free when done, or NULL if out of memory.
+ */
+REPLAY_DEVICE *replayMakeDevices (int count)
+{
+	REPLAY_DEVICE *devices;
+	int i;
+
+	if ((devices = calloc (count, sizeof (REPLAY_DEVICE))) == NULL)
+		return NULL;
+
+	for (i = 0; i < count; ++i)
+	{
+		snprintf (devices[i].name, 16, "bench%d", i);
+		devices[i].readBytes = ((unsigned long long)(i % 7 + 1) << 32) + (unsigned long long)i * 1000003;
+		devices[i].writeBytes = ((unsigned long long)(i % 5 + 1) << 33) + (unsigned long long)i * 999983;
+	}
+	return devices;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E P L A Y  W R I T E  P R O C                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Write the devices out in the layout the kernel uses for /proc/net/dev.
+ *  \param devices Devices to write.
+ *  \param count Number of devices.
+ *  \param fileName A mkstemp template, the name made is saved back in it.
+ *  \result 1 if the file was written, 0 on error.
+ */
+int replayWriteProc (REPLAY_DEVICE *devices, int count, char *fileName)
+{
+	FILE *outFile;
+	int i, fd;
+
+	if ((fd = mkstemp (fileName)) == -1)
+		return 0;
+	if ((outFile = fdopen (fd, "w")) == NULL)
+	{
+		close (fd);
+		unlink (fileName);
+		return 0;
+	}
+
+	fprintf (outFile, "Inter-|   Receive                                                |  Transmit\n");
+	fprintf (outFile, " face |bytes    packets errs drop fifo frame compressed multicast|bytes    packets errs "
+			"drop fifo colls carrier compressed\n");
+	for (i = 0; i < count; ++i)
+	{
+		fprintf (outFile, "%6s:%8llu %7llu %4llu %4llu %4llu %5llu %10llu %9llu %8llu %7llu %4llu %4llu %4llu "
+				"%5llu %7llu %10llu\n", devices[i].name, devices[i].readBytes, devices[i].readBytes / 1500,
+				0ULL, 0ULL, 0ULL, 0ULL, 0ULL, 0ULL, devices[i].writeBytes, devices[i].writeBytes / 1500,
+				0ULL, 0ULL, 0ULL, 0ULL, 0ULL, 0ULL);
+	}
+	if (fclose (outFile) != 0)
+	{
+		unlink (fileName);
+		return 0;
+	}
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E P L A Y  A D D  A T T R                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Add an attribute to the end of a message.
+ *  \param nlh Message to add to, there must be room.
+ *  \param type Type of attribute.
+ *  \param data Contents of the attribute.
+ *  \param size Size of the contents.
+ *  \result None.
+ */
+static void replayAddAttr (struct nlmsghdr *nlh, int type, const void *data, int size)
+{
+	struct rtattr *rta = (struct rtattr *)((char *)nlh + NLMSG_ALIGN (nlh -> nlmsg_len));
+
+	rta -> rta_type = type;
+	rta -> rta_len = RTA_LENGTH (size);
+	memcpy (RTA_DATA (rta), data, size);
+	nlh -> nlmsg_len = NLMSG_ALIGN (nlh -> nlmsg_len) + RTA_ALIGN (rta -> rta_len);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E P L A Y  M A K E  D U M P                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make the RTM_NEWLINK messages the kernel would send for the devices, stats in the same order.
+ *  \param devices Devices to dump.
+ *  \param count Number of devices.
+ *  \param size Save the size of the dump here.
+ *  \result The messages, free when done, or NULL if out of memory.
+ */
+static char *replayMakeDump (REPLAY_DEVICE *devices, int count, size_t *size)
+{
+	size_t msgSize = NLMSG_SPACE (sizeof (struct ifinfomsg)) + RTA_SPACE (16) +
+			RTA_SPACE (sizeof (struct rtnl_link_stats64)) + RTA_SPACE (sizeof (struct rtnl_link_stats));
+	char *dump;
+	int i;
+
+	if ((dump = calloc (count, msgSize)) == NULL)
+		return NULL;
+
+	*size = 0;
+	for (i = 0; i < count; ++i)
+	{
+		struct nlmsghdr *nlh = (struct nlmsghdr *)&dump[*size];
+		struct ifinfomsg *ifi = NLMSG_DATA (nlh);
+		struct rtnl_link_stats64 stats64;
+		struct rtnl_link_stats stats;
+
+		nlh -> nlmsg_len = NLMSG_LENGTH (sizeof (struct ifinfomsg));
+		nlh -> nlmsg_type = RTM_NEWLINK;
+		nlh -> nlmsg_flags = NLM_F_MULTI;
+		ifi -> ifi_family = AF_UNSPEC;
+		ifi -> ifi_index = i + 1;
+		replayAddAttr (nlh, IFLA_IFNAME, devices[i].name, strlen (devices[i].name) + 1);
+
+		/*--------------------------------------------------------------------------------------------*
+         * The old stats are cut to 32 bits, as the kernel does, so using them would show             *
+         *--------------------------------------------------------------------------------------------*/
+		memset (&stats64, 0, sizeof (stats64));
+		stats64.rx_bytes = devices[i].readBytes;
+		stats64.tx_bytes = devices[i].writeBytes;
+		replayAddAttr (nlh, IFLA_STATS64, &stats64, sizeof (stats64));
+		memset (&stats, 0, sizeof (stats));
+		stats.rx_bytes = (__u32)devices[i].readBytes;
+		stats.tx_bytes = (__u32)devices[i].writeBytes;
+		replayAddAttr (nlh, IFLA_STATS, &stats, sizeof (stats));
+
+		*size += NLMSG_ALIGN (nlh -> nlmsg_len);
+	}
+	return dump;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E P L A Y  A N S W E R                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Stands in for the kernel, each dump request is answered with the same links until the socket is closed.
+ *  \param sock Our end of the socket pair.
+ *  \param dump The messages to send.
+ *  \param size Size of the messages.
+ *  \result None, does not return.
+ */
+static void replayAnswer (int sock, char *dump, size_t size)
+{
+	struct nlmsghdr request, done;
+	size_t sent, chunk;
+
+	while (recv (sock, &request, sizeof (request), 0) > 0)
+	{
+		struct nlmsghdr *nlh;
+		int left = size;
+
+		for (nlh = (struct nlmsghdr *)dump; NLMSG_OK (nlh, left); nlh = NLMSG_NEXT (nlh, left))
+			nlh -> nlmsg_seq = request.nlmsg_seq;
+
+		for (sent = 0; sent < size; sent += chunk)
+		{
+			chunk = 0;
+			nlh = (struct nlmsghdr *)&dump[sent];
+			while (sent + chunk < size && chunk + NLMSG_ALIGN (nlh -> nlmsg_len) <= REPLAY_CHUNK)
+			{
+				chunk += NLMSG_ALIGN (nlh -> nlmsg_len);
+				nlh = (struct nlmsghdr *)&dump[sent + chunk];
+			}
+			if (send (sock, &dump[sent], chunk, 0) < 0)
+				_exit (1);
+		}
+
+		memset (&done, 0, sizeof (done));
+		done.nlmsg_len = sizeof (done);
+		done.nlmsg_type = NLMSG_DONE;
+		done.nlmsg_flags = NLM_F_MULTI;
+		done.nlmsg_seq = request.nlmsg_seq;
+		if (send (sock, &done, sizeof (done), 0) < 0)
+			_exit (1);
+	}
+	_exit (0);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E P L A Y  S T A R T  N E T L I N K                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Start a process that answers link dumps for the devices, as the kernel would.
+ *  \param devices Devices to dump.
+ *  \param count Number of devices.
+ *  \result A socket to use in place of the netlink socket, -1 on error.
+ */
+int replayStartNetlink (REPLAY_DEVICE *devices, int count)
+{
+	int socks[2];
+	size_t size;
+	char *dump;
+
+	if ((dump = replayMakeDump (devices, count, &size)) == NULL)
+		return -1;
+	if (socketpair (AF_UNIX, SOCK_SEQPACKET, 0, socks) == -1)
+	{
+		free (dump);
+		return -1;
+	}
+	fflush (stdout);
+	if ((replayChild = fork ()) == 0)
+	{
+		close (socks[0]);
+		replayAnswer (socks[1], dump, size);
+	}
+	free (dump);
+	close (socks[1]);
+	if (replayChild == -1)
+	{
+		close (socks[0]);
+		return -1;
+	}
+	return socks[0];
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E P L A Y  S T O P  N E T L I N K                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Close the socket and wait for the process answering it to finish.
+ *  \param sock Socket from replayStartNetlink.
+ *  \result None.
+ */
+void replayStopNetlink (int sock)
+{
+	close (sock);
+	if (replayChild != -1)
+	{
+		waitpid (replayChild, NULL, 0);
+		replayChild = -1;
+	}
+}
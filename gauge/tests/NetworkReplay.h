@@ -0,0 +1,39 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  N E T W O R K  R E P L A Y . H                                                                                    *
+ *  ==============================                                                                                    *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Make the same set of network counters look like /proc/net/dev and an rtnetlink dump.
+ */
+#ifndef INCLUDE_NETWORKREPLAY_H
+#define INCLUDE_NETWORKREPLAY_H
+
+typedef struct _replayDevice
+{
+	char name[16];
+	unsigned long long readBytes;
+	unsigned long long writeBytes;
+}
+REPLAY_DEVICE;
+
+REPLAY_DEVICE *replayMakeDevices (int count);
+int replayWriteProc (REPLAY_DEVICE *devices, int count, char *fileName);
+int replayStartNetlink (REPLAY_DEVICE *devices, int count);
+void replayStopNetlink (int sock);
+
+#endif
@@ -0,0 +1,223 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  H A R D D I S K . C                                                                                      *
+ *  ============================                                                                                      *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Check /proc/diskstats is read and the devices sorted out, using saved copies of the file.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <math.h>
+
+#include "config.h"
+#include "GaugeHarddisk.c"
+#include "GaugeTest.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * The module is built in to the check so its file names can be pointed at the fixtures               *
+ *----------------------------------------------------------------------------------------------------*/
+typedef struct _diskKindCheck
+{
+	char *name;
+	int diskKind;
+}
+DISK_KIND_CHECK;
+
+static DISK_KIND_CHECK diskKindChecks[] =
+{
+	{	"loop0",		DISK_IGNORE		},
+	{	"ram0",			DISK_IGNORE		},
+	{	"sda",			DISK_WHOLE		},
+	{	"sda1",			DISK_PART		},
+	{	"sda2",			DISK_PART		},
+	{	"sdb",			DISK_WHOLE		},
+	{	"sdc",			DISK_WHOLE		},
+	{	"sdd",			DISK_WHOLE		},
+	{	"sdd1",			DISK_PART		},
+	{	"nvme0n1",		DISK_WHOLE		},
+	{	"nvme0n1p1",	DISK_PART		},
+	{	"nvme0n1p2",	DISK_PART		},
+	{	"mmcblk0",		DISK_WHOLE		},
+	{	"mmcblk0p1",	DISK_PART		},
+	{	"dm-0",			DISK_STACKED	},
+	{	"md0",			DISK_STACKED	},
+	{	"zram0",		DISK_IGNORE		},
+	{	NULL,			0				}
+};
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  S T A T S  F I X T U R E                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Point the module at a copy of /proc/diskstats and read it.
+ *  \param fileName Name of the fixture.
+ *  \result None.
+ */
+static void readStatsFixture (const char *fileName)
+{
+	static char filePath[1024];
+
+	if (diskStatsFile != -1)
+		close (diskStatsFile);
+	diskStatsFile = -1;
+	diskStats = testFixturePath (fileName, filePath, 1024);
+	readActivityValues ();
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C H E C K  F I R S T  R E A D                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief The first copy has a line longer than the buffer, and one of each sort of device.
+ *  \result None.
+ */
+static void checkFirstRead (void)
+{
+	DISK_INFO *diskInfo;
+	int i;
+
+	readStatsFixture ("diskstats-1");
+	TEST_CHECK (statsBuffSize > STATS_BUFF_SIZE);
+	TEST_CHECK (g_hash_table_size (diskTable) == 17);
+
+	for (i = 0; diskKindChecks[i].name != NULL; ++i)
+	{
+		diskInfo = g_hash_table_lookup (diskTable, diskKindChecks[i].name);
+		if (diskInfo == NULL || diskInfo -> diskKind != diskKindChecks[i].diskKind)
+			fprintf (stderr, "testHarddisk: %s was not sorted out as %d\n", diskKindChecks[i].name,
+					diskKindChecks[i].diskKind);
+		TEST_CHECK (diskInfo != NULL && diskInfo -> diskKind == diskKindChecks[i].diskKind);
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * Whole disks and stacked devices are on the menu, partitions are not by default                 *
+     *------------------------------------------------------------------------------------------------*/
+	TEST_CHECK (diskSlots == 9);
+	TEST_CHECK ((diskInfo = g_hash_table_lookup (diskTable, "sda1")) != NULL && diskInfo -> menuSlot == 0);
+	TEST_CHECK ((diskInfo = g_hash_table_lookup (diskTable, "dm-0")) != NULL && diskInfo -> menuSlot != 0);
+
+	/*------------------------------------------------------------------------------------------------*
+     * The long line and the ones after it are read in full                                           *
+     *------------------------------------------------------------------------------------------------*/
+	TEST_CHECK ((diskInfo = g_hash_table_lookup (diskTable, "sdd")) != NULL);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> values[DISK_SECT_READ].value == 777777);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> values[DISK_IN_FLIGHT].rate == 1);
+	TEST_CHECK ((diskInfo = g_hash_table_lookup (diskTable, "nvme0n1")) != NULL);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> values[DISK_SECT_READ].value == 400000);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> values[DISK_QUEUE].value == 2400);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C H E C K  S E C O N D  R E A D                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief The second copy has a counter that wrapped at 32 bits and two devices removed.
+ *  \result None.
+ */
+static void checkSecondRead (void)
+{
+	DISK_INFO *sda, *sdb, *sdc;
+	float expectRate;
+
+	readStatsFixture ("diskstats-2");
+	TEST_CHECK (activityTimer.seconds > 0);
+	expectRate = (float)(1296.0 / activityTimer.seconds);
+
+	TEST_CHECK ((sda = g_hash_table_lookup (diskTable, "sda")) != NULL);
+	TEST_CHECK ((sdc = g_hash_table_lookup (diskTable, "sdc")) != NULL);
+	if (sda == NULL || sdc == NULL)
+		return;
+
+	TEST_CHECK (sda -> values[DISK_SECT_READ].rate == expectRate);
+	TEST_CHECK (sdc -> values[DISK_SECT_READ].rate == expectRate);
+	TEST_CHECK (sda -> values[DISK_READ_WAIT].rate == 5);
+
+	/*------------------------------------------------------------------------------------------------*
+     * The partition and dm device moved as well, but only whole disks are added in to the total      *
+     *------------------------------------------------------------------------------------------------*/
+	TEST_CHECK (allDisks.values[DISK_SECT_READ].rate == expectRate * 2);
+	TEST_CHECK (fabs (allDisks.values[DISK_READ_WAIT].rate - 5) < 0.001);
+
+	TEST_CHECK (g_hash_table_lookup (diskTable, "sda2") == NULL);
+	TEST_CHECK ((sdb = g_hash_table_lookup (diskTable, "sdb")) != NULL);
+	TEST_CHECK (sdb != NULL && sdb -> seenID != diskSeenID);
+	TEST_CHECK (sdb != NULL && diskActivity[sdb -> menuSlot] == sdb);
+	TEST_CHECK (g_hash_table_size (diskTable) == 16);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C H E C K  T H I R D  R E A D                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief In the third copy the removed devices are back, they should start again from nothing.
+ *  \result None.
+ */
+static void checkThirdRead (void)
+{
+	DISK_INFO *diskInfo;
+
+	readStatsFixture ("diskstats-3");
+	TEST_CHECK (g_hash_table_size (diskTable) == 17);
+	TEST_CHECK (diskSlots == 9);
+
+	TEST_CHECK ((diskInfo = g_hash_table_lookup (diskTable, "sdb")) != NULL);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> seenID == diskSeenID);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> values[DISK_SECT_READ].rate == 0);
+	TEST_CHECK ((diskInfo = g_hash_table_lookup (diskTable, "sda2")) != NULL);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> diskKind == DISK_PART && diskInfo -> menuSlot == 0);
+	TEST_CHECK ((diskInfo = g_hash_table_lookup (diskTable, "sda")) != NULL);
+	TEST_CHECK (diskInfo != NULL && diskInfo -> values[DISK_SECT_READ].rate == (float)(1296.0 / activityTimer.seconds));
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the three copies of /proc/diskstats in turn.
+ *  \result 0 if all the checks passed.
+ */
+int main (void)
+{
+	/*------------------------------------------------------------------------------------------------*
+     * With no sysfs the devices are sorted out by name, not by the disks in this machine             *
+     *------------------------------------------------------------------------------------------------*/
+	diskClass = "/nonexistent";
+
+	checkFirstRead ();
+	checkSecondRead ();
+	checkThirdRead ();
+
+	return testResult ("testHarddisk");
+}
@@ -0,0 +1,598 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  H T T P . C                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Check the web page fetcher against a small local server that stands in for the BBC and UKHO sites.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/socket.h>
+#include <netinet/in.h>
+#include <arpa/inet.h>
+
+#include "config.h"
+#include "GaugeDisp.h"
+#include "GaugeTest.h"
+
+typedef struct _testPage
+{
+	const char *path;
+	const char *fileName;
+	char *buffer;
+	size_t size;
+}
+TEST_PAGE;
+
+typedef struct _testFetch
+{
+	int done;
+	char *buffer;
+	size_t size;
+	char *stream;
+	size_t streamSize;
+	int blocks;
+	int stopAfter;
+}
+TEST_FETCH;
+
+/*----------------------------------------------------------------------------------------------------*
+ * The same paths the gauge asks for, served from the fixtures                                        *
+ *----------------------------------------------------------------------------------------------------*/
+static TEST_PAGE testPages[] =
+{
+	{	"/en/forecast/rss/3day/2643743",	"bbc-forecast.xml",		NULL,	0	},
+	{	"/en/observation/rss/2643743",		"bbc-observation.xml",	NULL,	0	},
+	{	"/easytide/easytide/ShowPrediction.aspx?PredictionLength=4&PortID=0113",
+											"ukho-tide.html",		NULL,	0	},
+	{	NULL,								NULL,					NULL,	0	}
+};
+
+static int listenSock = -1;
+static int serverPort = 0;
+static gint serverConnections = 0;
+static gint serverRequests = 0;
+static gint serverGzipped = 0;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S E R V E R  S E N D                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Send all of a buffer, a small block at a time so the client sees several reads.
+ *  \param sock Socket to send on.
+ *  \param buffer What to send.
+ *  \param size How much to send.
+ *  \result 1 if it was all sent, 0 if the client went away.
+ */
+static int serverSend (int sock, const char *buffer, size_t size)
+{
+	size_t sent = 0;
+
+	while (sent < size)
+	{
+		ssize_t didSend = send (sock, &buffer[sent], size - sent > 512 ? 512 : size - sent, MSG_NOSIGNAL);
+
+		if (didSend <= 0)
+			return 0;
+		sent += didSend;
+	}
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S E R V E R  C O N N E C T I O N                                                                                  *
+ *  ================================                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Answer requests on one connection until the client closes it.
+ *  \param data The socket.
+ *  \result NULL.
+ */
+static gpointer serverConnection (gpointer data)
+{
+	int sock = GPOINTER_TO_INT (data);
+	char request[4096], path[1024], header[256];
+	size_t used = 0;
+
+	while (1)
+	{
+		ssize_t didRead;
+		char *endHead;
+
+		if (used == sizeof (request) - 1)
+			break;
+		if ((didRead = recv (sock, &request[used], sizeof (request) - 1 - used, 0)) <= 0)
+			break;
+		used += didRead;
+		request[used] = 0;
+		if ((endHead = strstr (request, "\r\n\r\n")) == NULL)
+			continue;
+
+		g_atomic_int_inc (&serverRequests);
+		if (sscanf (request, "GET %1023s HTTP", path) == 1)
+		{
+			const char *sendBuffer = NULL;
+			unsigned char *gzipBuffer = NULL;
+			size_t sendSize = 0;
+			int i;
+
+			for (i = 0; testPages[i].path != NULL; ++i)
+			{
+				if (strcmp (testPages[i].path, path) == 0)
+				{
+					sendBuffer = testPages[i].buffer;
+					sendSize = testPages[i].size;
+					break;
+				}
+			}
+			if (sendBuffer == NULL)
+			{
+				snprintf (header, 256, "HTTP/1.1 404 Not Found\r\nContent-Length: 0\r\n\r\n");
+			}
+			else if (strstr (request, "\r\nAccept-Encoding: gzip") != NULL &&
+					(gzipBuffer = testGzip (sendBuffer, sendSize, &sendSize)) != NULL)
+			{
+				g_atomic_int_inc (&serverGzipped);
+				sendBuffer = (const char *)gzipBuffer;
+				snprintf (header, 256, "HTTP/1.1 200 OK\r\nContent-Type: text/xml\r\n"
+						"Content-Encoding: gzip\r\nContent-Length: %lu\r\n\r\n", (unsigned long)sendSize);
+			}
+			else
+			{
+				snprintf (header, 256, "HTTP/1.1 200 OK\r\nContent-Type: text/xml\r\n"
+						"Content-Length: %lu\r\n\r\n", (unsigned long)sendSize);
+			}
+			if (!serverSend (sock, header, strlen (header)) || !serverSend (sock, sendBuffer, sendSize))
+			{
+				free (gzipBuffer);
+				break;
+			}
+			free (gzipBuffer);
+		}
+		/*--------------------------------------------------------------------------------------------*
+         * Keep the connection open for the next request, curl should reuse it                        *
+         *--------------------------------------------------------------------------------------------*/
+		used = 0;
+	}
+	close (sock);
+	return NULL;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S E R V E R  L I S T E N                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Accept connections until the listening socket is closed.
+ *  \param data Not used.
+ *  \result NULL.
+ */
+static gpointer serverListen (gpointer data)
+{
+	int sock;
+
+	while ((sock = accept (listenSock, NULL, NULL)) >= 0)
+	{
+		g_atomic_int_inc (&serverConnections);
+		g_thread_unref (g_thread_new ("connection", serverConnection, GINT_TO_POINTER (sock)));
+	}
+	return NULL;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S E R V E R  S T A R T                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Load the pages and start listening on a free port on the loop back address.
+ *  \result 1 if the server is running, 0 if not.
+ */
+static int serverStart (void)
+{
+	struct sockaddr_in address;
+	socklen_t addressLen = sizeof (address);
+	int i;
+
+	for (i = 0; testPages[i].path != NULL; ++i)
+	{
+		if ((testPages[i].buffer = testReadFixture (testPages[i].fileName, &testPages[i].size)) == NULL)
+			return 0;
+	}
+	if ((listenSock = socket (AF_INET, SOCK_STREAM, 0)) < 0)
+		return 0;
+
+	memset (&address, 0, sizeof (address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+	if (bind (listenSock, (struct sockaddr *)&address, sizeof (address)) != 0 || listen (listenSock, 8) != 0 ||
+			getsockname (listenSock, (struct sockaddr *)&address, &addressLen) != 0)
+	{
+		close (listenSock);
+		return 0;
+	}
+	serverPort = ntohs (address.sin_port);
+	g_thread_unref (g_thread_new ("listen", serverListen, NULL));
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  F R E E  P O R T                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find a port on the loop back address that nothing is listening on.
+ *  \result The port number, 0 if one was not found.
+ */
+static int freePort (void)
+{
+	struct sockaddr_in address;
+	socklen_t addressLen = sizeof (address);
+	int sock, port = 0;
+
+	if ((sock = socket (AF_INET, SOCK_STREAM, 0)) < 0)
+		return 0;
+
+	memset (&address, 0, sizeof (address));
+	address.sin_family = AF_INET;
+	address.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+	if (bind (sock, (struct sockaddr *)&address, sizeof (address)) == 0 &&
+			getsockname (sock, (struct sockaddr *)&address, &addressLen) == 0)
+		port = ntohs (address.sin_port);
+	close (sock);
+	return port;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  F E T C H  D O N E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by the fetcher when a page has been read, the buffer is freed after so keep a copy.
+ *  \param data The fetch.
+ *  \param buffer The page, NULL if it was streamed or failed.
+ *  \param size Size of the page.
+ *  \result None.
+ */
+static void fetchDone (void *data, char *buffer, size_t size)
+{
+	TEST_FETCH *fetch = (TEST_FETCH *)data;
+
+	fetch -> done = 1;
+	fetch -> size = size;
+	if (buffer != NULL && (fetch -> buffer = malloc (size + 1)) != NULL)
+	{
+		memcpy (fetch -> buffer, buffer, size);
+		fetch -> buffer[size] = 0;
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S T R E A M  W R I T E                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by the fetcher with each block of a streamed page.
+ *  \param data The fetch.
+ *  \param buffer The block.
+ *  \param size Size of the block.
+ *  \result 1 to carry on, 0 once stopAfter blocks have been seen.
+ */
+static int streamWrite (void *data, char *buffer, size_t size)
+{
+	TEST_FETCH *fetch = (TEST_FETCH *)data;
+	char *newStream;
+
+	if ((newStream = realloc (fetch -> stream, fetch -> streamSize + size + 1)) == NULL)
+		return 0;
+	fetch -> stream = newStream;
+	memcpy (&fetch -> stream[fetch -> streamSize], buffer, size);
+	fetch -> streamSize += size;
+	fetch -> stream[fetch -> streamSize] = 0;
+	++fetch -> blocks;
+
+	return (fetch -> stopAfter && fetch -> blocks >= fetch -> stopAfter) ? 0 : 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  K E E P  A W A K E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Wake the main loop now and then so waitFor can give up.
+ *  \param data Not used.
+ *  \result TRUE to keep the timer.
+ */
+static gboolean keepAwake (gpointer data)
+{
+	return TRUE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W A I T  F O R                                                                                                    *
+ *  ==============                                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Run the main loop until the fetches are done, as gauge does.
+ *  \param fetch First fetch to wait for.
+ *  \param other Second fetch to wait for, or NULL.
+ *  \result 1 if they finished, 0 if they took more than ten seconds.
+ */
+static int waitFor (TEST_FETCH *fetch, TEST_FETCH *other)
+{
+	double endTime = testTimeNow () + 10.0;
+
+	while ((!fetch -> done || (other != NULL && !other -> done)) && testTimeNow () < endTime)
+		g_main_context_iteration (NULL, TRUE);
+
+	return fetch -> done && (other == NULL || other -> done);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  P A G E  U R L                                                                                                    *
+ *  ==============                                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make the address of a page on the local server.
+ *  \param page Page number in testPages.
+ *  \param url Save the address here.
+ *  \result The address.
+ */
+static char *pageURL (int page, char *url)
+{
+	sprintf (url, "http://127.0.0.1:%d%s", serverPort, testPages[page].path);
+	return url;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  F E T C H  F R E E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free a fetch and clear it for the next one.
+ *  \param fetch The fetch.
+ *  \result None.
+ */
+static void fetchFree (TEST_FETCH *fetch)
+{
+	free (fetch -> buffer);
+	free (fetch -> stream);
+	memset (fetch, 0, sizeof (TEST_FETCH));
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  C O N C U R R E N T                                                                                      *
+ *  ============================                                                                                      *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read a forecast compressed and a tide page plain at the same time.
+ *  \result None.
+ */
+static void testConcurrent (void)
+{
+	TEST_FETCH forecast, tide;
+	char url[2][1024];
+
+	memset (&forecast, 0, sizeof (TEST_FETCH));
+	memset (&tide, 0, sizeof (TEST_FETCH));
+	TEST_CHECK (httpFetch (pageURL (0, url[0]), 1, fetchDone, &forecast));
+	TEST_CHECK (httpFetch (pageURL (2, url[1]), 0, fetchDone, &tide));
+	TEST_CHECK (waitFor (&forecast, &tide));
+
+	TEST_CHECK (forecast.buffer != NULL && forecast.size == testPages[0].size);
+	TEST_CHECK (forecast.buffer != NULL && memcmp (forecast.buffer, testPages[0].buffer, testPages[0].size) == 0);
+	TEST_CHECK (tide.buffer != NULL && tide.size == testPages[2].size);
+	TEST_CHECK (tide.buffer != NULL && memcmp (tide.buffer, testPages[2].buffer, testPages[2].size) == 0);
+	TEST_CHECK (g_atomic_int_get (&serverGzipped) == 1);
+	fetchFree (&forecast);
+	fetchFree (&tide);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  S T R E A M                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Stream an observation page, the blocks should add up to the page and nothing is saved.
+ *  \result None.
+ */
+static void testStream (void)
+{
+	TEST_FETCH observation;
+	char url[1024];
+
+	memset (&observation, 0, sizeof (TEST_FETCH));
+	TEST_CHECK (httpStream (pageURL (1, url), 1, streamWrite, fetchDone, &observation));
+	TEST_CHECK (waitFor (&observation, NULL));
+
+	TEST_CHECK (observation.buffer == NULL);
+	TEST_CHECK (observation.size == testPages[1].size);
+	TEST_CHECK (observation.streamSize == testPages[1].size);
+	TEST_CHECK (observation.stream != NULL && memcmp (observation.stream, testPages[1].buffer, testPages[1].size) == 0);
+	fetchFree (&observation);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  R E U S E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read each page one after the other, they should go over the connections already open.
+ *  \result None.
+ */
+static void testReuse (void)
+{
+	int connections = g_atomic_int_get (&serverConnections);
+	int requests = g_atomic_int_get (&serverRequests);
+	TEST_FETCH fetch;
+	char url[1024];
+	int i;
+
+	for (i = 0; testPages[i].path != NULL; ++i)
+	{
+		memset (&fetch, 0, sizeof (TEST_FETCH));
+		TEST_CHECK (httpFetch (pageURL (i, url), 0, fetchDone, &fetch));
+		TEST_CHECK (waitFor (&fetch, NULL));
+		TEST_CHECK (fetch.buffer != NULL && fetch.size == testPages[i].size);
+		fetchFree (&fetch);
+	}
+	TEST_CHECK (g_atomic_int_get (&serverRequests) == requests + i);
+	TEST_CHECK (g_atomic_int_get (&serverConnections) == connections);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  A B O R T                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Stop a stream part way, the owner should be told it failed.
+ *  \result None.
+ */
+static void testAbort (void)
+{
+	TEST_FETCH tide;
+	char url[1024];
+
+	memset (&tide, 0, sizeof (TEST_FETCH));
+	tide.stopAfter = 1;
+	TEST_CHECK (httpStream (pageURL (2, url), 0, streamWrite, fetchDone, &tide));
+	TEST_CHECK (waitFor (&tide, NULL));
+
+	TEST_CHECK (tide.blocks == 1);
+	TEST_CHECK (tide.buffer == NULL && tide.size == 0);
+	fetchFree (&tide);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  R E F U S E D                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read from a port nothing is listening on, the owner should be told it failed.
+ *  \result None.
+ */
+static void testRefused (void)
+{
+	TEST_FETCH fetch;
+	char url[1024];
+
+	memset (&fetch, 0, sizeof (TEST_FETCH));
+	sprintf (url, "http://127.0.0.1:%d%s", freePort (), testPages[0].path);
+	TEST_CHECK (httpFetch (url, 0, fetchDone, &fetch));
+	TEST_CHECK (waitFor (&fetch, NULL));
+	TEST_CHECK (fetch.buffer == NULL && fetch.size == 0);
+	fetchFree (&fetch);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  R E S T A R T                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free the fetcher, the next fetch should set it up again on a new connection.
+ *  \result None.
+ */
+static void testRestart (void)
+{
+	int connections;
+	TEST_FETCH fetch;
+	char url[1024];
+
+	httpFree ();
+	connections = g_atomic_int_get (&serverConnections);
+
+	memset (&fetch, 0, sizeof (TEST_FETCH));
+	TEST_CHECK (httpFetch (pageURL (1, url), 1, fetchDone, &fetch));
+	TEST_CHECK (waitFor (&fetch, NULL));
+	TEST_CHECK (fetch.buffer != NULL && fetch.size == testPages[1].size);
+	TEST_CHECK (fetch.buffer != NULL && memcmp (fetch.buffer, testPages[1].buffer, testPages[1].size) == 0);
+	TEST_CHECK (g_atomic_int_get (&serverConnections) == connections + 1);
+	fetchFree (&fetch);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Run the checks.
+ *  \result 0 if they all passed.
+ */
+int main (void)
+{
+	int i;
+
+	if (!serverStart ())
+	{
+		fprintf (stderr, "testHttp: could not start the local server\n");
+		return 1;
+	}
+	g_timeout_add (100, keepAwake, NULL);
+
+	testConcurrent ();
+	testStream ();
+	testReuse ();
+	testAbort ();
+	testRefused ();
+	testRestart ();
+
+	httpFree ();
+	close (listenSock);
+	for (i = 0; testPages[i].path != NULL; ++i)
+		free (testPages[i].buffer);
+
+	return testResult ("testHttp");
+}
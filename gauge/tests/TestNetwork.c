@@ -0,0 +1,262 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  N E T W O R K . C                                                                                        *
+ *  ==========================                                                                                        *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Check the netlink and /proc/net/dev backends read the same counters.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "GaugeNetwork.c"
+#include "GaugeTest.h"
+#include "NetworkReplay.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * The module is built in to the check so its file name and socket can be pointed at the replays      *
+ *----------------------------------------------------------------------------------------------------*/
+typedef struct _counterSnap
+{
+	unsigned long long readBytes;
+	unsigned long long writeBytes;
+}
+COUNTER_SNAP;
+
+typedef struct _liveCheck
+{
+	GHashTable *before;
+	GHashTable *after;
+	int common;
+	int wrong;
+}
+LIVE_CHECK;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S N A P S H O T  A D D                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Copy the counters of a device seen on the last read.
+ *  \param key Name of the device.
+ *  \param value Device information.
+ *  \param userData Snapshot to add to.
+ *  \result None.
+ */
+static void snapshotAdd (gpointer key, gpointer value, gpointer userData)
+{
+	DEVICE_INFO *devInfo = (DEVICE_INFO *)value;
+	COUNTER_SNAP *counters;
+
+	if (devInfo -> seenID != deviceSeenID)
+		return;
+	if ((counters = malloc (sizeof (COUNTER_SNAP))) == NULL)
+		return;
+
+	counters -> readBytes = devInfo -> dataRead.value;
+	counters -> writeBytes = devInfo -> dataWrite.value;
+	g_hash_table_insert ((GHashTable *)userData, strdup (devInfo -> name), counters);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  S N A P S H O T                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the devices with one of the backends and copy what was read.
+ *  \param netlink True to read over netlink, false to read the file.
+ *  \param seen Save the number of devices seen here.
+ *  \result Counters read by device name, destroy when done.
+ */
+static GHashTable *readSnapshot (bool netlink, int *seen)
+{
+	GHashTable *snapshot = g_hash_table_new_full (g_str_hash, g_str_equal, free, free);
+
+	++deviceSeenID;
+	*seen = netlink ? readNetlinkDevices (0, 0) : readProcDevices (0, 0);
+	g_hash_table_foreach (deviceTable, snapshotAdd, snapshot);
+	return snapshot;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C H E C K  R E P L A Y                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Give both backends the same links and check they read the same counters.
+ *  \param count Number of links to replay.
+ *  \result None.
+ */
+static void checkReplay (int count)
+{
+	char procName[] = "/tmp/testNetworkXXXXXX";
+	GHashTable *procSnap, *linkSnap;
+	REPLAY_DEVICE *devices;
+	int i, seen, matched = 0;
+
+	if ((devices = replayMakeDevices (count)) == NULL)
+		return;
+	TEST_CHECK (replayWriteProc (devices, count, procName));
+	if (devStatsFile != -1)
+		close (devStatsFile);
+	devStatsFile = -1;
+	deviceStats = procName;
+	TEST_CHECK ((netlinkSock = replayStartNetlink (devices, count)) != -1);
+
+	/*------------------------------------------------------------------------------------------------*
+     * Read the file then switch to netlink, nothing moved so nothing should be counted               *
+     *------------------------------------------------------------------------------------------------*/
+	networkNetlink = false;
+	readDeviceValues (0);
+	networkNetlink = true;
+	readDeviceValues (0);
+	TEST_CHECK (!netlinkFailed);
+	TEST_CHECK (allDevices.dataRead.value == 0);
+	TEST_CHECK (allDevices.dataWrite.value == 0);
+
+	procSnap = readSnapshot (false, &seen);
+	TEST_CHECK (seen == count);
+	linkSnap = readSnapshot (true, &seen);
+	TEST_CHECK (seen == count);
+
+	for (i = 0; i < count; ++i)
+	{
+		COUNTER_SNAP *procCount = g_hash_table_lookup (procSnap, devices[i].name);
+		COUNTER_SNAP *linkCount = g_hash_table_lookup (linkSnap, devices[i].name);
+
+		if (procCount != NULL && linkCount != NULL &&
+				procCount -> readBytes == devices[i].readBytes && procCount -> writeBytes == devices[i].writeBytes &&
+				linkCount -> readBytes == devices[i].readBytes && linkCount -> writeBytes == devices[i].writeBytes)
+			++matched;
+	}
+	TEST_CHECK (matched == count);
+
+	g_hash_table_destroy (procSnap);
+	g_hash_table_destroy (linkSnap);
+	replayStopNetlink (netlinkSock);
+	netlinkSock = -1;
+	unlink (procName);
+	free (devices);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  L I V E  C O M P A R E                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check a link read over netlink is between the file reads either side of it.
+ *  \param key Name of the device.
+ *  \param value Counters read over netlink.
+ *  \param userData The reads of the file and the results.
+ *  \result None.
+ */
+static void liveCompare (gpointer key, gpointer value, gpointer userData)
+{
+	LIVE_CHECK *liveCheck = (LIVE_CHECK *)userData;
+	COUNTER_SNAP *linkCount = (COUNTER_SNAP *)value;
+	COUNTER_SNAP *before = g_hash_table_lookup (liveCheck -> before, key);
+	COUNTER_SNAP *after = g_hash_table_lookup (liveCheck -> after, key);
+
+	if (before == NULL || after == NULL)
+		return;
+
+	++liveCheck -> common;
+	if (linkCount -> readBytes < before -> readBytes || linkCount -> readBytes > after -> readBytes ||
+			linkCount -> writeBytes < before -> writeBytes || linkCount -> writeBytes > after -> writeBytes)
+	{
+		fprintf (stderr, "testNetwork: %s read %llu/%llu over netlink, %llu/%llu then %llu/%llu from the file\n",
+				(char *)key, linkCount -> readBytes, linkCount -> writeBytes, before -> readBytes,
+				before -> writeBytes, after -> readBytes, after -> writeBytes);
+		++liveCheck -> wrong;
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C H E C K  L I V E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read this machine's links file, netlink, file, the counters can only go up so netlink must be between.
+ *  \result None.
+ */
+static void checkLive (void)
+{
+	LIVE_CHECK liveCheck;
+	GHashTable *linkSnap;
+	int seenBefore, seenLink, seenAfter;
+
+	if ((netlinkSock = netlinkOpen (0)) == -1)
+	{
+		printf ("testNetwork: no netlink here, only the replays were checked\n");
+		return;
+	}
+	if (devStatsFile != -1)
+		close (devStatsFile);
+	devStatsFile = -1;
+	deviceStats = "/proc/net/dev";
+
+	memset (&liveCheck, 0, sizeof (liveCheck));
+	liveCheck.before = readSnapshot (false, &seenBefore);
+	linkSnap = readSnapshot (true, &seenLink);
+	liveCheck.after = readSnapshot (false, &seenAfter);
+	TEST_CHECK (seenBefore > 0 && seenLink > 0 && seenAfter > 0);
+
+	g_hash_table_foreach (linkSnap, liveCompare, &liveCheck);
+	TEST_CHECK (liveCheck.common > 0);
+	TEST_CHECK (liveCheck.wrong == 0);
+
+	g_hash_table_destroy (liveCheck.before);
+	g_hash_table_destroy (linkSnap);
+	g_hash_table_destroy (liveCheck.after);
+	close (netlinkSock);
+	netlinkSock = -1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check 10, 100 and 1000 replayed links, then the links on this machine.
+ *  \result 0 if all the checks passed.
+ */
+int main (void)
+{
+	static const int linkCounts[] = { 10, 100, 1000, 0 };
+	int i;
+
+	for (i = 0; linkCounts[i]; ++i)
+		checkReplay (linkCounts[i]);
+	checkLive ();
+
+	return testResult ("testNetwork");
+}
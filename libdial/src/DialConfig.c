@@ -31,11 +31,21 @@ typedef struct _configEntry
 {
 	char *configName;
 	char *configValue;
+	unsigned int nameHash;
 	bool saveInFile;
 }
 CONFIG_ENTRY;
 
+/*----------------------------------------------------------------------------------------------------*
+ * The queue keeps the entries in the order they were added (for saving), the hash table (open        *
+ * addressing, linear probing) is used to find them by name.                                          *
+ *----------------------------------------------------------------------------------------------------*/
+#define CONFIG_HASH_MIN		64
+
 static void *configQueue = NULL;
+static CONFIG_ENTRY **configHash = NULL;
+static unsigned long configHashSize = 0;
+static unsigned long configHashUsed = 0;
 static bool fileLoaded = false;
 int configSetValue (const char *configName, char *configValue);
 
@@ -207,6 +217,84 @@ void configFree ()
 		queueDelete (configQueue);
 		configQueue = NULL;
 	}
+	if (configHash != NULL)
+	{
+		free (configHash);
+		configHash = NULL;
+	}
+	configHashSize = configHashUsed = 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O N F I G  H A S H  N A M E                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Calculate the hash of a config name (FNV-1a).
+ *  \param configName Name to hash.
+ *  \result The hash value.
+ */
+static unsigned int configHashName (const char *configName)
+{
+	unsigned int hash = 2166136261u;
+
+	while (*configName)
+	{
+		hash ^= (unsigned char)*configName++;
+		hash *= 16777619u;
+	}
+	return hash;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O N F I G  H A S H  A D D                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Add an entry to the hash table, making the table bigger if it is getting full.
+ *  \param newEntry Entry to add, the name hash must already be set.
+ *  \result True if added.
+ */
+static int configHashAdd (CONFIG_ENTRY *newEntry)
+{
+	unsigned long i;
+
+	if ((configHashUsed + 1) * 4 > configHashSize * 3)
+	{
+		CONFIG_ENTRY **newHash;
+		unsigned long newSize = configHashSize ? configHashSize * 2 : CONFIG_HASH_MIN;
+
+		if ((newHash = calloc (newSize, sizeof (CONFIG_ENTRY *))) == NULL)
+			return 0;
+
+		for (i = 0; i < configHashSize; ++i)
+		{
+			if (configHash[i] != NULL)
+			{
+				unsigned long j = configHash[i] -> nameHash & (newSize - 1);
+
+				while (newHash[j] != NULL)
+					j = (j + 1) & (newSize - 1);
+				newHash[j] = configHash[i];
+			}
+		}
+		if (configHash != NULL)
+			free (configHash);
+		configHash = newHash;
+		configHashSize = newSize;
+	}
+
+	i = newEntry -> nameHash & (configHashSize - 1);
+	while (configHash[i] != NULL)
+		i = (i + 1) & (configHashSize - 1);
+
+	configHash[i] = newEntry;
+	configHashUsed ++;
+	return 1;
 }
 
 /**********************************************************************************************************************
@@ -218,23 +306,25 @@ void configFree ()
 /**
  *  \brief Find a config setting.
  *  \param configName Name to look for.
+ *  \param nameHash Hash of the name.
  *  \result Pointer to the item if found.
  */
-static CONFIG_ENTRY *configFindEntry (const char *configName)
+static CONFIG_ENTRY *configFindEntry (const char *configName, unsigned int nameHash)
 {
-	int rec = 0;
-	CONFIG_ENTRY *foundEntry = NULL;
+	unsigned long i;
 
-	if (configQueue != NULL)
+	if (configHash == NULL)
+		return NULL;
+
+	i = nameHash & (configHashSize - 1);
+	while (configHash[i] != NULL)
 	{
-		while ((foundEntry = queueRead (configQueue, rec)) != NULL)
-		{
-			if (strcmp (configName, foundEntry -> configName) == 0)
-				break;
-			rec ++;
-		}
+		if (configHash[i] -> nameHash == nameHash && strcmp (configName, configHash[i] -> configName) == 0)
+			return configHash[i];
+
+		i = (i + 1) & (configHashSize - 1);
 	}
-	return foundEntry;
+	return NULL;
 }
 
 /**********************************************************************************************************************
@@ -252,6 +342,7 @@ static CONFIG_ENTRY *configFindEntry (const char *configName)
 int configSetValue (const char *configName, char *configValue)
 {
 	CONFIG_ENTRY *newEntry = NULL;
+	unsigned int nameHash = configHashName (configName);
 
 	if (configQueue == NULL)
 	{
@@ -259,7 +350,7 @@ int configSetValue (const char *configName, char *configValue)
 			return 0;
 	}
 
-	if ((newEntry = configFindEntry (configName)) == NULL)
+	if ((newEntry = configFindEntry (configName, nameHash)) == NULL)
 	{
 		if ((newEntry = malloc (sizeof (CONFIG_ENTRY))) == NULL)
 			return 0;
@@ -278,8 +369,16 @@ int configSetValue (const char *configName, char *configValue)
 			return 0;
 		}
 		strcpy (newEntry -> configValue, configValue);
+		newEntry -> nameHash = nameHash;
 		newEntry -> saveInFile = fileLoaded;
 
+		if (!configHashAdd (newEntry))
+		{
+			free (newEntry -> configValue);
+			free (newEntry -> configName);
+			free (newEntry);
+			return 0;
+		}
 		queuePut (configQueue, newEntry);
 	}
 	else
@@ -349,7 +448,7 @@ int configSetBoolValue (const char *configName, bool configValue)
  */
 int configGetValue (const char *configName, char *value, int maxLen)
 {
-	CONFIG_ENTRY *foundEntry = configFindEntry (configName);
+	CONFIG_ENTRY *foundEntry = configFindEntry (configName, configHashName (configName));
 
 	if (foundEntry != NULL)
 	{
@@ -374,7 +473,7 @@ int configGetValue (const char *configName, char *value, int maxLen)
  */
 int configGetIntValue (const char *configName, int *value)
 {
-	CONFIG_ENTRY *foundEntry = configFindEntry ((char *)configName);
+	CONFIG_ENTRY *foundEntry = configFindEntry (configName, configHashName (configName));
 
 	if (foundEntry != NULL)
 	{
@@ -398,7 +497,7 @@ int configGetIntValue (const char *configName, int *value)
  */
 int configGetBoolValue (const char *configName, bool *value)
 {
-	CONFIG_ENTRY *foundEntry = configFindEntry ((char *)configName);
+	CONFIG_ENTRY *foundEntry = configFindEntry (configName, configHashName (configName));
 
 	if (foundEntry != NULL)
 	{
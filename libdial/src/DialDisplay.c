@@ -28,28 +28,277 @@
 #include "dialsys.h"
 
 static int dialMaxColours;
-static int savePosX, savePosY;
-static int saveCentreX, saveCentreY;
 static char saveFilePath[PATH_MAX];
-static cairo_t *saveCairo;
 static DIAL_CONFIG *dialConfig;
+
+/**********************************************************************************************************************
+ * Context used by the functions that do not take one, so existing callers keep working.                              *
+ **********************************************************************************************************************/
+static DIAL_CONTEXT defaultContext = { NULL, NULL, 0, 0, 0, 0, NULL, NULL, -1 };
+
+/**********************************************************************************************************************
+ * Cache of the static part of each face (discs, markers and text), only the hands are drawn every frame. Each dial   *
+ * config has its own, so two dials in one program do not share faces.                                                *
+ **********************************************************************************************************************/
+typedef struct _faceCache
+{
+	cairo_surface_t *surface;
+	char *faceKey;
+	int dialSize;
+	int dialGradient;
+	int markerType;
+	int markerStep;
+	int startPoint;
+	unsigned int colourSum;
+}
+FACE_CACHE;
+
 #if GTK_MAJOR_VERSION == 2
 static GdkDrawable *windowShapeBitmap = NULL;
 static GdkColormap *colourMap;
 #endif
 
 /**********************************************************************************************************************
- * Use tables for the sin and cos calculation, it is faster.                                                          *
+ * Shaped text layouts, reused while the text, font and size stay the same. Faces can be drawn on more than one       *
+ * thread, so each thread keeps its own Pango context, layouts and atlases and labels are drawn without a lock.       *
+ **********************************************************************************************************************/
+#define TEXT_CACHE_SIZE		64
+
+typedef struct _textCache
+{
+	char *text;
+	unsigned int textHash;
+	int fontSize;
+	PangoLayout *layout;
+	unsigned long lastUsed;
+}
+TEXT_CACHE;
+
+/**********************************************************************************************************************
+ * Numeric and Roman labels only use a few characters, so each one is rendered once per font size into an atlas and   *
+ * the labels are drawn by masking the colour through the glyphs, without shaping the text each time.                 *
+ **********************************************************************************************************************/
+#define ATLAS_CHARS			"0123456789.-IVX"
+#define ATLAS_COUNT			15
+#define ATLAS_SIZE			8
+
+typedef struct _textAtlas
+{
+	int fontSize;
+	double scaleX;
+	double scaleY;
+	int height;
+	int pad;
+	int advance[ATLAS_COUNT];
+	int kerning[ATLAS_COUNT][ATLAS_COUNT];
+	cairo_surface_t *surface;
+	cairo_surface_t *glyphs[ATLAS_COUNT];
+	unsigned long lastUsed;
+}
+TEXT_ATLAS;
+
+/**********************************************************************************************************************
+ * The text cache of one thread. It is thrown away and started again when the font or font options are changed.       *
+ **********************************************************************************************************************/
+typedef struct _textState
+{
+	PangoContext *context;
+	PangoFontDescription *fontDesc;
+	char *fontName;
+	int fontSize;
+	gint generation;
+	unsigned long useCount;
+	TEXT_CACHE cache[TEXT_CACHE_SIZE];
+	TEXT_ATLAS atlas[ATLAS_SIZE];
+}
+TEXT_STATE;
+
+static void dialTextStateFree (gpointer data);
+static gint textGeneration = 1;
+static gint textHits = 0;
+static gint textMisses = 0;
+static cairo_font_options_t *textFontOptions = NULL;
+#if GLIB_CHECK_VERSION(2,32,0)
+static GPrivate textPrivate = G_PRIVATE_INIT (dialTextStateFree);
+#define TEXT_STATE_GET()	((TEXT_STATE *)g_private_get (&textPrivate))
+#define TEXT_STATE_SET(s)	g_private_set (&textPrivate, s)
+static GMutex textMutex;
+#define TEXT_LOCK()			g_mutex_lock (&textMutex)
+#define TEXT_UNLOCK()		g_mutex_unlock (&textMutex)
+#else
+static GStaticPrivate textPrivate = G_STATIC_PRIVATE_INIT;
+#define TEXT_STATE_GET()	((TEXT_STATE *)g_static_private_get (&textPrivate))
+#define TEXT_STATE_SET(s)	g_static_private_set (&textPrivate, s, dialTextStateFree)
+static GStaticMutex textMutex = G_STATIC_MUTEX_INIT;
+#define TEXT_LOCK()			g_static_mutex_lock (&textMutex)
+#define TEXT_UNLOCK()		g_static_mutex_unlock (&textMutex)
+#endif
+
+/**********************************************************************************************************************
+ * Gradient patterns for the circle and square fills, reused while the colour, style and place on the grid stay the   *
+ * same. The larger circles also keep a bitmap of the filled disc that can be painted straight onto the face.         *
+ **********************************************************************************************************************/
+#define GRADIENT_CACHE_SIZE	(MAX_FACES * 4)
+#define DISC_CACHE_SIZE		24
+
+typedef struct _gradientCache
+{
+	int colFill;
+	int style;
+	int dialGradient;
+	int patSize;
+	int offset;
+	int steps;
+	float colour[3];
+	cairo_pattern_t *pattern;
+	unsigned long lastUsed;
+}
+GRADIENT_CACHE;
+
+typedef struct _discCache
+{
+	cairo_pattern_t *pattern;
+	int posX;
+	int posY;
+	int radius;
+	double scale;
+	cairo_surface_t *surface;
+	unsigned long lastUsed;
+}
+DISC_CACHE;
+
+static GRADIENT_CACHE gradientCache[GRADIENT_CACHE_SIZE];
+static DISC_CACHE discCache[DISC_CACHE_SIZE];
+static unsigned long gradientUseCount = 0;
+#if GLIB_CHECK_VERSION(2,32,0)
+static GMutex gradientMutex;
+#define GRADIENT_LOCK()		g_mutex_lock (&gradientMutex)
+#define GRADIENT_UNLOCK()	g_mutex_unlock (&gradientMutex)
+#else
+static GStaticMutex gradientMutex = G_STATIC_MUTEX_INIT;
+#define GRADIENT_LOCK()		g_static_mutex_lock (&gradientMutex)
+#define GRADIENT_UNLOCK()	g_static_mutex_unlock (&gradientMutex)
+#endif
+
+/**********************************************************************************************************************
+ * Hand sprites, used when the config asks for them. A bank holds a bitmap of each hand at every angle it has been    *
+ * drawn at, until the memory budget runs out, then the hand drawn at angle zero is rotated into place instead.       *
+ **********************************************************************************************************************/
+#define SPRITE_HANDS		16
+#define SPRITE_BUDGET		(16 << 20)
+
+#if GTK_MAJOR_VERSION == 2
+typedef GdkColor DIAL_COLOUR;
+#else
+typedef GdkRGBA DIAL_COLOUR;
+#endif
+
+typedef struct _handSprite
+{
+	HAND_STYLE *handStyle;
+	int dialSize;
+	int style;
+	int length;
+	int tail;
+	bool fillIn;
+	DIAL_COLOUR fillColour;
+	DIAL_COLOUR lineColour;
+	double scale;
+	cairo_surface_t *base;
+	int baseX;
+	int baseY;
+	cairo_surface_t *bank[SCALE_4];
+	int bankX[SCALE_4];
+	int bankY[SCALE_4];
+}
+HAND_SPRITE;
+
+static HAND_SPRITE handSprites[SPRITE_HANDS];
+static int handSpriteNext = 0;
+static long handSpriteBytes = 0;
+#if GLIB_CHECK_VERSION(2,32,0)
+static GMutex spriteMutex;
+#define SPRITE_LOCK()		g_mutex_lock (&spriteMutex)
+#define SPRITE_UNLOCK()		g_mutex_unlock (&spriteMutex)
+#else
+static GStaticMutex spriteMutex = G_STATIC_MUTEX_INIT;
+#define SPRITE_LOCK()		g_static_mutex_lock (&spriteMutex)
+#define SPRITE_UNLOCK()		g_static_mutex_unlock (&spriteMutex)
+#endif
+
+/**********************************************************************************************************************
+ * Use tables for the sin and cos calculation, it is faster. The values are fixed point so the points only need an    *
+ * integer multiply and a shift, the shift rounds to the nearest pixel.                                               *
+ **********************************************************************************************************************/
+#define SIN_COS_SHIFT		16
+#define SIN_COS_ROUND		(1 << (SIN_COS_SHIFT - 1))
+
+static int sinTable[SCALE_4];
+static int cosTable[SCALE_4];
+
+/**********************************************************************************************************************
+ * Hand shapes, each point is the sum of two radii given as a length and the number of quarter turns from the hand.   *
  **********************************************************************************************************************/
-static double sinTable[SCALE_4];
-static double cosTable[SCALE_4];
+enum
+{
+	HAND_LEN_NONE, HAND_LEN_ONE, HAND_LEN_TAIL, HAND_LEN_SIZE, HAND_LEN_SIZE15, HAND_LEN_SIZE12,
+	HAND_LEN_30, HAND_LEN_40, HAND_LEN_COUNT
+};
+
+typedef struct _handShape
+{
+	int numPoints;
+	unsigned char radii[HAND_MAX_POINTS][4];
+}
+HAND_SHAPE;
+
+static const HAND_SHAPE handShapes[7] =
+{
+	{	/* Original double triangle */
+		4, {{ HAND_LEN_TAIL, 2, HAND_LEN_NONE, 0 }, { HAND_LEN_ONE, 1, HAND_LEN_NONE, 0 },
+			{ HAND_LEN_SIZE, 0, HAND_LEN_NONE, 0 }, { HAND_LEN_ONE, 3, HAND_LEN_NONE, 0 }}
+	},
+	{	/* Single triangle */
+		3, {{ HAND_LEN_TAIL, 2, HAND_LEN_ONE, 1 }, { HAND_LEN_TAIL, 2, HAND_LEN_ONE, 3 },
+			{ HAND_LEN_SIZE, 0, HAND_LEN_NONE, 0 }}
+	},
+	{	/* Rectangle */
+		4, {{ HAND_LEN_TAIL, 2, HAND_LEN_ONE, 1 }, { HAND_LEN_TAIL, 2, HAND_LEN_ONE, 3 },
+			{ HAND_LEN_SIZE, 0, HAND_LEN_ONE, 3 }, { HAND_LEN_SIZE, 0, HAND_LEN_ONE, 1 }}
+	},
+	{	/* Rectangle with pointer */
+		5, {{ HAND_LEN_TAIL, 2, HAND_LEN_ONE, 1 }, { HAND_LEN_TAIL, 2, HAND_LEN_ONE, 3 },
+			{ HAND_LEN_SIZE15, 0, HAND_LEN_ONE, 3 }, { HAND_LEN_SIZE, 0, HAND_LEN_NONE, 0 },
+			{ HAND_LEN_SIZE15, 0, HAND_LEN_ONE, 1 }}
+	},
+	{	/* Rectangle with arrow */
+		7, {{ HAND_LEN_TAIL, 2, HAND_LEN_ONE, 1 }, { HAND_LEN_TAIL, 2, HAND_LEN_ONE, 3 },
+			{ HAND_LEN_SIZE12, 0, HAND_LEN_ONE, 3 }, { HAND_LEN_SIZE12, 0, HAND_LEN_30, 3 },
+			{ HAND_LEN_SIZE, 0, HAND_LEN_NONE, 0 }, { HAND_LEN_SIZE12, 0, HAND_LEN_30, 1 },
+			{ HAND_LEN_SIZE12, 0, HAND_LEN_ONE, 1 }}
+	},
+	{	/* Single thin triangle */
+		3, {{ HAND_LEN_TAIL, 2, HAND_LEN_40, 1 }, { HAND_LEN_TAIL, 2, HAND_LEN_40, 3 },
+			{ HAND_LEN_SIZE, 0, HAND_LEN_NONE, 0 }}
+	},
+	{	/* Simple line */
+		2, {{ HAND_LEN_TAIL, 2, HAND_LEN_NONE, 0 }, { HAND_LEN_SIZE, 0, HAND_LEN_NONE, 0 }}
+	}
+};
 
 /**********************************************************************************************************************
  * Function prototypes.                                                                                               *
  **********************************************************************************************************************/
 void dialWindowMask (void);
 int dialCreateColours();
+unsigned int dialColourSum (DIAL_CONFIG *config);
 void dialFillSinCosTables ();
+void dialCtxSetColour (DIAL_CONTEXT *dialContext, int i);
+void dialTextReset (void);
+static void dialTextAtlasFree (TEXT_ATLAS *atlas);
+static void dialGradientFlush (void);
+static bool dialPixelAligned (cairo_t *cr, double *scale);
+static void dialHandSpriteFlush (void);
 
 /**********************************************************************************************************************
  *                                                                                                                    *
@@ -69,9 +318,11 @@ void dialFillSinCosTables ();
 GtkWidget *dialInit (DIAL_CONFIG *dialConfigIn)
 {
 	dialConfig = dialConfigIn;
+	defaultContext.dialConfig = dialConfig;
 
 	dialFillSinCosTables ();
 	dialMaxColours = dialCreateColours();
+	dialTextReset ();
 	dialConfig -> drawingArea = gtk_drawing_area_new ();
 	gtk_widget_set_size_request (dialConfig -> drawingArea, dialConfig -> dialWidth * dialConfig -> dialSize,
 			dialConfig -> dialHeight * dialConfig -> dialSize);
@@ -125,831 +376,2577 @@ void dialGetScreenSize (int *width, int *height)
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  S T A R T                                                                                       *
- *  ===========================                                                                                       *
+ *  D I A L  C O N T E X T  C R E A T E                                                                               *
+ *  ===================================                                                                               *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Start the drawing of a dial.
- *  \param cr Cairo context saved for later.
- *  \param posX X position of the gauge.
- *  \param posY Y position of the gauge.
- *  \result None.
+ *  \brief Create a drawing context, each thread drawing faces at the same time needs its own.
+ *  \param dialConfig Dial config the faces are drawn with.
+ *  \result The new context, NULL if out of memory, free with dialContextFree.
  */
-void dialDrawStart (cairo_t *cr, int posX, int posY)
+DIAL_CONTEXT *dialContextCreate (DIAL_CONFIG *dialConfig)
 {
-	savePosX = posX;
-	savePosY = posY;
-	saveCentreX = posX + (dialConfig -> dialSize >> 1);
-	saveCentreY = posY + (dialConfig -> dialSize >> 1);
-	saveCairo = cr;
+	DIAL_CONTEXT *dialContext = (DIAL_CONTEXT *)malloc (sizeof (DIAL_CONTEXT));
 
-	cairo_save (saveCairo);
-	cairo_set_line_cap (saveCairo, CAIRO_LINE_CAP_BUTT);
-	cairo_set_line_join (saveCairo, CAIRO_LINE_JOIN_MITER);
+	if (dialContext != NULL)
+	{
+		memset (dialContext, 0, sizeof (DIAL_CONTEXT));
+		dialContext -> dialConfig = dialConfig;
+		dialContext -> cacheFace = -1;
+	}
+	return dialContext;
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  F I N I S H                                                                                     *
- *  =============================                                                                                     *
+ *  D I A L  C O N T E X T  F R E E                                                                                   *
+ *  ===============================                                                                                   *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Finish the drawing of a dial.
+ *  \brief Free a drawing context made by dialContextCreate, or just the tiles of the default context.
+ *  \param dialContext Context to free.
  *  \result None.
  */
-void dialDrawFinish ()
+void dialContextFree (DIAL_CONTEXT *dialContext)
 {
-	cairo_restore (saveCairo);
+	if (dialContext != NULL)
+	{
+		dialCtxTilesFree (dialContext);
+		if (dialContext != &defaultContext)
+			free (dialContext);
+	}
 }
 
-#if GTK_MAJOR_VERSION == 2
-GdkColor
-#else
-GdkRGBA
-#endif
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  C O L O U R                                                                                              *
- *  ====================                                                                                              *
+ *  D I A L  D E F A U L T  C O N T E X T                                                                             *
+ *  =====================================                                                                             *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Get the colour value for a colour number.
- *  \param i The number of the colour to find.
- *  \result Pointer to the GtkColour.
+ *  \brief Get the context used by the drawing functions that do not take one.
+ *  \result The default context.
  */
-*dialColour (int i)
+DIAL_CONTEXT *dialDefaultContext (void)
 {
-	if (i < 0 || i >= dialMaxColours)
-		return &dialConfig -> colourDetails[0].dialColour;
-
-	return &dialConfig -> colourDetails[i].dialColour;
+	return &defaultContext;
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  S E T  C O L O U R                                                                                       *
+ *  D I A L  D R A W  S T A R T                                                                                       *
  *  ===========================                                                                                       *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Set the colour to use.
- *  \param i Which colour to set.
+ *  \brief Start the drawing of a dial, using the default context.
+ *  \param cr Cairo context saved for later.
+ *  \param posX X position of the gauge.
+ *  \param posY Y position of the gauge.
  *  \result None.
  */
-void dialSetColour (int i)
+void dialDrawStart (cairo_t *cr, int posX, int posY)
 {
-#if GTK_MAJOR_VERSION == 2
-	gdk_cairo_set_source_color (saveCairo, dialColour (i));
-#else
-	gdk_cairo_set_source_rgba (saveCairo, dialColour (i));
-#endif
+	dialCtxDrawStart (&defaultContext, cr, posX, posY);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  W I N D O W  M A S K                                                                                     *
- *  =============================                                                                                     *
+ *  D I A L  C T X  D R A W  S T A R T                                                                                *
+ *  ==================================                                                                                *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Create a mask for the dials.
+ *  \brief Start the drawing of a dial.
+ *  \param dialContext Drawing context.
+ *  \param cr Cairo context saved for later.
+ *  \param posX X position of the gauge.
+ *  \param posY Y position of the gauge.
  *  \result None.
  */
-void dialWindowMask (void)
+void dialCtxDrawStart (DIAL_CONTEXT *dialContext, cairo_t *cr, int posX, int posY)
 {
-#if GTK_MAJOR_VERSION == 2
-
-	int fullHeight, fullWidth, i, j;
-	GdkGC *gc;
-
-	fullHeight = dialConfig -> dialHeight * dialConfig -> dialSize;
-	fullWidth = dialConfig -> dialWidth * dialConfig -> dialSize;
-
-	if (windowShapeBitmap)
-	{
-		g_object_unref (windowShapeBitmap);
-		windowShapeBitmap = NULL;
-	}
-
-	windowShapeBitmap = (GdkBitmap *) gdk_pixmap_new (NULL, fullWidth, fullHeight, 1);
-
-	gc = gdk_gc_new (windowShapeBitmap);
-	gdk_gc_set_foreground (gc, dialColour (0));
-	gdk_gc_set_background (gc, dialColour (1));
-
-	gdk_draw_rectangle (windowShapeBitmap, gc, TRUE, 0, 0, fullWidth, fullHeight);
-
-	gdk_gc_set_foreground (gc, dialColour (1));
-	gdk_gc_set_background (gc, dialColour (0));
-
-	for (i = 0; i < dialConfig -> dialWidth; i++)
-	{
-		for (j = 0; j < dialConfig -> dialHeight; j++)
-			gdk_draw_arc (windowShapeBitmap, gc, TRUE, (i * dialConfig -> dialSize) - 1, (j * dialConfig -> dialSize) - 1,
-					dialConfig -> dialSize + 1, dialConfig -> dialSize + 1, 0, 360 * 64);
-	}
-	gtk_widget_shape_combine_mask (GTK_WIDGET (dialConfig -> mainWindow), windowShapeBitmap, 0, 0);
-	g_object_unref (gc);
-
-#else
-
-	cairo_t *cr;
-	cairo_surface_t *surface;
-	cairo_region_t *region;
-	int fullHeight, fullWidth, i, j;
-
-	fullHeight = dialConfig -> dialHeight * dialConfig -> dialSize;
-	fullWidth = dialConfig -> dialWidth * dialConfig -> dialSize;
-
-	surface = cairo_image_surface_create (CAIRO_FORMAT_A8, fullWidth, fullHeight);
-	cr = cairo_create (surface);
-	if (cairo_status (cr) == CAIRO_STATUS_SUCCESS)
-	{
-		for (i = 0; i < dialConfig -> dialWidth; i++)
-		{
-			for (j = 0; j < dialConfig -> dialHeight; j++)
-			{
-				int centerX = (dialConfig -> dialSize * i) + (dialConfig -> dialSize >> 1);
-				int centerY = (dialConfig -> dialSize * j) + (dialConfig -> dialSize >> 1);
-
-				cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 1.0);
-				cairo_arc (cr, centerX, centerY, (dialConfig -> dialSize * 64) >> 7, 0, 2 * M_PI);
-				cairo_fill (cr);
-				cairo_stroke (cr);
-			}
-		}
-		region = gdk_cairo_region_create_from_surface (surface);
-		gtk_widget_shape_combine_region (GTK_WIDGET (dialConfig -> mainWindow), region);
-		cairo_region_destroy (region);
-	}
-	cairo_destroy (cr);
-
-#endif
+	dialContext -> posX = posX;
+	dialContext -> posY = posY;
+	dialContext -> centreX = posX + (dialContext -> dialConfig -> dialSize >> 1);
+	dialContext -> centreY = posY + (dialContext -> dialConfig -> dialSize >> 1);
+	dialContext -> cairo = cr;
+
+	cairo_save (cr);
+	cairo_set_line_cap (cr, CAIRO_LINE_CAP_BUTT);
+	cairo_set_line_join (cr, CAIRO_LINE_JOIN_MITER);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  M I N U T E                                                                                     *
+ *  D I A L  D R A W  F I N I S H                                                                                     *
  *  =============================                                                                                     *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a small minute marker.
- *  \param size Size of the marker.
- *  \param len Length of the marker.
- *  \param angle Angle of the marker.
- *  \param colour colour of the marker.
+ *  \brief Finish the drawing of a dial, using the default context.
  *  \result None.
  */
-void dialDrawMinute (int size, int len, int angle, int colour)
+void dialDrawFinish ()
 {
-	dialDrawMinuteX (saveCentreX, saveCentreY, size, len, angle, colour);
+	dialCtxDrawFinish (&defaultContext);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  M I N U T E  X                                                                                  *
- *  ================================                                                                                  *
+ *  D I A L  C T X  D R A W  F I N I S H                                                                              *
+ *  ====================================                                                                              *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a small minute marker.
- *  \param posX Centre position.
- *  \param posY Centre position.
- *  \param size Size of the marker.
- *  \param len Length of the marker.
- *  \param angle Angle of the marker.
- *  \param colour colour of the marker.
+ *  \brief Finish the drawing of a dial.
+ *  \param dialContext Drawing context.
  *  \result None.
  */
-void dialDrawMinuteX (int posX, int posY, int size, int len, int angle, int colour)
+void dialCtxDrawFinish (DIAL_CONTEXT *dialContext)
 {
-	cairo_set_line_width (saveCairo, 1.0f + ((float)dialConfig -> dialSize / 512.0f));
-	dialSetColour (colour);
-	if (len < size)
-	{
-		cairo_move_to (saveCairo,
-				posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle),
-				posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle));
-
-		cairo_line_to (saveCairo,
-				posX + dialSin ((dialConfig -> dialSize * (size + len)) >> 6, angle),
-				posY - dialCos ((dialConfig -> dialSize * (size + len)) >> 6, angle));
-	}
-	else
-	{
-		cairo_move_to (saveCairo,
-				posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle + SCALE_2),
-				posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle + SCALE_2));
-
-		cairo_line_to (saveCairo,
-				posX + dialSin ((dialConfig -> dialSize * (size + len)) >> 6, angle),
-				posY - dialCos ((dialConfig -> dialSize * (size + len)) >> 6, angle));
-	}
-	cairo_stroke (saveCairo);
+	cairo_restore (dialContext -> cairo);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  C I R C L E                                                                                     *
- *  =============================                                                                                     *
+ *  D I A L  F A C E  D I R T Y                                                                                       *
+ *  ===========================                                                                                       *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a circle on the dial.
- *  \param size Size of the marker.
- *  \param colFill Fill colour.
- *  \param colOut Outline colour.
+ *  \brief Mark a face as changed so the next dialQueueDirtyFaces redraws it, using the default context.
+ *  \param face Which face has changed.
  *  \result None.
  */
-void dialDrawCircle (int size, int colFill, int colOut)
+void dialFaceDirty (int face)
 {
-	dialDrawCircleX (saveCentreX, saveCentreY, size, colFill, colOut);
+	dialCtxFaceDirty (&defaultContext, face);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  C I R C L E  X                                                                                  *
- *  ================================                                                                                  *
+ *  D I A L  C T X  F A C E  D I R T Y                                                                                *
+ *  ==================================                                                                                *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a circle on the dial.
- *  \param posX Centre position.
- *  \param posY Centre position.
- *  \param size Size of the marker.
- *  \param colFill Fill colour.
- *  \param colOut Outline colour.
+ *  \brief Mark a face as changed so the next dialCtxQueueDirtyFaces redraws it.
+ *  \param dialContext Drawing context, the face is marked on its dial config.
+ *  \param face Which face has changed.
  *  \result None.
  */
-void dialDrawCircleX (int posX, int posY, int size, int colFill, int colOut)
+void dialCtxFaceDirty (DIAL_CONTEXT *dialContext, int face)
 {
-	int trueSize = (dialConfig -> dialSize * size) >> 7;
-
-	cairo_set_line_width (saveCairo, 1.0f + ((float)dialConfig -> dialSize / 256.0f));
-	if (colFill != -1)
-	{
-		dialSetColour (colFill);
-		cairo_arc (saveCairo, posX, posY, trueSize, 0, 2 * M_PI);
-		cairo_fill (saveCairo);
-		cairo_stroke (saveCairo);
-	}
-	if (colOut != -1)
-	{
-		dialSetColour (colOut);
-		cairo_arc (saveCairo, posX, posY, trueSize, 0, 2 * M_PI);
-		cairo_stroke (saveCairo);
-	}
+	if (face >= 0 && face < MAX_FACES)
+		dialContext -> dialConfig -> dirtyFaces |= ((guint64)1 << face);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  C I R C L E  G R A D I E N T                                                                             *
- *  =====================================                                                                             *
+ *  D I A L  Q U E U E  D I R T Y  F A C E S                                                                          *
+ *  ========================================                                                                          *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a circle with a gradient colour.
- *  \param size Size of the circle.
- *  \param colFill Colour to fill it with.
- *  \param style Direction of the gradent.
- *  \result None.
+ *  \brief Ask GTK to redraw only the faces that have been marked as changed, using the default context.
+ *  \result Number of faces queued.
  */
-void dialCircleGradient (int size, int colFill, int style)
+int dialQueueDirtyFaces (void)
 {
-	dialCircleGradientX (saveCentreX, saveCentreY, size, colFill, style);
+	return dialCtxQueueDirtyFaces (&defaultContext);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  C I R C L E  G R A D I E N T  X                                                                          *
- *  ========================================                                                                          *
+ *  D I A L  C T X  Q U E U E  D I R T Y  F A C E S                                                                   *
+ *  ===============================================                                                                   *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a circle with a gradient colour.
- *  \param posX Centre location of the circle.
- *  \param posY Centre location of the circle.
- *  \param size Size of the circle.
- *  \param colFill Colour to fill it with.
- *  \param style Direction of the gradent.
- *  \result None.
+ *  \brief Ask GTK to redraw only the faces of a dial that have been marked as changed.
+ *  \param dialContext Drawing context, the faces are queued on the drawing area of its dial config.
+ *  \result Number of faces queued.
  */
-void dialCircleGradientX (int posX, int posY, int size, int colFill, int style)
+int dialCtxQueueDirtyFaces (DIAL_CONTEXT *dialContext)
 {
-	cairo_pattern_t *pat;
-	int patSize = (dialConfig -> dialSize >> 1) + (posX > posY ? posX : posY), i;
-	int x = posX / dialConfig -> dialSize, y = posY / dialConfig -> dialSize, j = x + y, k = patSize / dialConfig -> dialSize;
-	float gradL = (float)(100 - dialConfig -> dialGradient) / 100.0;
-	float gradH = (float)(100 + dialConfig -> dialGradient) / 100.0;
-	float x1, x2, col[3][3];
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	int face, faceCount = config -> dialWidth * config -> dialHeight, queued = 0;
 
-#if GTK_MAJOR_VERSION == 2
-	col[0][0] = (float)dialColour(colFill) -> red / 65535.0;
-	col[1][0] = (float)dialColour(colFill) -> green / 65535.0;
-	col[2][0] = (float)dialColour(colFill) -> blue / 65535.0;
+	if (config -> drawingArea == NULL)
+	{
+		config -> dirtyFaces = 0;
+		return 0;
+	}
+	for (face = 0; face < faceCount && face < MAX_FACES && config -> dirtyFaces; ++face)
+	{
+		if (config -> dirtyFaces & ((guint64)1 << face))
+		{
+			gtk_widget_queue_draw_area (config -> drawingArea,
+					(face % config -> dialWidth) * config -> dialSize,
+					(face / config -> dialWidth) * config -> dialSize,
+					config -> dialSize, config -> dialSize);
+			config -> dirtyFaces &= ~((guint64)1 << face);
+			++queued;
+		}
+	}
+	config -> dirtyFaces = 0;
+	return queued;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  F A C E  I N  C L I P                                                                                    *
+ *  ==============================                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check if any of a face is inside the area being redrawn, using the default context.
+ *  \param cr Cairo context being drawn.
+ *  \param posX X position of the face.
+ *  \param posY Y position of the face.
+ *  \result True if the face needs drawing.
+ */
+bool dialFaceInClip (cairo_t *cr, int posX, int posY)
+{
+	return dialCtxFaceInClip (&defaultContext, cr, posX, posY);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  F A C E  I N  C L I P                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check if any of a face is inside the area being redrawn.
+ *  \param dialContext Drawing context.
+ *  \param cr Cairo context being drawn.
+ *  \param posX X position of the face.
+ *  \param posY Y position of the face.
+ *  \result True if the face needs drawing.
+ */
+bool dialCtxFaceInClip (DIAL_CONTEXT *dialContext, cairo_t *cr, int posX, int posY)
+{
+	int dialSize = dialContext -> dialConfig -> dialSize;
+	double x1, y1, x2, y2;
+
+	cairo_clip_extents (cr, &x1, &y1, &x2, &y2);
+	if (x2 <= posX || y2 <= posY || x1 >= posX + dialSize || y1 >= posY + dialSize)
+		return false;
+
+	return true;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C O L O U R  S U M                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make a checksum of the current colours, so a cached face knows if they changed.
+ *  \param config Dial config with the colours.
+ *  \result The checksum.
+ */
+unsigned int dialColourSum (DIAL_CONFIG *config)
+{
+	int i;
+	unsigned int sum = 2166136261u;
+
+	for (i = 0; i < dialMaxColours; ++i)
+	{
+		unsigned int j;
+		unsigned char *colBytes = (unsigned char *)&config -> colourDetails[i].dialColour;
+
+		for (j = 0; j < sizeof (config -> colourDetails[i].dialColour); ++j)
+		{
+			sum ^= colBytes[j];
+			sum *= 16777619u;
+		}
+	}
+	return sum;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  F A C E  C A C H E  S T A R T                                                                            *
+ *  ======================================                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Use the cached static part of a face, using the default context.
+ *  \param face Which face is being drawn, must be called after dialDrawStart.
+ *  \param faceKey String describing anything the caller draws that is not in the dial config.
+ *  \result True if the static part must be drawn followed by dialFaceCacheFinish, false if it was painted.
+ */
+bool dialFaceCacheStart (int face, char *faceKey)
+{
+	return dialCtxFaceCacheStart (&defaultContext, face, faceKey);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  F A C E  C A C H E  S T A R T                                                                     *
+ *  =============================================                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Use the cached static part of a face, or redirect drawing so it can be cached.
+ *  \param dialContext Drawing context.
+ *  \param face Which face is being drawn, must be called after dialCtxDrawStart.
+ *  \param faceKey String describing anything the caller draws that is not in the dial config.
+ *  \result True if the static part must be drawn followed by dialCtxFaceCacheFinish, false if it was painted.
+ */
+bool dialCtxFaceCacheStart (DIAL_CONTEXT *dialContext, int face, char *faceKey)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	FACE_CACHE *cache;
+	cairo_surface_t *target;
+	unsigned int colourSum;
+
+	dialContext -> cacheFace = -1;
+	if (face < 0 || face >= MAX_FACES || dialContext -> cacheCairo != NULL)
+		return true;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Vector output (saving an SVG) should not get a bitmap of the face                              *
+     *------------------------------------------------------------------------------------------------*/
+	target = cairo_get_target (dialContext -> cairo);
+	switch (cairo_surface_get_type (target))
+	{
+	case CAIRO_SURFACE_TYPE_SVG:
+	case CAIRO_SURFACE_TYPE_PDF:
+	case CAIRO_SURFACE_TYPE_PS:
+		return true;
+	default:
+		break;
+	}
+
+	if (config -> faceCache == NULL)
+	{
+		if ((config -> faceCache = (FACE_CACHE *)calloc (MAX_FACES, sizeof (FACE_CACHE))) == NULL)
+			return true;
+	}
+	cache = &config -> faceCache[face];
+	colourSum = dialColourSum (config);
+
+	if (cache -> surface != NULL &&
+			cache -> dialSize == config -> dialSize &&
+			cache -> dialGradient == config -> dialGradient &&
+			cache -> markerType == config -> markerType &&
+			cache -> markerStep == config -> markerStep &&
+			cache -> startPoint == config -> startPoint &&
+			cache -> colourSum == colourSum &&
+			cache -> faceKey != NULL && strcmp (cache -> faceKey, faceKey == NULL ? "" : faceKey) == 0)
+	{
+		cairo_set_source_surface (dialContext -> cairo, cache -> surface, dialContext -> posX, dialContext -> posY);
+		cairo_paint (dialContext -> cairo);
+		return false;
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * Out of date, so start again. Translate so callers can keep using window co-ordinates           *
+     *------------------------------------------------------------------------------------------------*/
+	dialCtxFaceCacheInvalidate (dialContext, face);
+	cache -> surface = cairo_surface_create_similar (target, CAIRO_CONTENT_COLOR_ALPHA,
+			config -> dialSize, config -> dialSize);
+	if (cairo_surface_status (cache -> surface) != CAIRO_STATUS_SUCCESS)
+	{
+		dialCtxFaceCacheInvalidate (dialContext, face);
+		return true;
+	}
+	cache -> faceKey = strdup (faceKey == NULL ? "" : faceKey);
+	cache -> dialSize = config -> dialSize;
+	cache -> dialGradient = config -> dialGradient;
+	cache -> markerType = config -> markerType;
+	cache -> markerStep = config -> markerStep;
+	cache -> startPoint = config -> startPoint;
+	cache -> colourSum = colourSum;
+
+	dialContext -> cacheCairo = cairo_create (cache -> surface);
+	cairo_translate (dialContext -> cacheCairo, -dialContext -> posX, -dialContext -> posY);
+	cairo_set_line_cap (dialContext -> cacheCairo, CAIRO_LINE_CAP_BUTT);
+	cairo_set_line_join (dialContext -> cacheCairo, CAIRO_LINE_JOIN_MITER);
+
+	dialContext -> cacheSaveCairo = dialContext -> cairo;
+	dialContext -> cairo = dialContext -> cacheCairo;
+	dialContext -> cacheFace = face;
+	return true;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  F A C E  C A C H E  F I N I S H                                                                          *
+ *  ========================================                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Finished drawing the static part of a face, using the default context.
+ *  \result None.
+ */
+void dialFaceCacheFinish (void)
+{
+	dialCtxFaceCacheFinish (&defaultContext);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  F A C E  C A C H E  F I N I S H                                                                   *
+ *  ===============================================                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Finished drawing the static part of a face, paint it and go back to the real context.
+ *  \param dialContext Drawing context.
+ *  \result None.
+ */
+void dialCtxFaceCacheFinish (DIAL_CONTEXT *dialContext)
+{
+	FACE_CACHE *faceCache = dialContext -> dialConfig -> faceCache;
+	int face = dialContext -> cacheFace;
+
+	if (dialContext -> cacheCairo == NULL)
+		return;
+
+	cairo_destroy (dialContext -> cacheCairo);
+	dialContext -> cacheCairo = NULL;
+	dialContext -> cairo = dialContext -> cacheSaveCairo;
+	dialContext -> cacheSaveCairo = NULL;
+
+	if (face != -1 && faceCache != NULL && faceCache[face].surface != NULL)
+	{
+		cairo_surface_flush (faceCache[face].surface);
+		cairo_set_source_surface (dialContext -> cairo, faceCache[face].surface, dialContext -> posX, dialContext -> posY);
+		cairo_paint (dialContext -> cairo);
+	}
+	dialContext -> cacheFace = -1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  F A C E  C A C H E  I N V A L I D A T E                                                                  *
+ *  ================================================                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Throw away the cached static part of a face, using the default context.
+ *  \param face Which face, or -1 for all of them.
+ *  \result None.
+ */
+void dialFaceCacheInvalidate (int face)
+{
+	dialCtxFaceCacheInvalidate (&defaultContext, face);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  F A C E  C A C H E  I N V A L I D A T E                                                           *
+ *  =======================================================                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Throw away the cached static part of a face, the gradients and sprites go too when all are thrown away.
+ *  \param dialContext Drawing context, the faces are those of its dial config.
+ *  \param face Which face, or -1 for all of them.
+ *  \result None.
+ */
+void dialCtxFaceCacheInvalidate (DIAL_CONTEXT *dialContext, int face)
+{
+	FACE_CACHE *faceCache = dialContext -> dialConfig -> faceCache;
+	int i;
+
+	for (i = 0; i < MAX_FACES && faceCache != NULL; ++i)
+	{
+		if (face != -1 && face != i)
+			continue;
+
+		if (faceCache[i].surface != NULL)
+		{
+			cairo_surface_destroy (faceCache[i].surface);
+			faceCache[i].surface = NULL;
+		}
+		if (faceCache[i].faceKey != NULL)
+		{
+			free (faceCache[i].faceKey);
+			faceCache[i].faceKey = NULL;
+		}
+	}
+	if (face == -1)
+	{
+		dialGradientFlush ();
+		dialHandSpriteFlush ();
+	}
+}
+
+#if GTK_MAJOR_VERSION == 2
+GdkColor
+#else
+GdkRGBA
+#endif
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  C O L O U R                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Get the colour value for a colour number from the context's config.
+ *  \param dialContext Drawing context.
+ *  \param i The number of the colour to find.
+ *  \result Pointer to the GtkColour.
+ */
+*dialCtxColour (DIAL_CONTEXT *dialContext, int i)
+{
+	if (i < 0 || i >= dialMaxColours)
+		return &dialContext -> dialConfig -> colourDetails[0].dialColour;
+
+	return &dialContext -> dialConfig -> colourDetails[i].dialColour;
+}
+
+#if GTK_MAJOR_VERSION == 2
+GdkColor
+#else
+GdkRGBA
+#endif
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C O L O U R                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Get the colour value for a colour number.
+ *  \param i The number of the colour to find.
+ *  \result Pointer to the GtkColour.
+ */
+*dialColour (int i)
+{
+	return dialCtxColour (&defaultContext, i);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  S E T  C O L O U R                                                                                *
+ *  ==================================                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Set the colour to use.
+ *  \param dialContext Drawing context.
+ *  \param i Which colour to set.
+ *  \result None.
+ */
+void dialCtxSetColour (DIAL_CONTEXT *dialContext, int i)
+{
+#if GTK_MAJOR_VERSION == 2
+	gdk_cairo_set_source_color (dialContext -> cairo, dialCtxColour (dialContext, i));
+#else
+	gdk_cairo_set_source_rgba (dialContext -> cairo, dialCtxColour (dialContext, i));
+#endif
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  W I N D O W  M A S K                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Create a mask for the dials.
+ *  \result None.
+ */
+void dialWindowMask (void)
+{
+#if GTK_MAJOR_VERSION == 2
+
+	int fullHeight, fullWidth, i, j;
+	GdkGC *gc;
+
+	fullHeight = dialConfig -> dialHeight * dialConfig -> dialSize;
+	fullWidth = dialConfig -> dialWidth * dialConfig -> dialSize;
+
+	if (windowShapeBitmap)
+	{
+		g_object_unref (windowShapeBitmap);
+		windowShapeBitmap = NULL;
+	}
+
+	windowShapeBitmap = (GdkBitmap *) gdk_pixmap_new (NULL, fullWidth, fullHeight, 1);
+
+	gc = gdk_gc_new (windowShapeBitmap);
+	gdk_gc_set_foreground (gc, dialColour (0));
+	gdk_gc_set_background (gc, dialColour (1));
+
+	gdk_draw_rectangle (windowShapeBitmap, gc, TRUE, 0, 0, fullWidth, fullHeight);
+
+	gdk_gc_set_foreground (gc, dialColour (1));
+	gdk_gc_set_background (gc, dialColour (0));
+
+	for (i = 0; i < dialConfig -> dialWidth; i++)
+	{
+		for (j = 0; j < dialConfig -> dialHeight; j++)
+			gdk_draw_arc (windowShapeBitmap, gc, TRUE, (i * dialConfig -> dialSize) - 1, (j * dialConfig -> dialSize) - 1,
+					dialConfig -> dialSize + 1, dialConfig -> dialSize + 1, 0, 360 * 64);
+	}
+	gtk_widget_shape_combine_mask (GTK_WIDGET (dialConfig -> mainWindow), windowShapeBitmap, 0, 0);
+	g_object_unref (gc);
+
+#else
+
+	cairo_t *cr;
+	cairo_surface_t *surface;
+	cairo_region_t *region;
+	int fullHeight, fullWidth, i, j;
+
+	fullHeight = dialConfig -> dialHeight * dialConfig -> dialSize;
+	fullWidth = dialConfig -> dialWidth * dialConfig -> dialSize;
+
+	surface = cairo_image_surface_create (CAIRO_FORMAT_A8, fullWidth, fullHeight);
+	cr = cairo_create (surface);
+	if (cairo_status (cr) == CAIRO_STATUS_SUCCESS)
+	{
+		for (i = 0; i < dialConfig -> dialWidth; i++)
+		{
+			for (j = 0; j < dialConfig -> dialHeight; j++)
+			{
+				int centerX = (dialConfig -> dialSize * i) + (dialConfig -> dialSize >> 1);
+				int centerY = (dialConfig -> dialSize * j) + (dialConfig -> dialSize >> 1);
+
+				cairo_set_source_rgba (cr, 0.0, 0.0, 0.0, 1.0);
+				cairo_arc (cr, centerX, centerY, (dialConfig -> dialSize * 64) >> 7, 0, 2 * M_PI);
+				cairo_fill (cr);
+				cairo_stroke (cr);
+			}
+		}
+		region = gdk_cairo_region_create_from_surface (surface);
+		gtk_widget_shape_combine_region (GTK_WIDGET (dialConfig -> mainWindow), region);
+		cairo_region_destroy (region);
+	}
+	cairo_destroy (cr);
+
+#endif
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  M I N U T E                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a small minute marker, using the default context.
+ *  \param size Size of the marker.
+ *  \param len Length of the marker.
+ *  \param angle Angle of the marker.
+ *  \param colour colour of the marker.
+ *  \result None.
+ */
+void dialDrawMinute (int size, int len, int angle, int colour)
+{
+	dialCtxDrawMinute (&defaultContext, size, len, angle, colour);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  M I N U T E                                                                              *
+ *  ====================================                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a small minute marker.
+ *  \param dialContext Drawing context.
+ *  \param size Size of the marker.
+ *  \param len Length of the marker.
+ *  \param angle Angle of the marker.
+ *  \param colour colour of the marker.
+ *  \result None.
+ */
+void dialCtxDrawMinute (DIAL_CONTEXT *dialContext, int size, int len, int angle, int colour)
+{
+	dialCtxDrawMinuteX (dialContext, dialContext -> centreX, dialContext -> centreY, size, len, angle, colour);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  M I N U T E  X                                                                                  *
+ *  ================================                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a small minute marker, using the default context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param size Size of the marker.
+ *  \param len Length of the marker.
+ *  \param angle Angle of the marker.
+ *  \param colour colour of the marker.
+ *  \result None.
+ */
+void dialDrawMinuteX (int posX, int posY, int size, int len, int angle, int colour)
+{
+	dialCtxDrawMinuteX (&defaultContext, posX, posY, size, len, angle, colour);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  M I N U T E  X                                                                           *
+ *  =======================================                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a small minute marker.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param size Size of the marker.
+ *  \param len Length of the marker.
+ *  \param angle Angle of the marker.
+ *  \param colour colour of the marker.
+ *  \result None.
+ */
+void dialCtxDrawMinuteX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int len, int angle, int colour)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+
+	cairo_set_line_width (cr, 1.0f + ((float)config -> dialSize / 512.0f));
+	dialCtxSetColour (dialContext, colour);
+	if (len < size)
+	{
+		cairo_move_to (cr,
+				posX + dialSin ((config -> dialSize * size) >> 6, angle),
+				posY - dialCos ((config -> dialSize * size) >> 6, angle));
+
+		cairo_line_to (cr,
+				posX + dialSin ((config -> dialSize * (size + len)) >> 6, angle),
+				posY - dialCos ((config -> dialSize * (size + len)) >> 6, angle));
+	}
+	else
+	{
+		cairo_move_to (cr,
+				posX + dialSin ((config -> dialSize * size) >> 6, angle + SCALE_2),
+				posY - dialCos ((config -> dialSize * size) >> 6, angle + SCALE_2));
+
+		cairo_line_to (cr,
+				posX + dialSin ((config -> dialSize * (size + len)) >> 6, angle),
+				posY - dialCos ((config -> dialSize * (size + len)) >> 6, angle));
+	}
+	cairo_stroke (cr);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  C I R C L E                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle on the dial, using the default context.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialDrawCircle (int size, int colFill, int colOut)
+{
+	dialCtxDrawCircle (&defaultContext, size, colFill, colOut);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  C I R C L E                                                                              *
+ *  ====================================                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle on the dial.
+ *  \param dialContext Drawing context.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialCtxDrawCircle (DIAL_CONTEXT *dialContext, int size, int colFill, int colOut)
+{
+	dialCtxDrawCircleX (dialContext, dialContext -> centreX, dialContext -> centreY, size, colFill, colOut);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  C I R C L E  X                                                                                  *
+ *  ================================                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle on the dial, using the default context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialDrawCircleX (int posX, int posY, int size, int colFill, int colOut)
+{
+	dialCtxDrawCircleX (&defaultContext, posX, posY, size, colFill, colOut);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  C I R C L E  X                                                                           *
+ *  =======================================                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle on the dial.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialCtxDrawCircleX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int colOut)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+	int trueSize = (config -> dialSize * size) >> 7;
+
+	cairo_set_line_width (cr, 1.0f + ((float)config -> dialSize / 256.0f));
+	if (colFill != -1)
+	{
+		dialCtxSetColour (dialContext, colFill);
+		cairo_arc (cr, posX, posY, trueSize, 0, 2 * M_PI);
+		cairo_fill (cr);
+		cairo_stroke (cr);
+	}
+	if (colOut != -1)
+	{
+		dialCtxSetColour (dialContext, colOut);
+		cairo_arc (cr, posX, posY, trueSize, 0, 2 * M_PI);
+		cairo_stroke (cr);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  P I X E L  A L I G N E D                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check that a bitmap can be painted onto the target without being resampled.
+ *  \param cr Cairo context to paint on.
+ *  \param scale Return the device scale of the target.
+ *  \result True if the target is a bitmap with a whole device scale and only moved by whole pixels.
+ */
+static bool dialPixelAligned (cairo_t *cr, double *scale)
+{
+	cairo_surface_t *target = cairo_get_target (cr);
+	double scaleX = 1.0, scaleY = 1.0;
+	cairo_matrix_t matrix;
+
+	switch (cairo_surface_get_type (target))
+	{
+	case CAIRO_SURFACE_TYPE_SVG:
+	case CAIRO_SURFACE_TYPE_PDF:
+	case CAIRO_SURFACE_TYPE_PS:
+		return false;
+	default:
+		break;
+	}
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1,14,0)
+	cairo_surface_get_device_scale (target, &scaleX, &scaleY);
+#endif
+	cairo_get_matrix (cr, &matrix);
+	if (scaleX != scaleY || scaleX != floor (scaleX) || matrix.xx != 1.0 || matrix.yy != 1.0 ||
+			matrix.xy != 0.0 || matrix.yx != 0.0 || matrix.x0 != floor (matrix.x0) ||
+			matrix.y0 != floor (matrix.y0))
+		return false;
+
+	*scale = scaleX;
+	return true;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  G R A D I E N T  F L U S H                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Throw away the cached gradients and discs, the colours or the size have changed.
+ *  \result None.
+ */
+static void dialGradientFlush (void)
+{
+	int i;
+
+	GRADIENT_LOCK ();
+	for (i = 0; i < DISC_CACHE_SIZE; ++i)
+	{
+		if (discCache[i].surface != NULL)
+			cairo_surface_destroy (discCache[i].surface);
+		if (discCache[i].pattern != NULL)
+			cairo_pattern_destroy (discCache[i].pattern);
+		memset (&discCache[i], 0, sizeof (DISC_CACHE));
+	}
+	for (i = 0; i < GRADIENT_CACHE_SIZE; ++i)
+	{
+		if (gradientCache[i].pattern != NULL)
+			cairo_pattern_destroy (gradientCache[i].pattern);
+		memset (&gradientCache[i], 0, sizeof (GRADIENT_CACHE));
+	}
+	GRADIENT_UNLOCK ();
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  G R A D I E N T  P A T T E R N                                                                           *
+ *  =======================================                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find the gradient for a fill, only make a new pattern if it is not in the cache, call with the lock held.
+ *  \param dialContext Drawing context.
+ *  \param colFill Colour to fill with.
+ *  \param style Direction of the gradient.
+ *  \param patSize Size of the pattern.
+ *  \param offset Place of the face on the grid, the pattern spans all the faces.
+ *  \param steps Number of faces the pattern spans.
+ *  \result The pattern, with a reference the caller must destroy.
+ */
+static cairo_pattern_t *dialGradientPattern (DIAL_CONTEXT *dialContext, int colFill, int style, int patSize,
+		int offset, int steps)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	GRADIENT_CACHE *entry = NULL;
+	float gradL, gradH, x1, x2, col[3][3];
+	int i;
+
+#if GTK_MAJOR_VERSION == 2
+	col[0][0] = (float)dialCtxColour (dialContext, colFill) -> red / 65535.0;
+	col[1][0] = (float)dialCtxColour (dialContext, colFill) -> green / 65535.0;
+	col[2][0] = (float)dialCtxColour (dialContext, colFill) -> blue / 65535.0;
+#else
+	col[0][0] = dialCtxColour (dialContext, colFill) -> red;
+	col[1][0] = dialCtxColour (dialContext, colFill) -> green;
+	col[2][0] = dialCtxColour (dialContext, colFill) -> blue;
+#endif
+
+	++gradientUseCount;
+	for (i = 0; i < GRADIENT_CACHE_SIZE; ++i)
+	{
+		entry = &gradientCache[i];
+		if (entry -> pattern != NULL && entry -> colFill == colFill && entry -> style == style &&
+				entry -> dialGradient == config -> dialGradient && entry -> patSize == patSize &&
+				entry -> offset == offset && entry -> steps == steps && entry -> colour[0] == col[0][0] &&
+				entry -> colour[1] == col[1][0] && entry -> colour[2] == col[2][0])
+		{
+			entry -> lastUsed = gradientUseCount;
+			return cairo_pattern_reference (entry -> pattern);
+		}
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * Not found so reuse the empty or least recently used entry                                      *
+     *------------------------------------------------------------------------------------------------*/
+	entry = &gradientCache[0];
+	for (i = 1; i < GRADIENT_CACHE_SIZE && entry -> pattern != NULL; ++i)
+	{
+		if (gradientCache[i].pattern == NULL || gradientCache[i].lastUsed < entry -> lastUsed)
+			entry = &gradientCache[i];
+	}
+	if (entry -> pattern != NULL)
+		cairo_pattern_destroy (entry -> pattern);
+
+	gradL = (float)(100 - config -> dialGradient) / 100.0;
+	gradH = (float)(100 + config -> dialGradient) / 100.0;
+	for (i = 0; i < 3; ++i)
+	{
+		col[i][1] = col[i][0] * (style ? gradH : gradL);
+		if (col[i][1] > 1) col[i][1] = 1;
+		col[i][2] = col[i][0] * (style ? gradL : gradH);
+		if (col[i][2] > 1) col[i][2] = 1;
+	}
+	entry -> pattern = cairo_pattern_create_linear (0.0, 0.0, patSize, patSize);
+
+	x1 = offset;
+	x1 /= (2 * steps);
+	x2 = x1 + ((float)1 / steps);
+
+	cairo_pattern_add_color_stop_rgb (entry -> pattern, x1, col[0][1], col[1][1], col[2][1]);
+	cairo_pattern_add_color_stop_rgb (entry -> pattern, x2, col[0][2], col[1][2], col[2][2]);
+
+	entry -> colFill = colFill;
+	entry -> style = style;
+	entry -> dialGradient = config -> dialGradient;
+	entry -> patSize = patSize;
+	entry -> offset = offset;
+	entry -> steps = steps;
+	for (i = 0; i < 3; ++i)
+		entry -> colour[i] = col[i][0];
+	entry -> lastUsed = gradientUseCount;
+	return cairo_pattern_reference (entry -> pattern);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  G R A D I E N T  D I S C                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find a bitmap of a circle filled with a gradient, call with the lock held.
+ *  \param dialContext Drawing context.
+ *  \param pattern Gradient to fill the circle with.
+ *  \param posX Centre location of the circle.
+ *  \param posY Centre location of the circle.
+ *  \param radius Radius of the circle.
+ *  \result The disc to paint at posX - radius - 1, posY - radius - 1, with a reference the caller must destroy,
+ *  NULL if the circle should be filled as a path.
+ */
+static cairo_surface_t *dialGradientDisc (DIAL_CONTEXT *dialContext, cairo_pattern_t *pattern, int posX, int posY,
+		int radius)
+{
+	cairo_t *cr = dialContext -> cairo, *discCr;
+	double scaleX;
+	DISC_CACHE *entry;
+	int i, discSize = (radius + 1) * 2;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Only use discs with a few faces so they are not pushed out of the cache on every frame         *
+     *------------------------------------------------------------------------------------------------*/
+	if (dialContext -> dialConfig -> dialWidth * dialContext -> dialConfig -> dialHeight * 3 > DISC_CACHE_SIZE)
+		return NULL;
+	if (!dialPixelAligned (cr, &scaleX))
+		return NULL;
+
+	++gradientUseCount;
+	for (i = 0; i < DISC_CACHE_SIZE; ++i)
+	{
+		entry = &discCache[i];
+		if (entry -> surface != NULL && entry -> pattern == pattern && entry -> posX == posX &&
+				entry -> posY == posY && entry -> radius == radius && entry -> scale == scaleX)
+		{
+			entry -> lastUsed = gradientUseCount;
+			return cairo_surface_reference (entry -> surface);
+		}
+	}
+
+	entry = &discCache[0];
+	for (i = 1; i < DISC_CACHE_SIZE && entry -> surface != NULL; ++i)
+	{
+		if (discCache[i].surface == NULL || discCache[i].lastUsed < entry -> lastUsed)
+			entry = &discCache[i];
+	}
+	if (entry -> surface != NULL)
+		cairo_surface_destroy (entry -> surface);
+	if (entry -> pattern != NULL)
+		cairo_pattern_destroy (entry -> pattern);
+	memset (entry, 0, sizeof (DISC_CACHE));
+
+	entry -> surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, (int)(discSize * scaleX),
+			(int)(discSize * scaleX));
+	if (cairo_surface_status (entry -> surface) != CAIRO_STATUS_SUCCESS)
+	{
+		cairo_surface_destroy (entry -> surface);
+		entry -> surface = NULL;
+		return NULL;
+	}
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1,14,0)
+	cairo_surface_set_device_scale (entry -> surface, scaleX, scaleX);
+#endif
+
+	/*------------------------------------------------------------------------------------------------*
+     * Draw in face coordinates so the disc gets the same part of the gradient as a filled path       *
+     *------------------------------------------------------------------------------------------------*/
+	discCr = cairo_create (entry -> surface);
+	cairo_translate (discCr, radius + 1 - posX, radius + 1 - posY);
+	cairo_arc (discCr, posX, posY, radius, 0, 2 * M_PI);
+	cairo_set_source (discCr, pattern);
+	cairo_fill (discCr);
+	cairo_destroy (discCr);
+	cairo_surface_flush (entry -> surface);
+
+	entry -> pattern = cairo_pattern_reference (pattern);
+	entry -> posX = posX;
+	entry -> posY = posY;
+	entry -> radius = radius;
+	entry -> scale = scaleX;
+	entry -> lastUsed = gradientUseCount;
+	return cairo_surface_reference (entry -> surface);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C I R C L E  G R A D I E N T                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle with a gradient colour, using the default context.
+ *  \param size Size of the circle.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradent.
+ *  \result None.
+ */
+void dialCircleGradient (int size, int colFill, int style)
+{
+	dialCtxCircleGradient (&defaultContext, size, colFill, style);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  C I R C L E  G R A D I E N T                                                                      *
+ *  ============================================                                                                      *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle with a gradient colour.
+ *  \param dialContext Drawing context.
+ *  \param size Size of the circle.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradent.
+ *  \result None.
+ */
+void dialCtxCircleGradient (DIAL_CONTEXT *dialContext, int size, int colFill, int style)
+{
+	dialCtxCircleGradientX (dialContext, dialContext -> centreX, dialContext -> centreY, size, colFill, style);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C I R C L E  G R A D I E N T  X                                                                          *
+ *  ========================================                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle with a gradient colour, using the default context.
+ *  \param posX Centre location of the circle.
+ *  \param posY Centre location of the circle.
+ *  \param size Size of the circle.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradent.
+ *  \result None.
+ */
+void dialCircleGradientX (int posX, int posY, int size, int colFill, int style)
+{
+	dialCtxCircleGradientX (&defaultContext, posX, posY, size, colFill, style);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  C I R C L E  G R A D I E N T  X                                                                   *
+ *  ===============================================                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a circle with a gradient colour.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre location of the circle.
+ *  \param posY Centre location of the circle.
+ *  \param size Size of the circle.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradent.
+ *  \result None.
+ */
+void dialCtxCircleGradientX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int style)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+	cairo_pattern_t *pat;
+	cairo_surface_t *disc = NULL;
+	int patSize = (config -> dialSize >> 1) + (posX > posY ? posX : posY);
+	int x = posX / config -> dialSize, y = posY / config -> dialSize, j = x + y, k = patSize / config -> dialSize;
+	int radius = (config -> dialSize * size) >> 7;
+
+	GRADIENT_LOCK ();
+	pat = dialGradientPattern (dialContext, colFill, style, patSize, j, k);
+	if (size == 64 || size == 62 || size == 58)
+		disc = dialGradientDisc (dialContext, pat, posX, posY, radius);
+	GRADIENT_UNLOCK ();
+
+	if (disc != NULL)
+	{
+		cairo_set_source_surface (cr, disc, posX - radius - 1, posY - radius - 1);
+		cairo_paint (cr);
+		cairo_surface_destroy (disc);
+	}
+	else
+	{
+		cairo_arc (cr, posX, posY, radius, 0, 2 * M_PI);
+		cairo_set_source (cr, pat);
+		cairo_fill (cr);
+		cairo_stroke (cr);
+	}
+	cairo_pattern_destroy (pat);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  S Q U A R E  G R A D I E N T                                                                             *
+ *  =====================================                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square with a gradient colour, using the default context.
+ *  \param size Size of the square.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradent.
+ *  \result None.
+ */
+void dialSquareGradient (int size, int colFill, int style)
+{
+	dialCtxSquareGradient (&defaultContext, size, colFill, style);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  S Q U A R E  G R A D I E N T                                                                      *
+ *  ============================================                                                                      *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square with a gradient colour.
+ *  \param dialContext Drawing context.
+ *  \param size Size of the square.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradent.
+ *  \result None.
+ */
+void dialCtxSquareGradient (DIAL_CONTEXT *dialContext, int size, int colFill, int style)
+{
+	dialCtxSquareGradientX (dialContext, dialContext -> posX, dialContext -> posY, size, colFill, style);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  S Q U A R E  G R A D I E N T  X                                                                          *
+ *  ========================================                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square with a gradient colour, using the default context.
+ *  \param posX Top left corner position X.
+ *  \param posY Top left corner position Y.
+ *  \param size Size of the square.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradient.
+ *  \result None.
+ */
+void dialSquareGradientX (int posX, int posY, int size, int colFill, int style)
+{
+	dialCtxSquareGradientX (&defaultContext, posX, posY, size, colFill, style);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  S Q U A R E  G R A D I E N T  X                                                                   *
+ *  ===============================================                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square with a gradient colour.
+ *  \param dialContext Drawing context.
+ *  \param posX Top left corner position X.
+ *  \param posY Top left corner position Y.
+ *  \param size Size of the square.
+ *  \param colFill Colour to fill it with.
+ *  \param style Direction of the gradient.
+ *  \result None.
+ */
+void dialCtxSquareGradientX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int style)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+	cairo_pattern_t *pat;
+	int trueSize = (config -> dialSize * size) >> 6;
+	int patSize = config -> dialSize + (posX > posY ? posX : posY);
+	int x = posX / config -> dialSize, y = posY / config -> dialSize, j = x + y, k = patSize / config -> dialSize;
+
+	GRADIENT_LOCK ();
+	pat = dialGradientPattern (dialContext, colFill, style, patSize, j, k);
+	GRADIENT_UNLOCK ();
+
+	cairo_rectangle (cr, posX, posY, trueSize, trueSize);
+	cairo_set_source(cr, pat);
+/*  dialCtxSetColour (dialContext, colFill); */
+	cairo_fill (cr);
+	cairo_stroke (cr);
+
+	cairo_pattern_destroy (pat);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H O T  C O L D                                                                                           *
+ *  =======================                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Display Hot and cold markers, using the default context.
+ *  \param size Radius of the marker.
+ *  \param colFill Colour of the marker.
+ *  \param cold Hot or Cold, 1 = cold.
+ *  \result None.
+ */
+void dialHotCold (int size, int colFill, int cold)
+{
+	dialCtxHotCold (&defaultContext, size, colFill, cold);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  H O T  C O L D                                                                                    *
+ *  ==============================                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Display Hot and cold markers.
+ *  \param dialContext Drawing context.
+ *  \param size Radius of the marker.
+ *  \param colFill Colour of the marker.
+ *  \param cold Hot or Cold, 1 = cold.
+ *  \result None.
+ */
+void dialCtxHotCold (DIAL_CONTEXT *dialContext, int size, int colFill, int cold)
+{
+	dialCtxHotColdX (dialContext, dialContext -> centreX, dialContext -> centreY, size, colFill, cold);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H O T  C O L D  X                                                                                        *
+ *  ==========================                                                                                        *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Display Hot and cold markers, using the default context.
+ *  \param posX Centre posision.
+ *  \param posY Centre posision.
+ *  \param size Radius of the marker.
+ *  \param colFill Colour of the marker.
+ *  \param cold Hot or Cold, 1 = cold.
+ *  \result None.
+ */
+void dialHotColdX (int posX, int posY, int size, int colFill, int cold)
+{
+	dialCtxHotColdX (&defaultContext, posX, posY, size, colFill, cold);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  H O T  C O L D  X                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Display Hot and cold markers.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre posision.
+ *  \param posY Centre posision.
+ *  \param size Radius of the marker.
+ *  \param colFill Colour of the marker.
+ *  \param cold Hot or Cold, 1 = cold.
+ *  \result None.
+ */
+void dialCtxHotColdX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int cold)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+	int trueSize = (config -> dialSize * size) >> 7;
+
+	cairo_set_line_width (cr, 1.0f + ((float)config -> dialSize / 18.0f));
+	dialCtxSetColour (dialContext, colFill);
+	if (cold)
+		cairo_arc (cr, posX, posY, trueSize, (M_PI * 3) / 4, M_PI);
+	else
+		cairo_arc (cr, posX, posY, trueSize, 0, M_PI / 4);
+	cairo_stroke (cr);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  S Q U A R E                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square on the dial, using the default context.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialDrawSquare (int size, int colFill, int colOut)
+{
+	dialCtxDrawSquare (&defaultContext, size, colFill, colOut);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  S Q U A R E                                                                              *
+ *  ====================================                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square on the dial.
+ *  \param dialContext Drawing context.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialCtxDrawSquare (DIAL_CONTEXT *dialContext, int size, int colFill, int colOut)
+{
+	dialCtxDrawSquareX (dialContext, dialContext -> posX, dialContext -> posY, size, colFill, colOut);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  S Q U A R E  X                                                                                  *
+ *  ================================                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square on the dial, using the default context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialDrawSquareX (int posX, int posY, int size, int colFill, int colOut)
+{
+	dialCtxDrawSquareX (&defaultContext, posX, posY, size, colFill, colOut);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  S Q U A R E  X                                                                           *
+ *  =======================================                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a square on the dial.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \result None.
+ */
+void dialCtxDrawSquareX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int colOut)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+	int trueSize = (config -> dialSize * size) >> 6;
+
+	cairo_set_line_width (cr, 1.0f + ((float)config -> dialSize / 256.0f));
+	if (colFill != -1)
+	{
+		dialCtxSetColour (dialContext, colFill);
+		cairo_rectangle (cr, posX, posY, trueSize, trueSize);
+		cairo_fill (cr);
+		cairo_stroke (cr);
+	}
+	if (colOut != -1)
+	{
+		dialCtxSetColour (dialContext, colOut);
+		cairo_rectangle (cr, posX, posY, trueSize, trueSize);
+		cairo_stroke (cr);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H A N D  G E O M E T R Y                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find the points of a hand, only working them out again if the hand has moved or changed.
+ *  \param dialContext Drawing context, it keeps the last few hands drawn with it.
+ *  \param angle Angle of the hand, already in the range of the tables.
+ *  \param handStyle Style of the hand.
+ *  \result The points of the hand relative to its centre.
+ */
+static HAND_GEOMETRY *dialHandGeometry (DIAL_CONTEXT *dialContext, int angle, HAND_STYLE *handStyle)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	HAND_GEOMETRY *geometry;
+	const HAND_SHAPE *shape;
+	const unsigned char *radius;
+	long sinQ[4], cosQ[4], length[HAND_LEN_COUNT];
+	int i, quarter;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Faces share hand styles, so match on what the points depend on and not on the style used       *
+     *------------------------------------------------------------------------------------------------*/
+	for (i = 0; i < HAND_CACHE_SIZE; ++i)
+	{
+		geometry = &dialContext -> handCache[i];
+		if (geometry -> numPoints && geometry -> angle == angle && geometry -> dialSize == config -> dialSize &&
+				geometry -> style == handStyle -> style && geometry -> length == handStyle -> length &&
+				geometry -> tail == handStyle -> tail)
+			return geometry;
+	}
+	geometry = &dialContext -> handCache[dialContext -> handNext];
+	dialContext -> handNext = (dialContext -> handNext + 1) % HAND_CACHE_SIZE;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Read the tables once for each quarter turn, then every point is two multiplies per axis        *
+     *------------------------------------------------------------------------------------------------*/
+	for (quarter = 0; quarter < 4; ++quarter)
+	{
+		i = angle + quarter * SCALE_1;
+		if (i >= SCALE_4) i -= SCALE_4;
+		sinQ[quarter] = sinTable[i];
+		cosQ[quarter] = cosTable[i];
+	}
+	length[HAND_LEN_NONE] = 0;
+	length[HAND_LEN_ONE] = config -> dialSize >> 6;
+	length[HAND_LEN_TAIL] = (config -> dialSize * handStyle -> tail) >> 6;
+	length[HAND_LEN_SIZE] = (config -> dialSize * handStyle -> length) >> 6;
+	length[HAND_LEN_SIZE15] = (config -> dialSize * (handStyle -> length * 15)) >> 10;
+	length[HAND_LEN_SIZE12] = (config -> dialSize * (handStyle -> length * 12)) >> 10;
+	length[HAND_LEN_30] = config -> dialSize / 30;
+	length[HAND_LEN_40] = config -> dialSize / 40;
+
+	shape = &handShapes[handStyle -> style >= 0 && handStyle -> style <= 5 ? handStyle -> style : 6];
+	for (i = 0; i < shape -> numPoints; ++i)
+	{
+		radius = shape -> radii[i];
+		geometry -> points[i << 1] = (int)((length[radius[0]] * sinQ[radius[1]] +
+				length[radius[2]] * sinQ[radius[3]] + SIN_COS_ROUND) >> SIN_COS_SHIFT);
+		geometry -> points[(i << 1) + 1] = (int)((SIN_COS_ROUND - length[radius[0]] * cosQ[radius[1]] -
+				length[radius[2]] * cosQ[radius[3]]) >> SIN_COS_SHIFT);
+	}
+
+	geometry -> dialSize = config -> dialSize;
+	geometry -> style = handStyle -> style;
+	geometry -> length = handStyle -> length;
+	geometry -> tail = handStyle -> tail;
+	geometry -> angle = angle;
+	geometry -> numPoints = shape -> numPoints;
+	return geometry;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H A N D  P A T H                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Fill and outline a hand.
+ *  \param dialContext Drawing context, used for the config and colours.
+ *  \param cr Cairo context to draw on, the face or a sprite.
+ *  \param posX Centre of the hand.
+ *  \param posY Centre of the hand.
+ *  \param geometry Points of the hand.
+ *  \param handStyle Style of the hand.
+ *  \result None.
+ */
+static void dialHandPath (DIAL_CONTEXT *dialContext, cairo_t *cr, int posX, int posY, HAND_GEOMETRY *geometry,
+		HAND_STYLE *handStyle)
+{
+	int i, j, fill = handStyle -> fillIn && geometry -> numPoints > 2;
+
+	cairo_set_line_width (cr, 1.0f + ((float)dialContext -> dialConfig -> dialSize / 256.0f));
+	for (i = 0; i < 2; i++)
+	{
+		if (i != 0 || fill)
+		{
+#if GTK_MAJOR_VERSION == 2
+			gdk_cairo_set_source_color (cr, dialCtxColour (dialContext, i == 0 ? handStyle -> fill : handStyle -> line));
 #else
-	col[0][0] = dialColour(colFill) -> red;
-	col[1][0] = dialColour(colFill) -> green;
-	col[2][0] = dialColour(colFill) -> blue;
+			gdk_cairo_set_source_rgba (cr, dialCtxColour (dialContext, i == 0 ? handStyle -> fill : handStyle -> line));
+#endif
+			cairo_move_to (cr, posX + geometry -> points[0], posY + geometry -> points[1]);
+			for (j = 1; j < geometry -> numPoints; j++)
+				cairo_line_to (cr, posX + geometry -> points[j << 1], posY + geometry -> points[(j << 1) + 1]);
+			if (geometry -> numPoints > 2)
+				cairo_close_path (cr);
+			if (i == 0)
+				cairo_fill (cr);
+			cairo_stroke (cr);
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H A N D  S P R I T E  F R E E                                                                            *
+ *  ======================================                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free the sprites of one hand, must be called with the lock held.
+ *  \param sprite Sprites to free.
+ *  \result None.
+ */
+static void dialHandSpriteFree (HAND_SPRITE *sprite)
+{
+	int i;
+
+	for (i = 0; i < SCALE_4; ++i)
+	{
+		if (sprite -> bank[i] != NULL)
+		{
+			handSpriteBytes -= (long)cairo_image_surface_get_stride (sprite -> bank[i]) *
+					cairo_image_surface_get_height (sprite -> bank[i]);
+			cairo_surface_destroy (sprite -> bank[i]);
+		}
+	}
+	if (sprite -> base != NULL)
+		cairo_surface_destroy (sprite -> base);
+	memset (sprite, 0, sizeof (HAND_SPRITE));
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H A N D  S P R I T E  F L U S H                                                                          *
+ *  ========================================                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Throw away all the hand sprites, the colours or the size have changed.
+ *  \result None.
+ */
+static void dialHandSpriteFlush (void)
+{
+	int i;
+
+	SPRITE_LOCK ();
+	for (i = 0; i < SPRITE_HANDS; ++i)
+		dialHandSpriteFree (&handSprites[i]);
+	handSpriteBytes = 0;
+	SPRITE_UNLOCK ();
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H A N D  S P R I T E  R E N D E R                                                                        *
+ *  ==========================================                                                                        *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a hand at one angle into a bitmap just big enough to hold it.
+ *  \param dialContext Drawing context.
+ *  \param angle Angle of the hand.
+ *  \param handStyle Style of the hand.
+ *  \param scale Device scale of the face.
+ *  \param offsetX Return where the bitmap goes relative to the centre of the hand.
+ *  \param offsetY Return where the bitmap goes relative to the centre of the hand.
+ *  \result The bitmap, NULL if it could not be made.
+ */
+static cairo_surface_t *dialHandSpriteRender (DIAL_CONTEXT *dialContext, int angle, HAND_STYLE *handStyle,
+		double scale, int *offsetX, int *offsetY)
+{
+	HAND_GEOMETRY *geometry = dialHandGeometry (dialContext, angle, handStyle);
+	cairo_surface_t *surface;
+	cairo_t *cr;
+	int i, minX, minY, maxX, maxY;
+	int pad = 2 + (int)(5.0 * (1.0 + ((double)dialContext -> dialConfig -> dialSize / 256.0)));
+
+	minX = maxX = geometry -> points[0];
+	minY = maxY = geometry -> points[1];
+	for (i = 1; i < geometry -> numPoints; ++i)
+	{
+		if (geometry -> points[i << 1] < minX) minX = geometry -> points[i << 1];
+		if (geometry -> points[i << 1] > maxX) maxX = geometry -> points[i << 1];
+		if (geometry -> points[(i << 1) + 1] < minY) minY = geometry -> points[(i << 1) + 1];
+		if (geometry -> points[(i << 1) + 1] > maxY) maxY = geometry -> points[(i << 1) + 1];
+	}
+	/*------------------------------------------------------------------------------------------------*
+     * Leave room for the outline, mitred corners can reach five line widths past a point             *
+     *------------------------------------------------------------------------------------------------*/
+	minX -= pad;
+	minY -= pad;
+	maxX += pad;
+	maxY += pad;
+
+	surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, (int)((maxX - minX) * scale),
+			(int)((maxY - minY) * scale));
+	if (cairo_surface_status (surface) != CAIRO_STATUS_SUCCESS)
+	{
+		cairo_surface_destroy (surface);
+		return NULL;
+	}
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1,14,0)
+	cairo_surface_set_device_scale (surface, scale, scale);
 #endif
+	cr = cairo_create (surface);
+	dialHandPath (dialContext, cr, -minX, -minY, geometry, handStyle);
+	cairo_destroy (cr);
+	cairo_surface_flush (surface);
 
-	for (i = 0; i < 3; ++i)
+	*offsetX = minX;
+	*offsetY = minY;
+	return surface;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  H A N D  S P R I T E  D R A W                                                                            *
+ *  ======================================                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a hand from its sprites.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre of the hand.
+ *  \param posY Centre of the hand.
+ *  \param angle Angle of the hand, already in the range of the tables.
+ *  \param handStyle Style of the hand.
+ *  \result True if the hand was drawn, false if it must be drawn as a path.
+ */
+static bool dialHandSpriteDraw (DIAL_CONTEXT *dialContext, int posX, int posY, int angle, HAND_STYLE *handStyle)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+	HAND_SPRITE *sprite = NULL;
+	cairo_surface_t *surface = NULL;
+	double scale;
+	int i, offsetX = 0, offsetY = 0;
+	bool rotate = false;
+
+	if (!dialPixelAligned (cr, &scale))
+		return false;
+
+	SPRITE_LOCK ();
+	for (i = 0; i < SPRITE_HANDS; ++i)
 	{
-		col[i][1] = col[i][0] * (style ? gradH : gradL);
-		if (col[i][1] > 1) col[i][1] = 1;
-		col[i][2] = col[i][0] * (style ? gradL : gradH);
-		if (col[i][2] > 1) col[i][2] = 1;
+		if (handSprites[i].handStyle == handStyle)
+		{
+			sprite = &handSprites[i];
+			break;
+		}
+	}
+	if (sprite == NULL)
+	{
+		sprite = &handSprites[handSpriteNext];
+		handSpriteNext = (handSpriteNext + 1) % SPRITE_HANDS;
+		dialHandSpriteFree (sprite);
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * Start again if the hand or its colours have changed since the sprites were drawn               *
+     *------------------------------------------------------------------------------------------------*/
+	if (sprite -> handStyle != handStyle || sprite -> dialSize != config -> dialSize ||
+			sprite -> style != handStyle -> style || sprite -> length != handStyle -> length ||
+			sprite -> tail != handStyle -> tail || sprite -> fillIn != handStyle -> fillIn ||
+			sprite -> scale != scale ||
+			memcmp (&sprite -> fillColour, dialCtxColour (dialContext, handStyle -> fill), sizeof (DIAL_COLOUR)) ||
+			memcmp (&sprite -> lineColour, dialCtxColour (dialContext, handStyle -> line), sizeof (DIAL_COLOUR)))
+	{
+		dialHandSpriteFree (sprite);
+		sprite -> handStyle = handStyle;
+		sprite -> dialSize = config -> dialSize;
+		sprite -> style = handStyle -> style;
+		sprite -> length = handStyle -> length;
+		sprite -> tail = handStyle -> tail;
+		sprite -> fillIn = handStyle -> fillIn;
+		sprite -> scale = scale;
+		memcpy (&sprite -> fillColour, dialCtxColour (dialContext, handStyle -> fill), sizeof (DIAL_COLOUR));
+		memcpy (&sprite -> lineColour, dialCtxColour (dialContext, handStyle -> line), sizeof (DIAL_COLOUR));
 	}
-	pat = cairo_pattern_create_linear (0.0, 0.0, patSize, patSize);
 
-	x1 = j;
-	x1 /= (2 * k);
-	x2 = x1 + ((float)1 / k);
+	if (sprite -> bank[angle] == NULL && handSpriteBytes < SPRITE_BUDGET)
+	{
+		sprite -> bank[angle] = dialHandSpriteRender (dialContext, angle, handStyle, scale,
+				&sprite -> bankX[angle], &sprite -> bankY[angle]);
+		if (sprite -> bank[angle] != NULL)
+		{
+			handSpriteBytes += (long)cairo_image_surface_get_stride (sprite -> bank[angle]) *
+					cairo_image_surface_get_height (sprite -> bank[angle]);
+		}
+	}
+	if (sprite -> bank[angle] != NULL)
+	{
+		surface = cairo_surface_reference (sprite -> bank[angle]);
+		offsetX = sprite -> bankX[angle];
+		offsetY = sprite -> bankY[angle];
+	}
+	else
+	{
+		if (sprite -> base == NULL)
+		{
+			sprite -> base = dialHandSpriteRender (dialContext, 0, handStyle, scale,
+					&sprite -> baseX, &sprite -> baseY);
+		}
+		if (sprite -> base != NULL)
+		{
+			surface = cairo_surface_reference (sprite -> base);
+			offsetX = sprite -> baseX;
+			offsetY = sprite -> baseY;
+			rotate = true;
+		}
+	}
+	SPRITE_UNLOCK ();
 
-	cairo_pattern_add_color_stop_rgb (pat, x1, col[0][1], col[1][1], col[2][1]);
-	cairo_pattern_add_color_stop_rgb (pat, x2, col[0][2], col[1][2], col[2][2]);
-	cairo_arc (saveCairo, posX, posY, (dialConfig -> dialSize * size) >> 7, 0, 2 * M_PI);
-	cairo_set_source (saveCairo, pat);
-	cairo_fill (saveCairo);
-	cairo_stroke (saveCairo);
+	if (surface == NULL)
+		return false;
 
-	cairo_pattern_destroy (pat);
+	if (rotate)
+	{
+		cairo_save (cr);
+		cairo_translate (cr, posX, posY);
+		cairo_rotate (cr, (angle * M_PI) / SCALE_2);
+		cairo_set_source_surface (cr, surface, offsetX, offsetY);
+		cairo_paint (cr);
+		cairo_restore (cr);
+	}
+	else
+	{
+		cairo_set_source_surface (cr, surface, posX + offsetX, posY + offsetY);
+		cairo_paint (cr);
+	}
+	cairo_surface_destroy (surface);
+	return true;
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  S Q U A R E  G R A D I E N T                                                                             *
- *  =====================================                                                                             *
+ *  D I A L  D R A W  H A N D                                                                                         *
+ *  =========================                                                                                         *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a square with a gradient colour.
- *  \param size Size of the square.
- *  \param colFill Colour to fill it with.
- *  \param style Direction of the gradent.
+ *  \brief Draw a hand on the dial, using the default context.
+ *  \param angle Angle of the hand.
+ *  \param handStyle Style structure of the hand.
  *  \result None.
  */
-void dialSquareGradient (int size, int colFill, int style)
+void dialDrawHand (int angle, HAND_STYLE *handStyle)
 {
-	dialSquareGradientX (savePosX, savePosY, size, colFill, style);
+	dialCtxDrawHand (&defaultContext, angle, handStyle);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  S Q U A R E  G R A D I E N T  X                                                                          *
- *  ========================================                                                                          *
+ *  D I A L  C T X  D R A W  H A N D                                                                                  *
+ *  ================================                                                                                  *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a square with a gradient colour.
- *  \param posX Top left corner position X.
- *  \param posY Top left corner position Y.
- *  \param size Size of the square.
- *  \param colFill Colour to fill it with.
- *  \param style Direction of the gradient.
+ *  \brief Draw a hand on the dial.
+ *  \param dialContext Drawing context.
+ *  \param angle Angle of the hand.
+ *  \param handStyle Style structure of the hand.
  *  \result None.
  */
-void dialSquareGradientX (int posX, int posY, int size, int colFill, int style)
+void dialCtxDrawHand (DIAL_CONTEXT *dialContext, int angle, HAND_STYLE *handStyle)
 {
-	cairo_pattern_t *pat;
-	int trueSize = (dialConfig -> dialSize * size) >> 6;
-	int patSize = dialConfig -> dialSize + (posX > posY ? posX : posY), i;
-	int x = posX / dialConfig -> dialSize, y = posY / dialConfig -> dialSize, j = x + y, k = patSize / dialConfig -> dialSize;
-	float gradL = (float)(100 - dialConfig -> dialGradient) / 100.0;
-	float gradH = (float)(100 + dialConfig -> dialGradient) / 100.0;
-	float x1, x2, col[3][3];
+	dialCtxDrawHandX (dialContext, dialContext -> centreX, dialContext -> centreY, angle, handStyle);
+}
 
-#if GTK_MAJOR_VERSION == 2
-	col[0][0] = (float)dialColour(colFill) -> red / 65535.0;
-	col[1][0] = (float)dialColour(colFill) -> green / 65535.0;
-	col[2][0] = (float)dialColour(colFill) -> blue / 65535.0;
-#else
-	col[0][0] = dialColour(colFill) -> red;
-	col[1][0] = dialColour(colFill) -> green;
-	col[2][0] = dialColour(colFill) -> blue;
-#endif
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  H A N D  X                                                                                      *
+ *  ============================                                                                                      *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a hand on the dial, using the default context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param angle Angle of the hand.
+ *  \param handStyle Style structure of the hand.
+ *  \result None.
+ */
+void dialDrawHandX (int posX, int posY, int angle, HAND_STYLE *handStyle)
+{
+	dialCtxDrawHandX (&defaultContext, posX, posY, angle, handStyle);
+}
 
-	for (i = 0; i < 3; ++i)
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  H A N D  X                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a hand on the dial.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param angle Angle of the hand.
+ *  \param handStyle Style structure of the hand.
+ *  \result None.
+ */
+void dialCtxDrawHandX (DIAL_CONTEXT *dialContext, int posX, int posY, int angle, HAND_STYLE *handStyle)
+{
+	if (handStyle -> gauge)
 	{
-		col[i][1] = col[i][0] * (style ? gradH : gradL);
-		if (col[i][1] > 1) col[i][1] = 1;
-		col[i][2] = col[i][0] * (style ? gradL : gradH);
-		if (col[i][2] > 1) col[i][2] = 1;
+		if (angle < 0) angle = 0;
+		if (angle >= SCALE_4) angle = SCALE_4 - 1;
+	}
+	else
+	{
+		while (angle < 0) angle += SCALE_4;
+		while (angle >= SCALE_4) angle -= SCALE_4;
 	}
-	pat = cairo_pattern_create_linear (0.0, 0.0, patSize, patSize);
 
-	x1 = j;
-	x1 /= (2 * k);
-	x2 = x1 + ((float)1 / k);
+	if (dialContext -> dialConfig -> handSprites && dialHandSpriteDraw (dialContext, posX, posY, angle, handStyle))
+		return;
 
-	cairo_pattern_add_color_stop_rgb (pat, x1, col[0][1], col[1][1], col[2][1]);
-	cairo_pattern_add_color_stop_rgb (pat, x2, col[0][2], col[1][2], col[2][2]);
-	cairo_rectangle (saveCairo, posX, posY, trueSize, trueSize);
-	cairo_set_source(saveCairo, pat);
-/*  dialSetColour (colFill); */
-	cairo_fill (saveCairo);
-	cairo_stroke (saveCairo);
+	dialHandPath (dialContext, dialContext -> cairo, posX, posY, dialHandGeometry (dialContext, angle, handStyle),
+			handStyle);
+}
 
-	cairo_pattern_destroy (pat);
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  M A R K                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a shaped marker on the dial, using the default context.
+ *  \param angle Angle of the marker.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \param text Text to display on the mark.
+ *  \result None.
+ */
+void dialDrawMark (int angle, int size, int colFill, int colOut, char *text)
+{
+	dialCtxDrawMark (&defaultContext, angle, size, colFill, colOut, text);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  H O T  C O L D                                                                                           *
- *  =======================                                                                                           *
+ *  D I A L  C T X  D R A W  M A R K                                                                                  *
+ *  ================================                                                                                  *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Display Hot and cold markers.
- *  \param size Radius of the marker.
- *  \param colFill Colour of the marker.
- *  \param cold Hot or Cold, 1 = cold.
+ *  \brief Draw a shaped marker on the dial.
+ *  \param dialContext Drawing context.
+ *  \param angle Angle of the marker.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \param text Text to display on the mark.
  *  \result None.
  */
-void dialHotCold (int size, int colFill, int cold)
+void dialCtxDrawMark (DIAL_CONTEXT *dialContext, int angle, int size, int colFill, int colOut, char *text)
 {
-	dialHotColdX (saveCentreX, saveCentreY, size, colFill, cold);
+	dialCtxDrawMarkX (dialContext, dialContext -> centreX, dialContext -> centreY, angle, size, colFill, colOut, text);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  H O T  C O L D  X                                                                                        *
- *  ==========================                                                                                        *
+ *  D I A L  D R A W  M A R K  X                                                                                      *
+ *  ============================                                                                                      *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Display Hot and cold markers.
- *  \param posX Centre posision.
- *  \param posY Centre posision.
- *  \param size Radius of the marker.
- *  \param colFill Colour of the marker.
- *  \param cold Hot or Cold, 1 = cold.
+ *  \brief Draw a shaped marker on the dial, using the default context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param angle Angle of the marker.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \param text Text to display on the mark.
  *  \result None.
  */
-void dialHotColdX (int posX, int posY, int size, int colFill, int cold)
+void dialDrawMarkX (int posX, int posY, int angle, int size, int colFill, int colOut, char *text)
+{
+	dialCtxDrawMarkX (&defaultContext, posX, posY, angle, size, colFill, colOut, text);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  M A R K  X                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw a shaped marker on the dial.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param angle Angle of the marker.
+ *  \param size Size of the marker.
+ *  \param colFill Fill colour.
+ *  \param colOut Outline colour.
+ *  \param text Text to display on the mark.
+ *  \result None.
+ */
+void dialCtxDrawMarkX (DIAL_CONTEXT *dialContext, int posX, int posY, int angle, int size, int colFill, int colOut, char *text)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+	cairo_t *cr = dialContext -> cairo;
+	int markerStep = config -> markerStep == 0 ? SCALE_4 : config -> markerStep;
+
+	if (!(angle % markerStep))
+	{
+		switch (config -> markerType)
+		{
+		case 0:
+			/* No markers */
+			break;
+
+		case 1:
+			/* Triangle markers */
+			{
+				int points[6], i;
+				cairo_set_line_width (cr, 1.0f + ((float)config -> dialSize / 512.0f));
+				points[0] = posX + dialSin ((config -> dialSize * size) >> 6, angle + 5);
+				points[1] = posY - dialCos ((config -> dialSize * size) >> 6, angle + 5);
+				points[2] = posX + dialSin ((config -> dialSize * (size - 3)) >> 6, angle);
+				points[3] = posY - dialCos ((config -> dialSize * (size - 3)) >> 6, angle);
+				points[4] = posX + dialSin ((config -> dialSize * size) >> 6, angle - 5);
+				points[5] = posY - dialCos ((config -> dialSize * size) >> 6, angle - 5);
+				for (i = 0; i < 2; i++)
+				{
+					dialCtxSetColour (dialContext, i == 0 ? colFill : colOut);
+					cairo_move_to (cr, points[0], points[1]);
+					cairo_line_to (cr, points[2], points[3]);
+					cairo_line_to (cr, points[4], points[5]);
+					cairo_close_path (cr);
+					if (i == 0) cairo_fill (cr);
+					cairo_stroke (cr);
+				}
+			}
+			break;
+
+		case 2:
+			/* Circle markers */
+			cairo_set_line_width (cr, 1.0f + ((float)config -> dialSize / 512.0f));
+			posX += dialSin ((config -> dialSize * (size - 2)) >> 6, angle);
+			posY -= dialCos ((config -> dialSize * (size - 2)) >> 6, angle);
+			dialCtxDrawCircleX (dialContext, posX, posY, 3, colFill, colOut);
+			break;
+
+		default:
+			/* Text number markers */
+			posX += dialSin ((config -> dialSize * (size - 5)) >> 6, angle);
+			posY -= dialCos ((config -> dialSize * (size - 5)) >> 6, angle);
+			dialCtxDrawTextX (dialContext, posX, posY, text, colOut, 1);
+			break;
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  G E T  F O N T  S I Z E                                                                                  *
+ *  ================================                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Get the font size from a font def.
+ *  \param fontName String to read the size from.
+ *  \result The font size.
+ */
+float dialGetFontSize (char *fontName)
+{
+	int i = strlen (fontName);
+	float size = 0;
+
+	while (i)
+	{
+		i --;
+		if ((fontName[i] >= '0' && fontName[i] <= '9') || fontName[i] == '.')
+			continue;
+		break;
+	}
+	if (i < strlen (fontName))
+	{
+		size = atof (&fontName[i + 1]);
+	}
+	return size;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T E X T  F L U S H                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Throw away the cached layouts, atlases and the parsed font of one thread.
+ *  \param state Text cache of the thread.
+ *  \result None.
+ */
+static void dialTextFlush (TEXT_STATE *state)
 {
-	int trueSize = (dialConfig -> dialSize * size) >> 7;
+	int i;
 
-	cairo_set_line_width (saveCairo, 1.0f + ((float)dialConfig -> dialSize / 18.0f));
-	dialSetColour (colFill);
-	if (cold)
-		cairo_arc (saveCairo, posX, posY, trueSize, (M_PI * 3) / 4, M_PI);
-	else
-		cairo_arc (saveCairo, posX, posY, trueSize, 0, M_PI / 4);
-	cairo_stroke (saveCairo);
+	for (i = 0; i < TEXT_CACHE_SIZE; ++i)
+	{
+		if (state -> cache[i].layout != NULL)
+			g_object_unref (state -> cache[i].layout);
+		free (state -> cache[i].text);
+		memset (&state -> cache[i], 0, sizeof (TEXT_CACHE));
+	}
+	for (i = 0; i < ATLAS_SIZE; ++i)
+		dialTextAtlasFree (&state -> atlas[i]);
+	if (state -> fontDesc != NULL)
+	{
+		pango_font_description_free (state -> fontDesc);
+		state -> fontDesc = NULL;
+	}
+	free (state -> fontName);
+	state -> fontName = NULL;
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  S Q U A R E                                                                                     *
- *  =============================                                                                                     *
+ *  D I A L  T E X T  S T A T E  F R E E                                                                              *
+ *  ====================================                                                                              *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a square on the dial.
- *  \param size Size of the marker.
- *  \param colFill Fill colour.
- *  \param colOut Outline colour.
+ *  \brief Free the text cache of a thread when the thread ends.
+ *  \param data Text cache of the thread.
  *  \result None.
  */
-void dialDrawSquare (int size, int colFill, int colOut)
+static void dialTextStateFree (gpointer data)
 {
-	dialDrawSquareX (savePosX, savePosY, size, colFill, colOut);
+	TEXT_STATE *state = (TEXT_STATE *)data;
+
+	if (state != NULL)
+	{
+		dialTextFlush (state);
+		if (state -> context != NULL)
+			g_object_unref (state -> context);
+		free (state);
+	}
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  S Q U A R E  X                                                                                  *
- *  ================================                                                                                  *
+ *  D I A L  T E X T  S T A T E                                                                                       *
+ *  ===========================                                                                                       *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a square on the dial.
- *  \param posX Centre position.
- *  \param posY Centre position.
- *  \param size Size of the marker.
- *  \param colFill Fill colour.
- *  \param colOut Outline colour.
- *  \result None.
+ *  \brief Find the text cache of the calling thread, making it the first time the thread draws text.
+ *  \result The text cache, NULL if it could not be made.
  */
-void dialDrawSquareX (int posX, int posY, int size, int colFill, int colOut)
+static TEXT_STATE *dialTextState (void)
 {
-	int trueSize = (dialConfig -> dialSize * size) >> 6;
+	TEXT_STATE *state = TEXT_STATE_GET ();
+	gint generation = g_atomic_int_get (&textGeneration);
 
-	cairo_set_line_width (saveCairo, 1.0f + ((float)dialConfig -> dialSize / 256.0f));
-	if (colFill != -1)
+	if (state == NULL)
 	{
-		dialSetColour (colFill);
-		cairo_rectangle (saveCairo, posX, posY, trueSize, trueSize);
-		cairo_fill (saveCairo);
-		cairo_stroke (saveCairo);
+		PangoFontMap *fontMap;
+
+		if ((state = (TEXT_STATE *)calloc (1, sizeof (TEXT_STATE))) == NULL)
+			return NULL;
+
+		/*--------------------------------------------------------------------------------------------*
+         * Our own font map and context, the layouts in them are not shared with GTK or other threads *
+         *--------------------------------------------------------------------------------------------*/
+		fontMap = pango_cairo_font_map_new ();
+#if PANGO_VERSION_CHECK(1,22,0)
+		state -> context = pango_font_map_create_context (fontMap);
+#else
+		state -> context = pango_cairo_font_map_create_context (PANGO_CAIRO_FONT_MAP (fontMap));
+#endif
+		g_object_unref (fontMap);
+		TEXT_STATE_SET (state);
 	}
-	if (colOut != -1)
+	if (state -> generation != generation)
 	{
-		dialSetColour (colOut);
-		cairo_rectangle (saveCairo, posX, posY, trueSize, trueSize);
-		cairo_stroke (saveCairo);
+		dialTextFlush (state);
+		TEXT_LOCK ();
+		if (textFontOptions != NULL)
+			pango_cairo_context_set_font_options (state -> context, textFontOptions);
+		TEXT_UNLOCK ();
+		state -> generation = generation;
 	}
+	return state;
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  H A N D                                                                                         *
- *  =========================                                                                                         *
+ *  D I A L  T E X T  R E S E T                                                                                       *
+ *  ===========================                                                                                       *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a hand on the dial.
- *  \param angle Angle of the hand.
- *  \param handStyle Style structure of the hand.
+ *  \brief Start the text caches again, called at start up and when the font is changed.
  *  \result None.
  */
-void dialDrawHand (int angle, HAND_STYLE *handStyle)
+void dialTextReset (void)
 {
-	dialDrawHandX (saveCentreX, saveCentreY, angle, handStyle);
+	/*------------------------------------------------------------------------------------------------*
+     * Only the main thread may ask GDK, so the font options are copied for the drawing threads       *
+     *------------------------------------------------------------------------------------------------*/
+	TEXT_LOCK ();
+	if (textFontOptions != NULL)
+	{
+		cairo_font_options_destroy (textFontOptions);
+		textFontOptions = NULL;
+	}
+	if (gdk_screen_get_default () != NULL && gdk_screen_get_font_options (gdk_screen_get_default ()) != NULL)
+		textFontOptions = cairo_font_options_copy (gdk_screen_get_font_options (gdk_screen_get_default ()));
+	TEXT_UNLOCK ();
+	g_atomic_int_inc (&textGeneration);
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  H A N D  X                                                                                      *
- *  ============================                                                                                      *
+ *  D I A L  T E X T  F O N T  S I Z E                                                                                *
+ *  ==================================                                                                                *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a hand on the dial.
- *  \param posX Centre position.
- *  \param posY Centre position.
- *  \param angle Angle of the hand.
- *  \param handStyle Style structure of the hand.
- *  \result None.
+ *  \brief Work out the size of the font to use, parsing the font again if it has been changed.
+ *  \param state Text cache of the thread.
+ *  \param config Dial config with the font to use.
+ *  \param scale Use the smaller marker font.
+ *  \result The font size, 0 if there is no text context.
  */
-void dialDrawHandX (int posX, int posY, int angle, HAND_STYLE *handStyle)
+static int dialTextFontSize (TEXT_STATE *state, DIAL_CONFIG *config, int scale)
 {
-	int points[20], i, j, numPoints, fill = 0;
-	int size = handStyle -> length, style = handStyle -> style, tail = handStyle -> tail;
-	int colFill = handStyle -> fill, colOut = handStyle -> line;
+	int fontSize;
 
-	if (handStyle -> gauge)
+	if (state == NULL || state -> context == NULL)
+		return 0;
+
+	/*------------------------------------------------------------------------------------------------*
+     * The font name is edited in place, so notice if it has changed since it was last parsed         *
+     *------------------------------------------------------------------------------------------------*/
+	if (state -> fontName == NULL || strcmp (state -> fontName, config -> fontName) != 0)
 	{
-		if (angle < 0) angle = 0;
-		if (angle >= SCALE_4) angle = SCALE_4 - 1;
+		dialTextFlush (state);
+		state -> fontName = strdup (config -> fontName);
+		state -> fontDesc = pango_font_description_from_string (config -> fontName);
+		state -> fontSize = dialGetFontSize (config -> fontName);
 	}
-	else
+	if ((fontSize = state -> fontSize) == 0)
 	{
-		while (angle < 0) angle += SCALE_4;
-		while (angle >= SCALE_4) angle -= SCALE_4;
+		fontSize = (config -> dialSize >> 6) << 2;
+		if (fontSize < 6) fontSize = 6;
 	}
+	if (scale)
+		fontSize = (fontSize * 10) / 12;
+	return fontSize;
+}
 
-	switch (style)
-	{
-	case 0:
-		/* Original double triangle */
-		points[0] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2);
-		points[1] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2);
-		points[2] = posX + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[3] = posY - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[4] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle);
-		points[5] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle);
-		points[6] = posX + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[7] = posY - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		numPoints = 4;
-		fill = 1;
-		break;
-
-	case 1:
-		/* Single triangle */
-		points[0] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2)
-					+ dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[1] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2)
-					- dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[2] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2)
-					+ dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[3] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2)
-					- dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[4] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle);
-		points[5] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle);
-		numPoints = 3;
-		fill = 1;
-		break;
-
-	case 2:
-		/* Rectangle */
-		points[0] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[1] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[2] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[3] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[4] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[5] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[6] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[7] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		numPoints = 4;
-		fill = 1;
-		break;
-
-	case 3:
-		/*Rectangle with pointer */
-		points[0] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[1] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[2] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[3] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[4] = posX + dialSin ((dialConfig -> dialSize * (size * 15)) >> 10, angle) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[5] = posY - dialCos ((dialConfig -> dialSize * (size * 15)) >> 10, angle) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[6] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle);
-		points[7] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle);
-		points[8] = posX + dialSin ((dialConfig -> dialSize * (size * 15)) >> 10, angle) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[9] = posY - dialCos ((dialConfig -> dialSize * (size * 15)) >> 10, angle) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		numPoints = 5;
-		fill = 1;
-		break;
-
-	case 4:
-		/*Rectangle with arrow */
-		points[0] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[1] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[2] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[3] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[4] = posX + dialSin ((dialConfig -> dialSize * (size * 12)) >> 10, angle) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[5] = posY - dialCos ((dialConfig -> dialSize * (size * 12)) >> 10, angle) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_3);
-		points[6] = posX + dialSin ((dialConfig -> dialSize * (size * 12)) >> 10, angle) + dialSin (dialConfig -> dialSize / 30, angle + SCALE_3);
-		points[7] = posY - dialCos ((dialConfig -> dialSize * (size * 12)) >> 10, angle) - dialCos (dialConfig -> dialSize / 30, angle + SCALE_3);
-		points[8] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle);
-		points[9] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle);
-		points[10] = posX + dialSin ((dialConfig -> dialSize * (size * 12)) >> 10, angle) + dialSin (dialConfig -> dialSize / 30, angle + SCALE_1);
-		points[11] = posY - dialCos ((dialConfig -> dialSize * (size * 12)) >> 10, angle) - dialCos (dialConfig -> dialSize / 30, angle + SCALE_1);
-		points[12] = posX + dialSin ((dialConfig -> dialSize * (size * 12)) >> 10, angle) + dialSin (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		points[13] = posY - dialCos ((dialConfig -> dialSize * (size * 12)) >> 10, angle) - dialCos (dialConfig -> dialSize >> 6, angle + SCALE_1);
-		numPoints = 7;
-		fill = 1;
-		break;
-
-	case 5:
-		/* Single triangle */
-		points[0] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize / 40, angle + SCALE_1);
-		points[1] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize / 40, angle + SCALE_1);
-		points[2] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) + dialSin (dialConfig -> dialSize / 40, angle + SCALE_3);
-		points[3] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2) - dialCos (dialConfig -> dialSize / 40, angle + SCALE_3);
-		points[4] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle);
-		points[5] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle);
-		numPoints = 3;
-		fill = 1;
-		break;
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T E X T  L A Y O U T                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find a shaped layout for some text, only make a new one if it is not in the cache.
+ *  \param state Text cache of the thread.
+ *  \param cr Cairo context the text will be shown on.
+ *  \param text Text to show.
+ *  \param fontSize Size of the font from dialTextFontSize.
+ *  \param width Return the width of the text.
+ *  \param height Return the height of the text.
+ *  \result The layout, only valid until the thread draws more text.
+ */
+static PangoLayout *dialTextLayout (TEXT_STATE *state, cairo_t *cr, char *text, int fontSize, int *width, int *height)
+{
+	TEXT_CACHE *entry = NULL;
+	unsigned int textHash = 2166136261u;
+	int i;
+	char *c;
 
-	case 9:
-	default:
-		/* Simple line */
-		points[0] = posX + dialSin ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2);
-		points[1] = posY - dialCos ((dialConfig -> dialSize * tail) >> 6, angle + SCALE_2);
-		points[2] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle);
-		points[3] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle);
-		numPoints = 2;
-		break;
+	for (c = text; *c; ++c)
+	{
+		textHash ^= (unsigned char)*c;
+		textHash *= 16777619u;
 	}
 
-	cairo_set_line_width (saveCairo, 1.0f + ((float)dialConfig -> dialSize / 256.0f));
-	if (!handStyle -> fillIn)
+	++state -> useCount;
+	for (i = 0; i < TEXT_CACHE_SIZE; ++i)
 	{
-		fill = 0;
+		TEXT_CACHE *cache = &state -> cache[i];
+
+		if (cache -> layout != NULL && cache -> textHash == textHash &&
+				cache -> fontSize == fontSize && strcmp (cache -> text, text) == 0)
+		{
+			entry = cache;
+			g_atomic_int_inc (&textHits);
+			break;
+		}
 	}
-	for (i = 0; i < 2; i++)
+
+	if (entry == NULL)
 	{
-		if (i != 0 || fill)
+		/*--------------------------------------------------------------------------------------------*
+         * Not found so reuse the empty or least recently used entry                                  *
+         *--------------------------------------------------------------------------------------------*/
+		entry = &state -> cache[0];
+		for (i = 1; i < TEXT_CACHE_SIZE && entry -> layout != NULL; ++i)
 		{
-			dialSetColour (i == 0 ? colFill : colOut);
-			cairo_move_to (saveCairo, points[0], points[1]);
-			for (j = 1; j < numPoints; j++)
-				cairo_line_to (saveCairo, points[j << 1], points[(j << 1) + 1]);
-			if (numPoints > 2)
-				cairo_close_path (saveCairo);
-			if (i == 0)
-				cairo_fill (saveCairo);
-			cairo_stroke (saveCairo);
+			if (state -> cache[i].layout == NULL || state -> cache[i].lastUsed < entry -> lastUsed)
+				entry = &state -> cache[i];
 		}
+		if (entry -> layout != NULL)
+			g_object_unref (entry -> layout);
+		free (entry -> text);
+
+		pango_font_description_set_size (state -> fontDesc, PANGO_SCALE * fontSize);
+		entry -> layout = pango_layout_new (state -> context);
+		pango_layout_set_font_description (entry -> layout, state -> fontDesc);
+		pango_layout_set_alignment (entry -> layout, PANGO_ALIGN_CENTER);
+		pango_layout_set_text (entry -> layout, text, -1);
+		entry -> text = strdup (text);
+		entry -> textHash = textHash;
+		entry -> fontSize = fontSize;
+		g_atomic_int_inc (&textMisses);
 	}
+	entry -> lastUsed = state -> useCount;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Take the font options and transform from the target, the text is only laid out again if they   *
+     * are not the same as last time                                                                  *
+     *------------------------------------------------------------------------------------------------*/
+	pango_cairo_update_layout (cr, entry -> layout);
+	pango_layout_get_pixel_size (entry -> layout, width, height);
+	return entry -> layout;
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  M A R K                                                                                         *
- *  =========================                                                                                         *
+ *  D I A L  T E X T  A T L A S  F R E E                                                                              *
+ *  ====================================                                                                              *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a shaped marker on the dial.
- *  \param angle Angle of the marker.
- *  \param size Size of the marker.
- *  \param colFill Fill colour.
- *  \param colOut Outline colour.
- *  \param text Text to display on the mark.
+ *  \brief Free the surfaces of one glyph atlas.
+ *  \param atlas Atlas to free.
  *  \result None.
  */
-void dialDrawMark (int angle, int size, int colFill, int colOut, char *text)
+static void dialTextAtlasFree (TEXT_ATLAS *atlas)
 {
-	dialDrawMarkX (saveCentreX, saveCentreY, angle, size, colFill, colOut, text);
+	int i;
+
+	for (i = 0; i < ATLAS_COUNT; ++i)
+	{
+		if (atlas -> glyphs[i] != NULL)
+			cairo_surface_destroy (atlas -> glyphs[i]);
+	}
+	if (atlas -> surface != NULL)
+		cairo_surface_destroy (atlas -> surface);
+	memset (atlas, 0, sizeof (TEXT_ATLAS));
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  D R A W  M A R K  X                                                                                      *
- *  ============================                                                                                      *
+ *  D I A L  T E X T  A T L A S                                                                                       *
+ *  ===========================                                                                                       *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw a shaped marker on the dial.
- *  \param posX Centre position.
- *  \param posY Centre position.
- *  \param angle Angle of the marker.
- *  \param size Size of the marker.
- *  \param colFill Fill colour.
- *  \param colOut Outline colour.
- *  \param text Text to display on the mark.
- *  \result None.
+ *  \brief Find the glyph atlas for a font size, rendering a new one if it is not in the cache.
+ *  \param state Text cache of the thread.
+ *  \param fontSize Size of the font from dialTextFontSize.
+ *  \param scaleX Device scale of the surface the labels are drawn on.
+ *  \param scaleY Device scale of the surface the labels are drawn on.
+ *  \result The atlas, only valid until the thread draws more text, NULL if it could not be made.
  */
-void dialDrawMarkX (int posX, int posY, int angle, int size, int colFill, int colOut, char *text)
+static TEXT_ATLAS *dialTextAtlas (TEXT_STATE *state, int fontSize, double scaleX, double scaleY)
 {
-	if (dialConfig -> markerStep == 0) dialConfig -> markerStep = SCALE_4;
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1,10,0)
+	TEXT_ATLAS *atlas = NULL;
+	PangoLayout *layout;
+	PangoRectangle logical;
+	cairo_t *cr;
+	char pair[2];
+	int i, j, width, cellX, cellW;
 
-	if (!(angle % dialConfig -> markerStep))
+	for (i = 0; i < ATLAS_SIZE; ++i)
 	{
-		switch (dialConfig -> markerType)
+		atlas = &state -> atlas[i];
+		if (atlas -> surface != NULL && atlas -> fontSize == fontSize &&
+				atlas -> scaleX == scaleX && atlas -> scaleY == scaleY)
 		{
-		case 0:
-			/* No markers */
-			break;
-
-		case 1:
-			/* Triangle markers */
-			{
-				int points[6], i;
-				cairo_set_line_width (saveCairo, 1.0f + ((float)dialConfig -> dialSize / 512.0f));
-				points[0] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle + 5);
-				points[1] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle + 5);
-				points[2] = posX + dialSin ((dialConfig -> dialSize * (size - 3)) >> 6, angle);
-				points[3] = posY - dialCos ((dialConfig -> dialSize * (size - 3)) >> 6, angle);
-				points[4] = posX + dialSin ((dialConfig -> dialSize * size) >> 6, angle - 5);
-				points[5] = posY - dialCos ((dialConfig -> dialSize * size) >> 6, angle - 5);
-				for (i = 0; i < 2; i++)
-				{
-					dialSetColour (i == 0 ? colFill : colOut);
-					cairo_move_to (saveCairo, points[0], points[1]);
-					cairo_line_to (saveCairo, points[2], points[3]);
-					cairo_line_to (saveCairo, points[4], points[5]);
-					cairo_close_path (saveCairo);
-					if (i == 0) cairo_fill (saveCairo);
-					cairo_stroke (saveCairo);
-				}
-			}
-			break;
+			atlas -> lastUsed = state -> useCount;
+			return atlas;
+		}
+	}
 
-		case 2:
-			/* Circle markers */
-			cairo_set_line_width (saveCairo, 1.0f + ((float)dialConfig -> dialSize / 512.0f));
-			posX += dialSin ((dialConfig -> dialSize * (size - 2)) >> 6, angle);
-			posY -= dialCos ((dialConfig -> dialSize * (size - 2)) >> 6, angle);
-			dialDrawCircleX (posX, posY, 3, colFill, colOut);
-			break;
+	atlas = &state -> atlas[0];
+	for (i = 1; i < ATLAS_SIZE && atlas -> surface != NULL; ++i)
+	{
+		if (state -> atlas[i].surface == NULL || state -> atlas[i].lastUsed < atlas -> lastUsed)
+			atlas = &state -> atlas[i];
+	}
+	dialTextAtlasFree (atlas);
+
+	/*------------------------------------------------------------------------------------------------*
+     * Measure each character, the cells are padded so ink outside the logical box is not lost and    *
+     * a glyph never picks up its neighbour                                                           *
+     *------------------------------------------------------------------------------------------------*/
+	pango_font_description_set_size (state -> fontDesc, PANGO_SCALE * fontSize);
+	layout = pango_layout_new (state -> context);
+	pango_layout_set_font_description (layout, state -> fontDesc);
+
+	width = 0;
+	for (i = 0; i < ATLAS_COUNT; ++i)
+	{
+		pango_layout_set_text (layout, &ATLAS_CHARS[i], 1);
+		pango_layout_get_extents (layout, NULL, &logical);
+		atlas -> advance[i] = logical.width;
+		if (PANGO_PIXELS_CEIL (logical.height) > atlas -> height)
+			atlas -> height = PANGO_PIXELS_CEIL (logical.height);
+		width += PANGO_PIXELS_CEIL (logical.width);
+	}
 
-		default:
-			/* Text number markers */
-			posX += dialSin ((dialConfig -> dialSize * (size - 5)) >> 6, angle);
-			posY -= dialCos ((dialConfig -> dialSize * (size - 5)) >> 6, angle);
-			dialDrawTextX (posX, posY, text, colOut, 1);
-			break;
+	/*------------------------------------------------------------------------------------------------*
+     * Pango would kern the label as a whole, so keep how much each pair moves from the two advances  *
+     *------------------------------------------------------------------------------------------------*/
+	for (i = 0; i < ATLAS_COUNT; ++i)
+	{
+		for (j = 0; j < ATLAS_COUNT; ++j)
+		{
+			pair[0] = ATLAS_CHARS[i];
+			pair[1] = ATLAS_CHARS[j];
+			pango_layout_set_text (layout, pair, 2);
+			pango_layout_get_extents (layout, NULL, &logical);
+			atlas -> kerning[i][j] = logical.width - atlas -> advance[i] - atlas -> advance[j];
 		}
 	}
+	atlas -> pad = (atlas -> height >> 1) + 1;
+	width += ATLAS_COUNT * 2 * atlas -> pad;
+
+	atlas -> surface = cairo_image_surface_create (CAIRO_FORMAT_A8, (int)ceil (width * scaleX),
+			(int)ceil ((atlas -> height + 2 * atlas -> pad) * scaleY));
+	if (cairo_surface_status (atlas -> surface) != CAIRO_STATUS_SUCCESS)
+	{
+		g_object_unref (layout);
+		dialTextAtlasFree (atlas);
+		return NULL;
+	}
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1,14,0)
+	cairo_surface_set_device_scale (atlas -> surface, scaleX, scaleY);
+#endif
+
+	cr = cairo_create (atlas -> surface);
+	for (i = cellX = 0; i < ATLAS_COUNT; ++i)
+	{
+		cellW = PANGO_PIXELS_CEIL (atlas -> advance[i]) + 2 * atlas -> pad;
+		pango_layout_set_text (layout, &ATLAS_CHARS[i], 1);
+		cairo_move_to (cr, cellX + atlas -> pad, atlas -> pad);
+		pango_cairo_show_layout (cr, layout);
+		atlas -> glyphs[i] = cairo_surface_create_for_rectangle (atlas -> surface, cellX, 0,
+				cellW, atlas -> height + 2 * atlas -> pad);
+		cellX += cellW;
+	}
+	cairo_destroy (cr);
+	cairo_surface_flush (atlas -> surface);
+	g_object_unref (layout);
+
+	atlas -> fontSize = fontSize;
+	atlas -> scaleX = scaleX;
+	atlas -> scaleY = scaleY;
+	atlas -> lastUsed = state -> useCount;
+	return atlas;
+#else
+	return NULL;
+#endif
 }
 
 /**********************************************************************************************************************
  *                                                                                                                    *
- *  D I A L  G E T  F O N T  S I Z E                                                                                  *
- *  ================================                                                                                  *
+ *  D I A L  T E X T  A T L A S  D R A W                                                                              *
+ *  ====================================                                                                              *
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Get the font size from a font def.
- *  \param fontName String to read the size from.
- *  \result The font size.
+ *  \brief Draw a label from the glyph atlas, if all of its characters are in the atlas.
+ *  \param state Text cache of the thread.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param text Text to display.
+ *  \param fontSize Size of the font from dialTextFontSize.
+ *  \param colour Text colour.
+ *  \result True if the label was drawn, false if it must be shaped by Pango.
  */
-float dialGetFontSize (char *fontName)
+static bool dialTextAtlasDraw (TEXT_STATE *state, DIAL_CONTEXT *dialContext, int posX, int posY, char *text,
+		int fontSize, int colour)
 {
-	int i = strlen (fontName);
-	float size = 0;
+	cairo_t *cr = dialContext -> cairo;
+	double scale = 1.0;
+	TEXT_ATLAS *atlas;
+	int i, next, width, posL, posT;
+	char *c;
+
+	/*------------------------------------------------------------------------------------------------*
+     * The glyphs are masked at whole pixels, so vector output (saving an SVG) and a scaled, rotated  *
+     * or part pixel transform are left to Pango                                                      *
+     *------------------------------------------------------------------------------------------------*/
+	if (!dialPixelAligned (cr, &scale))
+		return false;
+	for (c = text; *c; ++c)
+	{
+		if (strchr (ATLAS_CHARS, *c) == NULL)
+			return false;
+	}
+	if ((atlas = dialTextAtlas (state, fontSize, scale, scale)) == NULL)
+		return false;
 
-	while (i)
+	for (c = text, width = 0; *c; ++c)
 	{
-		i --;
-		if ((fontName[i] >= '0' && fontName[i] <= '9') || fontName[i] == '.')
-			continue;
-		break;
+		i = strchr (ATLAS_CHARS, *c) - ATLAS_CHARS;
+		width += atlas -> advance[i];
+		if (c[1])
+		{
+			next = strchr (ATLAS_CHARS, c[1]) - ATLAS_CHARS;
+			width += atlas -> kerning[i][next];
+		}
 	}
-	if (i < strlen (fontName))
+
+	posL = posX - (PANGO_PIXELS_CEIL (width) >> 1) - atlas -> pad;
+	posT = posY - (atlas -> height >> 1) - atlas -> pad;
+
+	dialCtxSetColour (dialContext, colour);
+	for (c = text, width = 0; *c; ++c)
 	{
-		size = atof (&fontName[i + 1]);
+		i = strchr (ATLAS_CHARS, *c) - ATLAS_CHARS;
+		cairo_mask_surface (cr, atlas -> glyphs[i], posL + PANGO_PIXELS (width), posT);
+		width += atlas -> advance[i];
+		if (c[1])
+		{
+			next = strchr (ATLAS_CHARS, c[1]) - ATLAS_CHARS;
+			width += atlas -> kerning[i][next];
+		}
 	}
-	return size;
+	return true;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T E X T  C A C H E  S T A T S                                                                            *
+ *  ======================================                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read how well the text layout cache is working.
+ *  \param hits Return the number of times a layout was reused.
+ *  \param misses Return the number of times a layout had to be made.
+ *  \result None.
+ */
+void dialTextCacheStats (unsigned long *hits, unsigned long *misses)
+{
+	if (hits != NULL)
+		*hits = (unsigned long)g_atomic_int_get (&textHits);
+	if (misses != NULL)
+		*misses = (unsigned long)g_atomic_int_get (&textMisses);
 }
 
 /**********************************************************************************************************************
@@ -959,7 +2956,7 @@ float dialGetFontSize (char *fontName)
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw text on the dial.
+ *  \brief Draw text on the dial, using the default context.
  *  \param posn Top or Bottom of the dial.
  *  \param string1 Text to display.
  *  \param colour Text colour.
@@ -967,16 +2964,37 @@ float dialGetFontSize (char *fontName)
  */
 void dialDrawText (int posn, char *string1, int colour)
 {
+	dialCtxDrawText (&defaultContext, posn, string1, colour);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  T E X T                                                                                  *
+ *  ================================                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw text on the dial.
+ *  \param dialContext Drawing context.
+ *  \param posn Top or Bottom of the dial.
+ *  \param string1 Text to display.
+ *  \param colour Text colour.
+ *  \result None.
+ */
+void dialCtxDrawText (DIAL_CONTEXT *dialContext, int posn, char *string1, int colour)
+{
+	DIAL_CONFIG *config = dialContext -> dialConfig;
+
 	if (string1[0])
 	{
 		int posY;
 
 		if (posn == 0)
-			posY = savePosY + ((dialConfig -> dialSize * 5) >> 4);
+			posY = dialContext -> posY + ((config -> dialSize * 5) >> 4);
 		else
-			posY = savePosY + ((dialConfig -> dialSize * 11) >> 4);
+			posY = dialContext -> posY + ((config -> dialSize * 11) >> 4);
 
-		dialDrawTextX (saveCentreX, posY, string1, colour, 0);
+		dialCtxDrawTextX (dialContext, dialContext -> centreX, posY, string1, colour, 0);
 	}
 }
 
@@ -987,7 +3005,7 @@ void dialDrawText (int posn, char *string1, int colour)
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Draw text on the dial.
+ *  \brief Draw text on the dial, using the default context.
  *  \param posX Centre position.
  *  \param posY Centre position.
  *  \param string1 Text to display.
@@ -997,35 +3015,43 @@ void dialDrawText (int posn, char *string1, int colour)
  */
 void dialDrawTextX (int posX, int posY, char *string1, int colour, int scale)
 {
+	dialCtxDrawTextX (&defaultContext, posX, posY, string1, colour, scale);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  T E X T  X                                                                               *
+ *  ===================================                                                                               *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw text on the dial.
+ *  \param dialContext Drawing context.
+ *  \param posX Centre position.
+ *  \param posY Centre position.
+ *  \param string1 Text to display.
+ *  \param colour Text colour.
+ *  \param scale Scale factor.
+ *  \result None.
+ */
+void dialCtxDrawTextX (DIAL_CONTEXT *dialContext, int posX, int posY, char *string1, int colour, int scale)
+{
+	cairo_t *cr = dialContext -> cairo;
+
 	if (string1[0])
 	{
-		int fontSize = 0;
-		gint posW, posH;
+		TEXT_STATE *state = dialTextState ();
+		PangoLayout *layout;
+		int posW, posH, fontSize;
 
-		if ((fontSize = dialGetFontSize (dialConfig -> fontName)) == 0)
+		if ((fontSize = dialTextFontSize (state, dialContext -> dialConfig, scale)) != 0 &&
+				!dialTextAtlasDraw (state, dialContext, posX, posY, string1, fontSize, colour))
 		{
-			fontSize = (dialConfig -> dialSize >> 6) << 2;
-			if (fontSize < 6) fontSize = 6;
+			layout = dialTextLayout (state, cr, string1, fontSize, &posW, &posH);
+			dialCtxSetColour (dialContext, colour);
+			cairo_move_to (cr, posX - (posW >> 1), posY - (posH >> 1));
+			pango_cairo_show_layout (cr, layout);
 		}
-		if (scale)
-			fontSize = (fontSize * 10) / 12;
-
-		PangoLayout *layout = pango_cairo_create_layout (saveCairo);
-		PangoFontDescription *fontDesc = pango_font_description_from_string (dialConfig -> fontName);
-
-		pango_font_description_set_size (fontDesc, PANGO_SCALE * fontSize);
-		pango_layout_set_font_description (layout, fontDesc);
-		pango_layout_set_alignment (layout, PANGO_ALIGN_CENTER);
-
-		dialSetColour (colour);
-		pango_layout_set_text (layout, string1, -1);
-		pango_layout_get_pixel_size (layout, &posW, &posH);
-
-		cairo_move_to (saveCairo, posX - (posW >> 1), posY - (posH >> 1));
-		pango_cairo_show_layout (saveCairo, layout);
-
-		pango_font_description_free (fontDesc);
-		g_object_unref (layout);
 	}
 }
 
@@ -1075,6 +3101,8 @@ dialFontCallback (guint data)
 #endif
 			strcpy (dialConfig -> fontName, selectedFont);
 			g_free (selectedFont);
+			dialFaceCacheInvalidate (-1);
+			dialTextReset ();
 			if (dialConfig -> UpdateFunc) dialConfig -> UpdateFunc();
 			break;
 		}
@@ -1152,6 +3180,7 @@ void dialScaleChanged (GtkRange *range, gpointer data)
 	if (scale == 0)
 	{
 		dialConfig -> dialGradient = (int)gtk_range_get_value (range);
+		dialFaceCacheInvalidate (-1);
 	}
 	else if (scale == 1)
 	{
@@ -1278,6 +3307,7 @@ dialColourCallback (guint data)
 				}
 				dialConfig -> colourDetails[i].dialColour = setColour;
 			}
+			dialFaceCacheInvalidate (-1);
 			if (dialConfig -> UpdateFunc) dialConfig -> UpdateFunc();
 			break;
 		}
@@ -1343,13 +3373,41 @@ void dialFillSinCosTables ()
 
 	for (i = 0; i < SCALE_4; i++)
 	{
-		sinTable[i] = sin (((double) x * M_PI) / SCALE_2);
-		cosTable[i] = cos (((double) x * M_PI) / SCALE_2);
+		sinTable[i] = (int)rint (sin (((double) x * M_PI) / SCALE_2) * (1 << SIN_COS_SHIFT));
+		cosTable[i] = (int)rint (cos (((double) x * M_PI) / SCALE_2) * (1 << SIN_COS_SHIFT));
 		if (++x == SCALE_4)
 			x = 0;
 	}
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T A B L E  A N G L E                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Bring an angle into the range of the tables.
+ *  \param angle Angle to read, callers are at most a turn either side of the range.
+ *  \result The angle from 0 to SCALE_4 - 1.
+ */
+static int dialTableAngle (int angle)
+{
+	/*------------------------------------------------------------------------------------------------*
+     * SCALE_4 is not a power of two so it cannot be masked, one add or subtract covers the callers   *
+     *------------------------------------------------------------------------------------------------*/
+	if (angle < 0)
+		angle += SCALE_4;
+	else if (angle >= SCALE_4)
+		angle -= SCALE_4;
+	if (angle < 0 || angle >= SCALE_4)
+	{
+		angle %= SCALE_4;
+		if (angle < 0) angle += SCALE_4;
+	}
+	return angle;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  D I A L  S I N                                                                                                    *
@@ -1364,10 +3422,8 @@ void dialFillSinCosTables ()
  */
 int dialSin (int number, int angle)
 {
-	while (angle < 0) angle += SCALE_4;
-	angle %= SCALE_4;
-
-	return (int)rint(number * sinTable[angle]);
+	angle = dialTableAngle (angle);
+	return (int)(((long)number * sinTable[angle] + SIN_COS_ROUND) >> SIN_COS_SHIFT);
 }
 
 /**********************************************************************************************************************
@@ -1384,10 +3440,8 @@ int dialSin (int number, int angle)
  */
 int dialCos (int number, int angle)
 {
-	while (angle < 0) angle += SCALE_4;
-	angle %= SCALE_4;
-
-	return (int)rint(number * cosTable[angle]);
+	angle = dialTableAngle (angle);
+	return (int)(((long)number * cosTable[angle] + SIN_COS_ROUND) >> SIN_COS_SHIFT);
 }
 
 /**********************************************************************************************************************
@@ -1455,6 +3509,7 @@ dialZoomCallback (guint data)
 		break;
 	}
 	dialFixFaceSize ();
+	dialFaceCacheInvalidate (-1);
 	dialWindowMask();
 	gtk_widget_set_size_request (dialConfig -> drawingArea, dialConfig -> dialWidth * dialConfig -> dialSize, dialConfig -> dialHeight * dialConfig -> dialSize);
 
@@ -1476,6 +3531,7 @@ void
 dialMarkerCallback (guint data)
 {
 	dialConfig -> markerType = data;
+	dialFaceCacheInvalidate (-1);
 	if (dialConfig -> UpdateFunc) dialConfig -> UpdateFunc();
 }
 
@@ -1494,6 +3550,7 @@ void
 dialStepCallback (guint data)
 {
 	dialConfig -> markerStep = data;
+	dialFaceCacheInvalidate (-1);
 	if (dialConfig -> UpdateFunc) dialConfig -> UpdateFunc();
 }
 
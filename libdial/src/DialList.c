@@ -32,16 +32,11 @@
 
 /*----------------------------------------------------------------------------------------------------*
  *                                                                                                    *
- * Structure to hold an item on the queue                                                             *
+ * The queue is kept in an array, items are at queueItems[firstItem] to queueItems[firstItem +        *
+ * itemCount - 1]. There is space at both ends so push, put and get do not have to move anything.    *
  *                                                                                                    *
  *----------------------------------------------------------------------------------------------------*/
-typedef struct _queueItem
-{
-	void *myNextPtr;
-	void *myPrevPtr;
-	void *myData;
-}
-QUEUE_ITEM;
+#define QUEUE_MIN_SIZE	16
 
 /*----------------------------------------------------------------------------------------------------*
  *                                                                                                    *
@@ -50,10 +45,10 @@ QUEUE_ITEM;
  *----------------------------------------------------------------------------------------------------*/
 typedef struct _queueHeader
 {
-	QUEUE_ITEM *firstInQueue;
-	QUEUE_ITEM *lastInQueue;
-	QUEUE_ITEM *currentItem;
+	void **queueItems;
+	unsigned long firstItem;
 	unsigned long itemCount;
+	unsigned long itemsAllocated;
 	unsigned long freeData;
 
 #ifdef MULTI_THREAD
@@ -122,6 +117,56 @@ static void queueUnLock (QUEUE_HEADER *myQueue)
 #endif
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  Q U E U E  M A K E  R O O M                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make space for one more item, the array is doubled when it is over half full otherwise the
+ *  items are just moved. Must be called with the queue locked.
+ *  \param myQueue Queue to make room in.
+ *  \param atFront Room is needed at the front rather than the end.
+ *  \result 1 if there is now room, 0 if we ran out of memory.
+ */
+static int queueMakeRoom (QUEUE_HEADER *myQueue, int atFront)
+{
+	unsigned long newAllocated = myQueue -> itemsAllocated, newFirst;
+	void **newItems = myQueue -> queueItems;
+
+	if (atFront ? myQueue -> firstItem > 0 :
+			myQueue -> firstItem + myQueue -> itemCount < myQueue -> itemsAllocated)
+		return 1;
+
+	if (newAllocated < QUEUE_MIN_SIZE)
+		newAllocated = QUEUE_MIN_SIZE;
+	while ((myQueue -> itemCount + 1) * 2 > newAllocated)
+		newAllocated *= 2;
+
+	if (newAllocated != myQueue -> itemsAllocated)
+	{
+		if ((newItems = malloc (newAllocated * sizeof (void *))) == NULL)
+			return 0;
+	}
+
+	newFirst = atFront ? (newAllocated - myQueue -> itemCount) / 2 : 0;
+	if (myQueue -> itemCount)
+	{
+		memmove (&newItems[newFirst], &myQueue -> queueItems[myQueue -> firstItem],
+				myQueue -> itemCount * sizeof (void *));
+	}
+	if (newItems != myQueue -> queueItems)
+	{
+		if (myQueue -> queueItems)
+			free (myQueue -> queueItems);
+		myQueue -> queueItems = newItems;
+		myQueue -> itemsAllocated = newAllocated;
+	}
+	myQueue -> firstItem = newFirst;
+	return 1;
+}
+
 /**********************************************************************************************************************
  *                                                                                                                    *
  *  Q U E U E  C R E A T E                                                                                            *
@@ -139,10 +184,10 @@ void *queueCreate ()
 	if ((newQueue = malloc (sizeof (QUEUE_HEADER))) == NULL)
 		return NULL;
 
-	newQueue -> firstInQueue = NULL;
-	newQueue -> lastInQueue = NULL;
-	newQueue -> currentItem = NULL;
+	newQueue -> queueItems = NULL;
+	newQueue -> firstItem = 0;
 	newQueue -> itemCount = 0;
+	newQueue -> itemsAllocated = 0;
 	newQueue -> freeData = 0;
 
 #ifdef MULTI_THREAD
@@ -172,10 +217,12 @@ void *queueCreate ()
  */
 void queueDelete (void *queueHandle)
 {
-#ifdef MULTI_THREAD
-
 	QUEUE_HEADER *myQueue = (QUEUE_HEADER *)queueHandle;
 
+	if (myQueue == NULL)
+		return;
+
+#ifdef MULTI_THREAD
 #ifdef WIN32
 
 	CloseHandle (myQueue -> queueMutex);
@@ -187,8 +234,9 @@ void queueDelete (void *queueHandle)
 #endif
 #endif
 
-	if (queueHandle)
-		free (queueHandle);
+	if (myQueue -> queueItems)
+		free (myQueue -> queueItems);
+	free (myQueue);
 }
 
 /**********************************************************************************************************************
@@ -205,23 +253,17 @@ void queueDelete (void *queueHandle)
 void *queueGet (void *queueHandle)
 {
 	QUEUE_HEADER *myQueue = (QUEUE_HEADER *)queueHandle;
-	QUEUE_ITEM *oldQueueItem;
 	void *retn = NULL;
 
 	queueLock (myQueue);
-	if (myQueue -> firstInQueue)
+	if (myQueue -> itemCount)
 	{
-		oldQueueItem = myQueue -> firstInQueue;
-		retn = oldQueueItem -> myData;
-		myQueue -> firstInQueue = oldQueueItem -> myNextPtr;
-		free (oldQueueItem);
-
-		if (myQueue -> firstInQueue)
-			myQueue -> firstInQueue -> myPrevPtr = NULL;
-		else
-			myQueue -> lastInQueue = NULL;
-
+		retn = myQueue -> queueItems[myQueue -> firstItem];
+		myQueue -> firstItem ++;
 		myQueue -> itemCount --;
+
+		if (myQueue -> itemCount == 0)
+			myQueue -> firstItem = 0;
 	}
 	queueUnLock (myQueue);
 	return retn;
@@ -242,25 +284,13 @@ void *queueGet (void *queueHandle)
 void queuePut (void *queueHandle, void *putData)
 {
 	QUEUE_HEADER *myQueue = (QUEUE_HEADER *)queueHandle;
-	QUEUE_ITEM *newQueueItem;
-
-	if ((newQueueItem = malloc (sizeof (QUEUE_ITEM))) == NULL)
-		return;
-
-	newQueueItem -> myNextPtr = newQueueItem -> myPrevPtr = NULL;
-	newQueueItem -> myData = putData;
 
 	queueLock (myQueue);
-	if (myQueue -> lastInQueue)
+	if (queueMakeRoom (myQueue, 0))
 	{
-		myQueue -> lastInQueue -> myNextPtr = newQueueItem;
-		newQueueItem -> myPrevPtr = myQueue -> lastInQueue;
-		myQueue -> lastInQueue = newQueueItem;
+		myQueue -> queueItems[myQueue -> firstItem + myQueue -> itemCount] = putData;
+		myQueue -> itemCount ++;
 	}
-	else
-		myQueue -> firstInQueue = myQueue -> lastInQueue = newQueueItem;
-
-	myQueue -> itemCount ++;
 	queueUnLock (myQueue);
 }
 
@@ -279,25 +309,14 @@ void queuePut (void *queueHandle, void *putData)
 void queuePush (void *queueHandle, void *putData)
 {
 	QUEUE_HEADER *myQueue = (QUEUE_HEADER *)queueHandle;
-	QUEUE_ITEM *newQueueItem;
-
-	if ((newQueueItem = malloc (sizeof (QUEUE_ITEM))) == NULL)
-		return;
-
-	newQueueItem -> myNextPtr = newQueueItem -> myPrevPtr = NULL;
-	newQueueItem -> myData = putData;
 
 	queueLock (myQueue);
-	if (myQueue -> firstInQueue)
+	if (queueMakeRoom (myQueue, 1))
 	{
-		myQueue -> firstInQueue -> myPrevPtr = newQueueItem;
-		newQueueItem -> myNextPtr = myQueue -> firstInQueue;
-		myQueue -> firstInQueue = newQueueItem;
+		myQueue -> firstItem --;
+		myQueue -> queueItems[myQueue -> firstItem] = putData;
+		myQueue -> itemCount ++;
 	}
-	else
-		myQueue -> firstInQueue = myQueue -> lastInQueue = newQueueItem;
-
-	myQueue -> itemCount ++;
 	queueUnLock (myQueue);
 }
 
@@ -308,7 +327,7 @@ void queuePush (void *queueHandle, void *putData)
  *                                                                                                                    *
  **********************************************************************************************************************/
 /**
- *  \brief Put something on the queue in sorted order.
+ *  \brief Put something on the queue in sorted order, it goes after any items that compare equal.
  *  \param queueHandle Hangle to save to.
  *  \param putData Thing to put on the queue.
  *  \param item2 Function used to sort the queue.
@@ -318,52 +337,32 @@ void queuePutSort (void *queueHandle, void *putData,
 		int(*Compare)(void *item1, void *item2))
 {
 	QUEUE_HEADER *myQueue = (QUEUE_HEADER *)queueHandle;
-	QUEUE_ITEM *newQueueItem;
-
-	if ((newQueueItem = malloc (sizeof (QUEUE_ITEM))) == NULL)
-		return;
-
-	newQueueItem -> myNextPtr = newQueueItem -> myPrevPtr = NULL;
-	newQueueItem -> myData = putData;
+	unsigned long low = 0, high, mid;
+	void **items;
 
 	queueLock (myQueue);
-	if (myQueue -> firstInQueue)
+	if (queueMakeRoom (myQueue, 0))
 	{
-		QUEUE_ITEM *currentItem = myQueue -> firstInQueue;
-
-		while (currentItem)
+		/*--------------------------------------------------------------------------------------------*
+         * Find the first item that the new one sorts before                                          *
+         *--------------------------------------------------------------------------------------------*/
+		items = &myQueue -> queueItems[myQueue -> firstItem];
+		high = myQueue -> itemCount;
+		while (low < high)
 		{
-			int comp = Compare (putData, currentItem -> myData);
-
-			if (comp < 0)
-			{
-				newQueueItem -> myPrevPtr = currentItem -> myPrevPtr;
-				newQueueItem -> myNextPtr = currentItem;
-
-				if (newQueueItem -> myPrevPtr)
-				{
-					QUEUE_ITEM *tempItem = newQueueItem -> myPrevPtr;
-					tempItem -> myNextPtr = newQueueItem;
-				}
-				else
-					myQueue -> firstInQueue = newQueueItem;
-
-				currentItem -> myPrevPtr = newQueueItem;
-				break;
-			}
-			currentItem = currentItem -> myNextPtr;
+			mid = low + ((high - low) >> 1);
+			if (Compare (putData, items[mid]) < 0)
+				high = mid;
+			else
+				low = mid + 1;
 		}
-		if (!currentItem)
+		if (low < myQueue -> itemCount)
 		{
-			myQueue -> lastInQueue -> myNextPtr = newQueueItem;
-			newQueueItem -> myPrevPtr = myQueue -> lastInQueue;
-			myQueue -> lastInQueue = newQueueItem;
+			memmove (&items[low + 1], &items[low], (myQueue -> itemCount - low) * sizeof (void *));
 		}
+		items[low] = putData;
+		myQueue -> itemCount ++;
 	}
-	else
-		myQueue -> firstInQueue = myQueue -> lastInQueue = newQueueItem;
-
-	myQueue -> itemCount ++;
 	queueUnLock (myQueue);
 }
 
@@ -382,17 +381,11 @@ void queuePutSort (void *queueHandle, void *putData,
 void *queueRead (void *queueHandle, int item)
 {
 	QUEUE_HEADER *myQueue = (QUEUE_HEADER *)queueHandle;
-	QUEUE_ITEM *currentItem = myQueue -> firstInQueue;
 	void *retn = NULL;
 
 	queueLock (myQueue);
-	while (currentItem && item > 0)
-	{
-		currentItem = currentItem -> myNextPtr;
-		item --;
-	}
-	if (currentItem)
-		retn = currentItem -> myData;
+	if (item >= 0 && (unsigned long)item < myQueue -> itemCount)
+		retn = myQueue -> queueItems[myQueue -> firstItem + item];
 
 	queueUnLock (myQueue);
 	return retn;
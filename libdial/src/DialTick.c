@@ -0,0 +1,289 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I C K . C                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Run the update tick only when something is next due, instead of on a fixed timer, and track
+ *  whether the window can be seen so the tick can stop drawing.
+ */
+#include <string.h>
+#include <stdlib.h>
+#include "dialsys.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * Waits longer than this use the seconds timer, which GLib can group with other wakeups              *
+ *----------------------------------------------------------------------------------------------------*/
+#define TICK_COARSE			(10 * G_USEC_PER_SEC)
+#define TICK_LONGEST		(60 * G_USEC_PER_SEC)
+
+static DIAL_TICK_FUNC tickFunc = NULL;
+static guint tickSource = 0;
+static gint64 tickDue = 0;
+static bool tickRunning = false;
+static bool windowIconified = false;
+static bool windowObscured = false;
+static bool windowUnmapped = false;
+
+static gboolean dialTickCallback (gpointer data);
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I C K  S C H E D U L E                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Set the timer for the next tick.
+ *  \param due Monotonic time the tick is needed.
+ *  \result None.
+ */
+static void dialTickSchedule (gint64 due)
+{
+	gint64 now = g_get_monotonic_time (), delay;
+
+	if (due > now + TICK_LONGEST)
+		due = now + TICK_LONGEST;
+	if (tickSource != 0)
+	{
+		g_source_remove (tickSource);
+		tickSource = 0;
+	}
+	delay = due > now ? due - now : 0;
+	tickDue = due;
+
+	if (delay >= TICK_COARSE)
+	{
+		tickSource = g_timeout_add_seconds_full (G_PRIORITY_DEFAULT, (guint)(delay / G_USEC_PER_SEC),
+				dialTickCallback, NULL, NULL);
+	}
+	else
+	{
+		tickSource = g_timeout_add_full (G_PRIORITY_DEFAULT, (guint)((delay + 999) / 1000),
+				dialTickCallback, NULL, NULL);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I C K  C A L L B A C K                                                                                 *
+ *  =================================                                                                                 *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Called by the timer, run the tick and ask it when it is next needed.
+ *  \param data Not used.
+ *  \result Always false, the next timer is a new one.
+ */
+static gboolean dialTickCallback (gpointer data)
+{
+	gint64 due;
+
+	tickSource = 0;
+	tickRunning = true;
+	due = tickFunc ();
+	tickRunning = false;
+
+	if (tickFunc != NULL)
+		dialTickSchedule (due);
+	return FALSE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I C K  S T A R T                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Start calling the tick function, it returns the monotonic time it next wants to run.
+ *  \param func Function to call.
+ *  \result None.
+ */
+void dialTickStart (DIAL_TICK_FUNC func)
+{
+	tickFunc = func;
+	dialTickSchedule (g_get_monotonic_time ());
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I C K  S T O P                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Stop calling the tick function.
+ *  \result None.
+ */
+void dialTickStop (void)
+{
+	if (tickSource != 0)
+	{
+		g_source_remove (tickSource);
+		tickSource = 0;
+	}
+	tickFunc = NULL;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I C K  W A K E                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Something has changed, run the tick soon rather than waiting for its deadline. Must be called on the
+ *  main thread, a change made during the tick is picked up by the tick itself.
+ *  \result None.
+ */
+void dialTickWake (void)
+{
+	if (tickFunc == NULL || tickRunning)
+		return;
+
+	if (tickSource == 0 || tickDue > g_get_monotonic_time ())
+		dialTickSchedule (g_get_monotonic_time ());
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I C K  A L I G N                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find the monotonic time of the next wall clock boundary, such as the start of the next second.
+ *  \param period Length of the period in micro-seconds.
+ *  \result Monotonic time of the next boundary.
+ */
+gint64 dialTickAlign (gint64 period)
+{
+	gint64 real = g_get_real_time ();
+
+	return g_get_monotonic_time () + (period - (real % period));
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  W I N D O W  S T A T E  E V E N T                                                                        *
+ *  ==========================================                                                                        *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief The window has been minimised, restored or withdrawn.
+ *  \param widget The main window.
+ *  \param event The new window state.
+ *  \param data Not used.
+ *  \result FALSE so others see the event.
+ */
+static gboolean dialWindowStateEvent (GtkWidget *widget, GdkEventWindowState *event, gpointer data)
+{
+	bool iconified = (event -> new_window_state & (GDK_WINDOW_STATE_ICONIFIED | GDK_WINDOW_STATE_WITHDRAWN)) != 0;
+
+	if (iconified != windowIconified)
+	{
+		windowIconified = iconified;
+		dialTickWake ();
+	}
+	return FALSE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  V I S I B I L I T Y  E V E N T                                                                           *
+ *  =======================================                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief The window has been covered or uncovered, not reported by every window manager or compositor.
+ *  \param widget The main window.
+ *  \param event How much of the window can be seen.
+ *  \param data Not used.
+ *  \result FALSE so others see the event.
+ */
+static gboolean dialVisibilityEvent (GtkWidget *widget, GdkEventVisibility *event, gpointer data)
+{
+	bool obscured = event -> state == GDK_VISIBILITY_FULLY_OBSCURED;
+
+	if (obscured != windowObscured)
+	{
+		windowObscured = obscured;
+		dialTickWake ();
+	}
+	return FALSE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  M A P  E V E N T                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief The window has been mapped or unmapped, such as moving to another workspace.
+ *  \param widget The main window.
+ *  \param event Map or unmap event.
+ *  \param data TRUE if this is the unmap event.
+ *  \result FALSE so others see the event.
+ */
+static gboolean dialMapEvent (GtkWidget *widget, GdkEventAny *event, gpointer data)
+{
+	bool unmapped = GPOINTER_TO_INT (data) != 0;
+
+	if (unmapped != windowUnmapped)
+	{
+		windowUnmapped = unmapped;
+		dialTickWake ();
+	}
+	return FALSE;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  V I S I B L E  I N I T                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Start tracking whether the window can be seen, call once the main window has been made.
+ *  \param window The main window.
+ *  \result None.
+ */
+void dialVisibleInit (GtkWindow *window)
+{
+	gtk_widget_add_events (GTK_WIDGET (window), GDK_VISIBILITY_NOTIFY_MASK | GDK_STRUCTURE_MASK);
+	g_signal_connect (G_OBJECT (window), "window-state-event", G_CALLBACK (dialWindowStateEvent), NULL);
+	g_signal_connect (G_OBJECT (window), "visibility-notify-event", G_CALLBACK (dialVisibilityEvent), NULL);
+	g_signal_connect (G_OBJECT (window), "map-event", G_CALLBACK (dialMapEvent), GINT_TO_POINTER (FALSE));
+	g_signal_connect (G_OBJECT (window), "unmap-event", G_CALLBACK (dialMapEvent), GINT_TO_POINTER (TRUE));
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  V I S I B L E                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check if any of the window can be seen, the tick should not draw if it can not.
+ *  \result True if the window is on screen and not covered.
+ */
+bool dialVisible (void)
+{
+	return !(windowIconified || windowObscured || windowUnmapped);
+}
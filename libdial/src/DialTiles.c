@@ -0,0 +1,409 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I L E S . C                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Draw the faces of a big grid on worker threads, one image tile per face.
+ */
+#include <string.h>
+#include <stdlib.h>
+#include <unistd.h>
+#include "dialsys.h"
+
+#define TILE_MIN_FACES		4
+#define TILE_MAX_THREADS	8
+
+typedef struct _dialTile
+{
+	DIAL_CONTEXT dialContext;
+	cairo_surface_t *surface;
+	int face;
+	int posX;
+	int posY;
+}
+DIAL_TILE;
+
+/*----------------------------------------------------------------------------------------------------*
+ * The tiles of one dial, hung off the context its faces are drawn with. The pool is shared by all    *
+ *----------------------------------------------------------------------------------------------------*/
+typedef struct _dialTiles
+{
+	DIAL_TILE tiles[MAX_FACES];
+	int tileOrder[MAX_FACES];
+	int tileWidth;
+	int tileHeight;
+	double tileScaleX;
+	double tileScaleY;
+	DIAL_DRAW_FACE drawFace;
+	gint tileNext;
+	gint tileCount;
+	gint tileLeft;
+}
+DIAL_TILES;
+
+static GThreadPool *tilePool = NULL;
+static int tileThreads = 0;
+#if GLIB_CHECK_VERSION(2,32,0)
+static GMutex tileMutex;
+static GCond tileCond;
+#define TILE_LOCK()			g_mutex_lock (&tileMutex)
+#define TILE_UNLOCK()		g_mutex_unlock (&tileMutex)
+#define TILE_WAIT()			g_cond_wait (&tileCond, &tileMutex)
+#define TILE_SIGNAL()		g_cond_signal (&tileCond)
+#else
+static GStaticMutex tileMutex = G_STATIC_MUTEX_INIT;
+static GCond *tileCond = NULL;
+#define TILE_LOCK()			g_static_mutex_lock (&tileMutex)
+#define TILE_UNLOCK()		g_static_mutex_unlock (&tileMutex)
+#define TILE_WAIT()			g_cond_wait (tileCond, g_static_mutex_get_mutex (&tileMutex))
+#define TILE_SIGNAL()		g_cond_signal (tileCond)
+#endif
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I L E  D R A W                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw tiles until there are none left, called on the main thread and the pool threads.
+ *  \param data The tiles of the dial being drawn.
+ *  \param userData Not used.
+ *  \result None.
+ */
+static void dialTileDraw (gpointer data, gpointer userData)
+{
+	DIAL_TILES *dialTiles = (DIAL_TILES *)data;
+
+	while (1)
+	{
+		DIAL_TILE *tile;
+		cairo_t *cr;
+		int next = g_atomic_int_get (&dialTiles -> tileNext);
+
+		if (next >= g_atomic_int_get (&dialTiles -> tileCount))
+			break;
+		if (!g_atomic_int_compare_and_exchange (&dialTiles -> tileNext, next, next + 1))
+			continue;
+
+		/*--------------------------------------------------------------------------------------------*
+         * Clear what was there last time, then draw in window co-ordinates                           *
+         *--------------------------------------------------------------------------------------------*/
+		tile = &dialTiles -> tiles[dialTiles -> tileOrder[next]];
+		cr = cairo_create (tile -> surface);
+		cairo_set_operator (cr, CAIRO_OPERATOR_CLEAR);
+		cairo_paint (cr);
+		cairo_set_operator (cr, CAIRO_OPERATOR_OVER);
+		cairo_translate (cr, -tile -> posX, -tile -> posY);
+
+		dialTiles -> drawFace (&tile -> dialContext, cr, tile -> face, tile -> posX, tile -> posY);
+
+		cairo_destroy (cr);
+		cairo_surface_flush (tile -> surface);
+
+		/*--------------------------------------------------------------------------------------------*
+         * Whoever draws the last tile wakes the main thread, it may be waiting for it                *
+         *--------------------------------------------------------------------------------------------*/
+		if (g_atomic_int_dec_and_test (&dialTiles -> tileLeft))
+		{
+			TILE_LOCK ();
+			TILE_SIGNAL ();
+			TILE_UNLOCK ();
+		}
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I L E S  C L E A R                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free the tile surfaces, they are made again at the new size.
+ *  \param dialTiles Tiles of the dial.
+ *  \result None.
+ */
+static void dialTilesClear (DIAL_TILES *dialTiles)
+{
+	int i;
+
+	for (i = 0; i < MAX_FACES; ++i)
+	{
+		if (dialTiles -> tiles[i].surface != NULL)
+		{
+			cairo_surface_destroy (dialTiles -> tiles[i].surface);
+			dialTiles -> tiles[i].surface = NULL;
+		}
+	}
+	dialTiles -> tileWidth = dialTiles -> tileHeight = 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I L E S  R E A D Y                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Make sure the thread pool, the tiles of the dial and a tile surface for each face exist.
+ *  \param dialContext Context the faces are drawn with, the tiles are kept on it.
+ *  \param target Surface the tiles will be painted on.
+ *  \param faceCount Number of faces in the grid.
+ *  \result True if the faces can be drawn as tiles.
+ */
+static bool dialTilesReady (DIAL_CONTEXT *dialContext, cairo_surface_t *target, int faceCount)
+{
+	DIAL_CONFIG *dialConfig = dialContext -> dialConfig;
+	DIAL_TILES *dialTiles = dialContext -> dialTiles;
+	double scaleX = 1.0, scaleY = 1.0;
+	int i, width, height;
+
+	if (tileThreads == 0)
+	{
+#if GLIB_CHECK_VERSION(2,36,0)
+		tileThreads = g_get_num_processors ();
+#else
+		tileThreads = sysconf (_SC_NPROCESSORS_ONLN);
+#endif
+		if (tileThreads > TILE_MAX_THREADS)
+			tileThreads = TILE_MAX_THREADS;
+		if (tileThreads < 1)
+			tileThreads = 1;
+		if (tileThreads > 1)
+		{
+#if !GLIB_CHECK_VERSION(2,32,0)
+			if (!g_thread_supported ())
+				g_thread_init (NULL);
+			tileCond = g_cond_new ();
+#endif
+			tilePool = g_thread_pool_new (dialTileDraw, NULL, tileThreads - 1, FALSE, NULL);
+		}
+	}
+	if (tilePool == NULL)
+		return false;
+	if (dialTiles == NULL)
+	{
+		if ((dialTiles = (DIAL_TILES *)calloc (1, sizeof (DIAL_TILES))) == NULL)
+			return false;
+		dialContext -> dialTiles = dialTiles;
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * Tiles are bitmaps, so they must match the pixel scale of the window on HiDPI screens           *
+     *------------------------------------------------------------------------------------------------*/
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1,14,0)
+	cairo_surface_get_device_scale (target, &scaleX, &scaleY);
+#endif
+	width = (int)(dialConfig -> dialSize * scaleX + 0.5);
+	height = (int)(dialConfig -> dialSize * scaleY + 0.5);
+	if (width != dialTiles -> tileWidth || height != dialTiles -> tileHeight ||
+			scaleX != dialTiles -> tileScaleX || scaleY != dialTiles -> tileScaleY)
+	{
+		dialTilesClear (dialTiles);
+		dialTiles -> tileWidth = width;
+		dialTiles -> tileHeight = height;
+		dialTiles -> tileScaleX = scaleX;
+		dialTiles -> tileScaleY = scaleY;
+	}
+
+	for (i = 0; i < faceCount; ++i)
+	{
+		DIAL_TILE *tile = &dialTiles -> tiles[i];
+
+		if (tile -> surface == NULL)
+		{
+			tile -> surface = cairo_image_surface_create (CAIRO_FORMAT_ARGB32, dialTiles -> tileWidth,
+					dialTiles -> tileHeight);
+			if (cairo_surface_status (tile -> surface) != CAIRO_STATUS_SUCCESS)
+			{
+				cairo_surface_destroy (tile -> surface);
+				tile -> surface = NULL;
+				return false;
+			}
+#if CAIRO_VERSION >= CAIRO_VERSION_ENCODE(1,14,0)
+			cairo_surface_set_device_scale (tile -> surface, dialTiles -> tileScaleX, dialTiles -> tileScaleY);
+#endif
+		}
+	}
+	return true;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  D R A W  F A C E S                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw every face of the grid that is in the clip area, using the default context.
+ *  \param cr Cairo context of the window.
+ *  \param drawFace Function that draws one face using the context it is given.
+ *  \result None.
+ */
+void dialDrawFaces (cairo_t *cr, DIAL_DRAW_FACE drawFace)
+{
+	dialCtxDrawFaces (dialDefaultContext (), cr, drawFace);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  D R A W  F A C E S                                                                                *
+ *  ==================================                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw every face of the grid that is in the clip area, in parallel when the grid is big.
+ *  \param dialContext Context of the dial, it keeps the tiles between frames.
+ *  \param cr Cairo context of the window.
+ *  \param drawFace Function that draws one face using the context it is given.
+ *  \result None.
+ */
+void dialCtxDrawFaces (DIAL_CONTEXT *dialContext, cairo_t *cr, DIAL_DRAW_FACE drawFace)
+{
+	DIAL_CONFIG *dialConfig = dialContext -> dialConfig;
+	DIAL_TILES *dialTiles;
+	int i, j, face, faceCount = dialConfig -> dialWidth * dialConfig -> dialHeight;
+	cairo_surface_t *target = cairo_get_target (cr);
+	bool tiled = dialConfig -> tileRender && faceCount >= TILE_MIN_FACES && faceCount <= MAX_FACES;
+	int count = 0;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Only bitmap windows get tiles when tile_render is on, vector output is drawn straight on       *
+     *------------------------------------------------------------------------------------------------*/
+	switch (cairo_surface_get_type (target))
+	{
+	case CAIRO_SURFACE_TYPE_SVG:
+	case CAIRO_SURFACE_TYPE_PDF:
+	case CAIRO_SURFACE_TYPE_PS:
+		tiled = false;
+		break;
+	default:
+		break;
+	}
+	if (tiled)
+		tiled = dialTilesReady (dialContext, target, faceCount);
+
+	if (!tiled)
+	{
+		for (face = 0; face < faceCount; ++face)
+		{
+			i = (face % dialConfig -> dialWidth) * dialConfig -> dialSize;
+			j = (face / dialConfig -> dialWidth) * dialConfig -> dialSize;
+			if (dialCtxFaceInClip (dialContext, cr, i, j))
+				drawFace (dialContext, cr, face, i, j);
+		}
+		return;
+	}
+	dialTiles = dialContext -> dialTiles;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Queue a tile for each face that needs drawing. Each face keeps its own drawing context, only   *
+     * the cairo and position parts are cleared so the hand points it holds last between frames       *
+     *------------------------------------------------------------------------------------------------*/
+	for (face = 0; face < faceCount; ++face)
+	{
+		i = (face % dialConfig -> dialWidth) * dialConfig -> dialSize;
+		j = (face / dialConfig -> dialWidth) * dialConfig -> dialSize;
+		if (dialCtxFaceInClip (dialContext, cr, i, j))
+		{
+			DIAL_TILE *tile = &dialTiles -> tiles[face];
+
+			dialTiles -> tileOrder[count++] = face;
+			tile -> dialContext.dialConfig = dialConfig;
+			tile -> dialContext.cairo = NULL;
+			tile -> dialContext.posX = tile -> dialContext.posY = 0;
+			tile -> dialContext.centreX = tile -> dialContext.centreY = 0;
+			tile -> dialContext.cacheCairo = tile -> dialContext.cacheSaveCairo = NULL;
+			tile -> dialContext.cacheFace = -1;
+			tile -> face = face;
+			tile -> posX = i;
+			tile -> posY = j;
+		}
+	}
+	if (count == 0)
+		return;
+
+	/*------------------------------------------------------------------------------------------------*
+     * A pool thread from the last frame may still be looking for work, keep it out until all is set  *
+     *------------------------------------------------------------------------------------------------*/
+	g_atomic_int_set (&dialTiles -> tileNext, MAX_FACES);
+	dialTiles -> drawFace = drawFace;
+	g_atomic_int_set (&dialTiles -> tileLeft, count);
+	g_atomic_int_set (&dialTiles -> tileCount, count);
+	g_atomic_int_set (&dialTiles -> tileNext, 0);
+	for (i = 1; i < tileThreads && i < count; ++i)
+	{
+		if (!g_thread_pool_push (tilePool, dialTiles, NULL))
+			break;
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * Help out on this thread, then sleep until the pool has finished the last tiles                 *
+     *------------------------------------------------------------------------------------------------*/
+	dialTileDraw (dialTiles, NULL);
+	TILE_LOCK ();
+	while (g_atomic_int_get (&dialTiles -> tileLeft) > 0)
+		TILE_WAIT ();
+	TILE_UNLOCK ();
+
+	for (i = 0; i < count; ++i)
+	{
+		DIAL_TILE *tile = &dialTiles -> tiles[dialTiles -> tileOrder[i]];
+
+		cairo_set_source_surface (cr, tile -> surface, tile -> posX, tile -> posY);
+		cairo_rectangle (cr, tile -> posX, tile -> posY, dialConfig -> dialSize, dialConfig -> dialSize);
+		cairo_fill (cr);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T I L E S  F R E E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free the tiles of the default context, the thread pool is kept until the program ends.
+ *  \result None.
+ */
+void dialTilesFree (void)
+{
+	dialCtxTilesFree (dialDefaultContext ());
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  C T X  T I L E S  F R E E                                                                                *
+ *  ==================================                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free the tiles kept on a context, called when the context is freed.
+ *  \param dialContext Context the tiles are kept on.
+ *  \result None.
+ */
+void dialCtxTilesFree (DIAL_CONTEXT *dialContext)
+{
+	if (dialContext -> dialTiles != NULL)
+	{
+		dialTilesClear (dialContext -> dialTiles);
+		free (dialContext -> dialTiles);
+		dialContext -> dialTiles = NULL;
+	}
+}
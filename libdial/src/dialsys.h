@@ -84,6 +84,8 @@ GtkWidget *createMenu (MENU_DESC *subMenuDesc, GtkAccelGroup *accelGroup, int ba
 #define SCALE_3				900
 #define SCALE_4				1200
 #define MAX_FACES 			50
+#define HAND_CACHE_SIZE		16
+#define HAND_MAX_POINTS		7
 #define _(String) 			gettext (String)
 #define __(String) 			(String)
 
@@ -116,7 +118,7 @@ typedef struct _handStyle
 HAND_STYLE;
 
 /*----------------------------------------------------------------------------------------------------*
- * Dial config                                                                                        *
+ * Dial config, the face cache and the faces waiting to be redrawn belong to the dial they are for    *
  *----------------------------------------------------------------------------------------------------*/
 typedef struct _dialConfig
 {
@@ -134,15 +136,63 @@ typedef struct _dialConfig
 	void(*UpdateFunc)(void); 
 	void(*DialSave)(char *path);
 	COLOUR_DETAILS *colourDetails;
+	bool handSprites;
+	bool tileRender;
+	struct _faceCache *faceCache;
+	guint64 dirtyFaces;
 }
 DIAL_CONFIG;
 
+/*----------------------------------------------------------------------------------------------------*
+ * Points of a hand relative to its centre, kept until the hand moves                                 *
+ *----------------------------------------------------------------------------------------------------*/
+typedef struct _handGeometry
+{
+	int dialSize;
+	int style;
+	int length;
+	int tail;
+	int angle;
+	int numPoints;
+	int points[HAND_MAX_POINTS * 2];
+}
+HAND_GEOMETRY;
+
+/*----------------------------------------------------------------------------------------------------*
+ * Drawing context, the functions without one use a default context                                   *
+ *----------------------------------------------------------------------------------------------------*/
+typedef struct _dialContext
+{
+	DIAL_CONFIG *dialConfig;
+	cairo_t *cairo;
+	int posX;
+	int posY;
+	int centreX;
+	int centreY;
+	cairo_t *cacheCairo;
+	cairo_t *cacheSaveCairo;
+	int cacheFace;
+	HAND_GEOMETRY handCache[HAND_CACHE_SIZE];
+	int handNext;
+	struct _dialTiles *dialTiles;
+}
+DIAL_CONTEXT;
+
+typedef void (*DIAL_DRAW_FACE) (DIAL_CONTEXT *dialContext, cairo_t *cr, int face, int posX, int posY);
+typedef gint64 (*DIAL_TICK_FUNC) (void);
+
 /*----------------------------------------------------------------------------------------------------*
  * Prototypes for dial display                                                                        *
  *----------------------------------------------------------------------------------------------------*/
 GtkWidget *dialInit 	(DIAL_CONFIG *dialConfig);
 void dialDrawStart 		(cairo_t *cr, int posX, int posY);
 void dialDrawFinish 	(void);
+bool dialFaceCacheStart	(int face, char *faceKey);
+void dialFaceCacheFinish (void);
+void dialFaceCacheInvalidate (int face);
+void dialFaceDirty		(int face);
+int dialQueueDirtyFaces	(void);
+bool dialFaceInClip		(cairo_t *cr, int posX, int posY);
 
 void dialDrawMinute		(int size, int len, int angle, int colour);
 void dialDrawCircle		(int size, int colFill, int colOut);
@@ -164,10 +214,56 @@ void dialDrawTextX		(int posX, int posY, char *string1, int colour, int scale);
 void dialCircleGradientX (int posX, int posY, int size, int colFill, int style);
 void dialSquareGradientX (int posX, int posY, int size, int colFill, int style);
 
+DIAL_CONTEXT *dialContextCreate (DIAL_CONFIG *dialConfig);
+void dialContextFree	(DIAL_CONTEXT *dialContext);
+DIAL_CONTEXT *dialDefaultContext (void);
+void dialCtxDrawStart	(DIAL_CONTEXT *dialContext, cairo_t *cr, int posX, int posY);
+void dialCtxDrawFinish	(DIAL_CONTEXT *dialContext);
+bool dialCtxFaceCacheStart (DIAL_CONTEXT *dialContext, int face, char *faceKey);
+void dialCtxFaceCacheFinish (DIAL_CONTEXT *dialContext);
+bool dialCtxFaceInClip	(DIAL_CONTEXT *dialContext, cairo_t *cr, int posX, int posY);
+void dialCtxFaceCacheInvalidate (DIAL_CONTEXT *dialContext, int face);
+void dialCtxFaceDirty	(DIAL_CONTEXT *dialContext, int face);
+int dialCtxQueueDirtyFaces (DIAL_CONTEXT *dialContext);
+
+void dialCtxDrawMinute	(DIAL_CONTEXT *dialContext, int size, int len, int angle, int colour);
+void dialCtxDrawCircle	(DIAL_CONTEXT *dialContext, int size, int colFill, int colOut);
+void dialCtxDrawSquare	(DIAL_CONTEXT *dialContext, int size, int colFill, int colOut);
+void dialCtxHotCold		(DIAL_CONTEXT *dialContext, int size, int colFill, int cold);
+void dialCtxDrawHand	(DIAL_CONTEXT *dialContext, int angle, HAND_STYLE *handStyle);
+void dialCtxDrawMark	(DIAL_CONTEXT *dialContext, int angle, int size, int colFill, int colOut, char *text);
+void dialCtxDrawText	(DIAL_CONTEXT *dialContext, int posn, char *string1, int colour);
+void dialCtxCircleGradient (DIAL_CONTEXT *dialContext, int size, int colFill, int style);
+void dialCtxSquareGradient (DIAL_CONTEXT *dialContext, int size, int colFill, int style);
+
+void dialCtxDrawMinuteX	(DIAL_CONTEXT *dialContext, int posX, int posY, int size, int len, int angle, int colour);
+void dialCtxDrawCircleX	(DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int colOut);
+void dialCtxDrawSquareX	(DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int colOut);
+void dialCtxHotColdX	(DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int cold);
+void dialCtxDrawHandX	(DIAL_CONTEXT *dialContext, int posX, int posY, int angle, HAND_STYLE *handStyle);
+void dialCtxDrawMarkX	(DIAL_CONTEXT *dialContext, int posX, int posY, int angle, int size, int colFill, int colOut,
+							char *text);
+void dialCtxDrawTextX	(DIAL_CONTEXT *dialContext, int posX, int posY, char *string1, int colour, int scale);
+void dialCtxCircleGradientX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int style);
+void dialCtxSquareGradientX (DIAL_CONTEXT *dialContext, int posX, int posY, int size, int colFill, int style);
+
+void dialDrawFaces		(cairo_t *cr, DIAL_DRAW_FACE drawFace);
+void dialTilesFree		(void);
+void dialCtxDrawFaces	(DIAL_CONTEXT *dialContext, cairo_t *cr, DIAL_DRAW_FACE drawFace);
+void dialCtxTilesFree	(DIAL_CONTEXT *dialContext);
+
+void dialTickStart		(DIAL_TICK_FUNC func);
+void dialTickStop		(void);
+void dialTickWake		(void);
+gint64 dialTickAlign	(gint64 period);
+void dialVisibleInit	(GtkWindow *window);
+bool dialVisible		(void);
+
 void dialGetScreenSize	(int *width, int *height);
 int dialSin 			(int number, int angle);
 int dialCos 			(int number, int angle);
 float dialGetFontSize 	(char *fontName);
+void dialTextCacheStats	(unsigned long *hits, unsigned long *misses);
 void dialSetOpacity		();
 
 void dialFontCallback 	(guint data);
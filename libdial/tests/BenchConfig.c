@@ -0,0 +1,94 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  C O N F I G . C                                                                                        *
+ *  ==========================                                                                                        *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Time loading, reading and saving a 10k line config file.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "dialsys.h"
+#include "DialTest.h"
+
+#define BENCH_LINES	10000
+
+static char *loadFile = "benchConfig-load.tmp";
+static char *saveFile = "benchConfig-save.tmp";
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Write a config with a value per face like the apps do, then time the config calls on it.
+ *  \result 0 if every value was found.
+ */
+int main (void)
+{
+	char name[81], value[81], expect[81];
+	double start, loadTime, getTime, setTime, saveTime;
+	FILE *outFile;
+	int i, ok = 1;
+
+	if ((outFile = fopen (loadFile, "w")) == NULL)
+		return 1;
+	for (i = 0; i < BENCH_LINES; ++i)
+		fprintf (outFile, "face_%d_sub_type_%d = \"%d\"\n", i / 10, i % 10, i);
+	fclose (outFile);
+
+	start = testTimeNow ();
+	TEST_CHECK (configLoad (loadFile));
+	loadTime = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_LINES; ++i)
+	{
+		sprintf (name, "face_%d_sub_type_%d", i / 10, i % 10);
+		sprintf (expect, "%d", i);
+		ok &= configGetValue (name, value, 80) && strcmp (value, expect) == 0;
+	}
+	getTime = testTimeNow () - start;
+	TEST_CHECK (ok);
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_LINES; ++i)
+	{
+		sprintf (name, "face_%d_sub_type_%d", i / 10, i % 10);
+		ok &= configSetIntValue (name, i + 1);
+	}
+	setTime = testTimeNow () - start;
+	TEST_CHECK (ok);
+
+	start = testTimeNow ();
+	TEST_CHECK (configSave (saveFile));
+	saveTime = testTimeNow () - start;
+
+	printf ("%d lines\n", BENCH_LINES);
+	printf ("load          %9.3f ms\n", loadTime * 1000);
+	printf ("get each      %9.3f ms\n", getTime * 1000);
+	printf ("set each      %9.3f ms\n", setTime * 1000);
+	printf ("save          %9.3f ms\n", saveTime * 1000);
+
+	configFree ();
+	remove (loadFile);
+	remove (saveFile);
+	return testResult ("benchConfig");
+}
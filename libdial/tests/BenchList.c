@@ -0,0 +1,255 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  L I S T . C                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Time the array queue against the linked list it replaced on 10k items.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include "dialsys.h"
+#include "DialTest.h"
+
+#define BENCH_ITEMS	10000
+
+/*----------------------------------------------------------------------------------------------------*
+ * A cut down copy of the old linked list, only what is needed to time it the same way                *
+ *----------------------------------------------------------------------------------------------------*/
+typedef struct _oldItem
+{
+	struct _oldItem *myNextPtr;
+	struct _oldItem *myPrevPtr;
+	void *myData;
+}
+OLD_ITEM;
+
+typedef struct _oldQueue
+{
+	OLD_ITEM *firstInQueue;
+	OLD_ITEM *lastInQueue;
+	unsigned long itemCount;
+}
+OLD_QUEUE;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  P U T  S O R T                                                                                             *
+ *  =====================                                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Put an item on the old list in sorted order, walking from the start.
+ *  \param myQueue List to add to.
+ *  \param putData Item to add.
+ *  \param Compare Function used to sort.
+ *  \result None.
+ */
+static void oldPutSort (OLD_QUEUE *myQueue, void *putData, int(*Compare)(void *item1, void *item2))
+{
+	OLD_ITEM *newItem, *currentItem = myQueue -> firstInQueue;
+
+	if ((newItem = malloc (sizeof (OLD_ITEM))) == NULL)
+		return;
+
+	newItem -> myData = putData;
+	while (currentItem && Compare (putData, currentItem -> myData) >= 0)
+		currentItem = currentItem -> myNextPtr;
+
+	newItem -> myNextPtr = currentItem;
+	newItem -> myPrevPtr = currentItem ? currentItem -> myPrevPtr : myQueue -> lastInQueue;
+	if (newItem -> myPrevPtr)
+		newItem -> myPrevPtr -> myNextPtr = newItem;
+	else
+		myQueue -> firstInQueue = newItem;
+	if (currentItem)
+		currentItem -> myPrevPtr = newItem;
+	else
+		myQueue -> lastInQueue = newItem;
+
+	myQueue -> itemCount ++;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  P U T                                                                                                      *
+ *  ============                                                                                                      *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Put an item on the end of the old list.
+ *  \param myQueue List to add to.
+ *  \param putData Item to add.
+ *  \result None.
+ */
+static void oldPut (OLD_QUEUE *myQueue, void *putData)
+{
+	OLD_ITEM *newItem;
+
+	if ((newItem = malloc (sizeof (OLD_ITEM))) == NULL)
+		return;
+
+	newItem -> myData = putData;
+	newItem -> myNextPtr = NULL;
+	newItem -> myPrevPtr = myQueue -> lastInQueue;
+	if (myQueue -> lastInQueue)
+		myQueue -> lastInQueue -> myNextPtr = newItem;
+	else
+		myQueue -> firstInQueue = newItem;
+	myQueue -> lastInQueue = newItem;
+	myQueue -> itemCount ++;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  R E A D                                                                                                    *
+ *  ==============                                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read an item from the old list by walking to it.
+ *  \param myQueue List to read.
+ *  \param item Item number to read.
+ *  \result The item or NULL.
+ */
+static void *oldRead (OLD_QUEUE *myQueue, int item)
+{
+	OLD_ITEM *currentItem = myQueue -> firstInQueue;
+
+	while (currentItem && item > 0)
+	{
+		currentItem = currentItem -> myNextPtr;
+		item --;
+	}
+	return currentItem ? currentItem -> myData : NULL;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  F R E E                                                                                                    *
+ *  ==============                                                                                                    *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free the old list.
+ *  \param myQueue List to free.
+ *  \result None.
+ */
+static void oldFree (OLD_QUEUE *myQueue)
+{
+	OLD_ITEM *nextItem;
+
+	while (myQueue -> firstInQueue)
+	{
+		nextItem = myQueue -> firstInQueue -> myNextPtr;
+		free (myQueue -> firstInQueue);
+		myQueue -> firstInQueue = nextItem;
+	}
+	myQueue -> lastInQueue = NULL;
+	myQueue -> itemCount = 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O M P A R E  K E Y S                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Sort on the number pointed to.
+ *  \param item1 First item.
+ *  \param item2 Second item.
+ *  \result Less than, equal to or greater than zero.
+ */
+static int compareKeys (void *item1, void *item2)
+{
+	return *(int *)item1 - *(int *)item2;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Put, sort and read 10k items on both, reading every item by index like configSave did.
+ *  \result 0 if both gave the same answers.
+ */
+int main (void)
+{
+	OLD_QUEUE oldQueue = { NULL, NULL, 0 };
+	void *newQueue = queueCreate ();
+	int *keys, i, ok = 1;
+	long oldSum = 0, newSum = 0;
+	double start, oldPutTime, newPutTime, oldReadTime, newReadTime, oldSortTime, newSortTime;
+
+	if ((keys = malloc (BENCH_ITEMS * sizeof (int))) == NULL)
+		return 1;
+	srand (1);
+	for (i = 0; i < BENCH_ITEMS; ++i)
+		keys[i] = rand ();
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_ITEMS; ++i)
+		oldPut (&oldQueue, &keys[i]);
+	oldPutTime = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_ITEMS; ++i)
+		queuePut (newQueue, &keys[i]);
+	newPutTime = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_ITEMS; ++i)
+		oldSum += *(int *)oldRead (&oldQueue, i);
+	oldReadTime = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_ITEMS; ++i)
+		newSum += *(int *)queueRead (newQueue, i);
+	newReadTime = testTimeNow () - start;
+	TEST_CHECK (oldSum == newSum);
+
+	oldFree (&oldQueue);
+	while (queueGet (newQueue) != NULL)
+		;
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_ITEMS; ++i)
+		oldPutSort (&oldQueue, &keys[i], compareKeys);
+	oldSortTime = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_ITEMS; ++i)
+		queuePutSort (newQueue, &keys[i], compareKeys);
+	newSortTime = testTimeNow () - start;
+
+	for (i = 0; i < BENCH_ITEMS && ok; ++i)
+		ok = oldRead (&oldQueue, i) == queueRead (newQueue, i);
+	TEST_CHECK (ok);
+
+	printf ("%d items          old list     new queue\n", BENCH_ITEMS);
+	printf ("put             %9.3f ms  %9.3f ms\n", oldPutTime * 1000, newPutTime * 1000);
+	printf ("read by index   %9.3f ms  %9.3f ms\n", oldReadTime * 1000, newReadTime * 1000);
+	printf ("put sorted      %9.3f ms  %9.3f ms\n", oldSortTime * 1000, newSortTime * 1000);
+
+	oldFree (&oldQueue);
+	queueDelete (newQueue);
+	free (keys);
+	return testResult ("benchList");
+}
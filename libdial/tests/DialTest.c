@@ -0,0 +1,90 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T E S T . C                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Small helpers shared by the check and benchmark programs.
+ */
+#include <stdio.h>
+#include <time.h>
+#include "DialTest.h"
+
+static int testFailed = 0;
+static int testPassed = 0;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  C H E C K                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Count a check and say where it failed.
+ *  \param passed True if the check passed.
+ *  \param testText The check as it was written.
+ *  \param fileName File the check is in.
+ *  \param line Line the check is on.
+ *  \result None.
+ */
+void testCheck (int passed, const char *testText, const char *fileName, int line)
+{
+	if (passed)
+	{
+		++testPassed;
+	}
+	else
+	{
+		fprintf (stderr, "%s:%d: check failed: %s\n", fileName, line, testText);
+		++testFailed;
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  T I M E  N O W                                                                                           *
+ *  =======================                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the monotonic clock for timing the benchmarks.
+ *  \result The time in seconds.
+ */
+double testTimeNow (void)
+{
+	struct timespec now;
+
+	clock_gettime (CLOCK_MONOTONIC, &now);
+	return (double)now.tv_sec + (double)now.tv_nsec / 1000000000.0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  R E S U L T                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Print how the checks went.
+ *  \param testName Name of the program.
+ *  \result Exit status for make check, 0 if all the checks passed.
+ */
+int testResult (const char *testName)
+{
+	printf ("%s: %d passed, %d failed\n", testName, testPassed, testFailed);
+	return testFailed ? 1 : 0;
+}
@@ -0,0 +1,35 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D I A L  T E S T . H                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Small helpers shared by the check and benchmark programs.
+ */
+#ifndef INCLUDE_DIALTEST_H
+#define INCLUDE_DIALTEST_H
+
+/*----------------------------------------------------------------------------------------------------*
+ * A failed check is reported and counted, then it carries on so all the failures are seen            *
+ *----------------------------------------------------------------------------------------------------*/
+#define TEST_CHECK(test)	testCheck ((test) != 0, #test, __FILE__, __LINE__)
+
+void testCheck (int passed, const char *testText, const char *fileName, int line);
+double testTimeNow (void);
+int testResult (const char *testName);
+
+#endif
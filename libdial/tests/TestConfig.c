@@ -0,0 +1,208 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  C O N F I G . C                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Check the config store finds, replaces and saves entries in the order they were added.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdbool.h>
+#include "dialsys.h"
+#include "DialTest.h"
+
+#define TEST_ENTRIES	10000
+
+static char *loadFile = "testConfig-load.tmp";
+static char *saveFile = "testConfig-save.tmp";
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  W R I T E  F I L E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Write out a config file to load.
+ *  \param fileName Name of the file.
+ *  \param fileText What to put in it.
+ *  \result True if it was written.
+ */
+static int writeFile (const char *fileName, const char *fileText)
+{
+	FILE *outFile;
+
+	if ((outFile = fopen (fileName, "w")) == NULL)
+		return 0;
+	fputs (fileText, outFile);
+	fclose (outFile);
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  L O A D                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Load a small file with comments and quotes, then read back the values.
+ *  \result None.
+ */
+static void testLoad (void)
+{
+	char value[81];
+	int intValue = 0;
+	bool boolValue = false;
+
+	TEST_CHECK (writeFile (loadFile,
+			"# a comment line\n"
+			"face_size = 128\n"
+			"  always_on_top=true   # a comment after\n"
+			"font_name = \"Sans Bold 10\"\n"
+			"not a config line\n"
+			"face_size = 256\n"
+			"show_seconds = 0\n"));
+	TEST_CHECK (configLoad (loadFile));
+
+	TEST_CHECK (configGetIntValue ("face_size", &intValue) && intValue == 256);
+	TEST_CHECK (configGetBoolValue ("always_on_top", &boolValue) && boolValue);
+	TEST_CHECK (configGetBoolValue ("show_seconds", &boolValue) && !boolValue);
+	TEST_CHECK (configGetValue ("font_name", value, 80) && strcmp (value, "Sans Bold 10") == 0);
+	TEST_CHECK (!configGetValue ("not", value, 80));
+	TEST_CHECK (!configGetValue ("missing", value, 80));
+	TEST_CHECK (configGetValue ("font_name", value, 4) && strcmp (value, "Sans") == 0);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  S A V E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Change and add values, save, and check the file keeps the order the names were first seen.
+ *  \result None.
+ */
+static void testSave (void)
+{
+	static char *expectLines[] =
+	{
+		"face_size = \"64\"\n",
+		"always_on_top = \"true\"\n",
+		"font_name = \"Sans Bold 10\"\n",
+		"show_seconds = \"false\"\n",
+		"new_value = \"hello world\"\n",
+		NULL
+	};
+	char readBuff[256];
+	FILE *inFile;
+	int i = 0, ok = 1;
+
+	TEST_CHECK (configSetIntValue ("face_size", 64));
+	TEST_CHECK (configSetBoolValue ("show_seconds", false));
+	TEST_CHECK (configSetValue ("new_value", "hello world"));
+	TEST_CHECK (configSave (saveFile));
+
+	if ((inFile = fopen (saveFile, "r")) == NULL)
+	{
+		TEST_CHECK (inFile != NULL);
+		return;
+	}
+	while (fgets (readBuff, 256, inFile))
+	{
+		if (readBuff[0] == '#')
+			continue;
+		if (expectLines[i] == NULL || strcmp (readBuff, expectLines[i]) != 0)
+			ok = 0;
+		else
+			++i;
+	}
+	fclose (inFile);
+	TEST_CHECK (ok && expectLines[i] == NULL);
+
+	/*------------------------------------------------------------------------------------------------*
+     * Loading what was saved must give the same values back                                          *
+     *------------------------------------------------------------------------------------------------*/
+	configFree ();
+	TEST_CHECK (!configGetValue ("face_size", readBuff, 80));
+	TEST_CHECK (configLoad (saveFile));
+	TEST_CHECK (configGetIntValue ("face_size", &i) && i == 64);
+	TEST_CHECK (configGetValue ("new_value", readBuff, 80) && strcmp (readBuff, "hello world") == 0);
+	configFree ();
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  M A N Y                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Add enough entries to grow the hash table many times, replace some and find them all.
+ *  \result None.
+ */
+static void testMany (void)
+{
+	char name[41], value[41], expect[41];
+	int i, ok = 1;
+
+	for (i = 0; i < TEST_ENTRIES; ++i)
+	{
+		sprintf (name, "face_%d_value", i);
+		sprintf (value, "%d", i);
+		ok &= configSetValue (name, value);
+	}
+	TEST_CHECK (ok);
+	for (i = 0; i < TEST_ENTRIES; i += 2)
+	{
+		sprintf (name, "face_%d_value", i);
+		ok &= configSetIntValue (name, -i);
+	}
+	TEST_CHECK (ok);
+	for (i = 0; i < TEST_ENTRIES && ok; ++i)
+	{
+		sprintf (name, "face_%d_value", i);
+		sprintf (expect, "%d", i & 1 ? i : -i);
+		ok = configGetValue (name, value, 40) && strcmp (value, expect) == 0;
+	}
+	TEST_CHECK (ok);
+	TEST_CHECK (!configGetValue ("face_10000_value", value, 40));
+	configFree ();
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Run the checks.
+ *  \result 0 if all the checks passed.
+ */
+int main (void)
+{
+	testLoad ();
+	testSave ();
+	testMany ();
+	remove (loadFile);
+	remove (saveFile);
+	return testResult ("testConfig");
+}
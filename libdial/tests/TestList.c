@@ -0,0 +1,202 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  L I S T . C                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Check the queue functions keep their order, sort and index the same as the old list.
+ */
+#include <stdlib.h>
+#include <string.h>
+#include "dialsys.h"
+#include "DialTest.h"
+
+#define TEST_ITEMS	10000
+
+typedef struct _sortItem
+{
+	int key;
+	int order;
+}
+SORT_ITEM;
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C O M P A R E  I T E M S                                                                                          *
+ *  ========================                                                                                          *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Compare two items on the key only so equal keys show if the sort is stable.
+ *  \param item1 First item.
+ *  \param item2 Second item.
+ *  \result Less than, equal to or greater than zero.
+ */
+static int compareItems (void *item1, void *item2)
+{
+	SORT_ITEM *sortItem1 = (SORT_ITEM *)item1;
+	SORT_ITEM *sortItem2 = (SORT_ITEM *)item2;
+
+	return sortItem1 -> key - sortItem2 -> key;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  P U T  G E T                                                                                             *
+ *  =====================                                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Items come off in the order they went on and can be read by index as it grows.
+ *  \result None.
+ */
+static void testPutGet (void)
+{
+	void *queue = queueCreate ();
+	long i, ok = 1;
+
+	TEST_CHECK (queue != NULL);
+	TEST_CHECK (queueGet (queue) == NULL);
+	TEST_CHECK (queueRead (queue, 0) == NULL);
+
+	for (i = 1; i <= TEST_ITEMS; ++i)
+		queuePut (queue, (void *)i);
+	TEST_CHECK (queueGetItemCount (queue) == TEST_ITEMS);
+
+	for (i = 0; i < TEST_ITEMS && ok; ++i)
+		ok = queueRead (queue, i) == (void *)(i + 1);
+	TEST_CHECK (ok);
+	TEST_CHECK (queueRead (queue, -1) == NULL);
+	TEST_CHECK (queueRead (queue, TEST_ITEMS) == NULL);
+
+	for (i = 1; i <= TEST_ITEMS && ok; ++i)
+		ok = queueGet (queue) == (void *)i;
+	TEST_CHECK (ok);
+	TEST_CHECK (queueGetItemCount (queue) == 0);
+	TEST_CHECK (queueGet (queue) == NULL);
+	queueDelete (queue);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  P U S H                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Mix pushes and puts, pushed items come off first in reverse order.
+ *  \result None.
+ */
+static void testPush (void)
+{
+	void *queue = queueCreate ();
+	long i, ok = 1;
+
+	for (i = 1; i <= TEST_ITEMS; ++i)
+	{
+		queuePush (queue, (void *)-i);
+		queuePut (queue, (void *)i);
+	}
+	TEST_CHECK (queueGetItemCount (queue) == TEST_ITEMS * 2);
+	TEST_CHECK (queueRead (queue, 0) == (void *)-TEST_ITEMS);
+	TEST_CHECK (queueRead (queue, TEST_ITEMS) == (void *)1);
+
+	for (i = TEST_ITEMS; i >= 1 && ok; --i)
+		ok = queueGet (queue) == (void *)-i;
+	for (i = 1; i <= TEST_ITEMS && ok; ++i)
+		ok = queueGet (queue) == (void *)i;
+	TEST_CHECK (ok);
+
+	/*------------------------------------------------------------------------------------------------*
+     * Taking from the front and putting on the end must not keep growing the array                   *
+     *------------------------------------------------------------------------------------------------*/
+	for (i = 0; i < TEST_ITEMS * 10; ++i)
+	{
+		queuePut (queue, (void *)i);
+		ok &= queueGet (queue) == (void *)i;
+	}
+	TEST_CHECK (ok);
+	TEST_CHECK (queueGetItemCount (queue) == 0);
+
+	queueSetFreeData (queue, 1234);
+	TEST_CHECK (queueGetFreeData (queue) == 1234);
+	queueDelete (queue);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  P U T  S O R T                                                                                           *
+ *  =======================                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Random keys with lots of repeats come out sorted, and equal keys stay in the order they were
+ *  put on, the same as the old list did.
+ *  \result None.
+ */
+static void testPutSort (void)
+{
+	void *queue = queueCreate ();
+	SORT_ITEM *items, *thisItem, *lastItem = NULL;
+	int i, ok = 1;
+
+	if ((items = malloc (TEST_ITEMS * sizeof (SORT_ITEM))) == NULL)
+	{
+		TEST_CHECK (items != NULL);
+		return;
+	}
+	srand (1);
+	for (i = 0; i < TEST_ITEMS; ++i)
+	{
+		items[i].key = rand () % 500;
+		items[i].order = i;
+		queuePutSort (queue, &items[i], compareItems);
+	}
+	TEST_CHECK (queueGetItemCount (queue) == TEST_ITEMS);
+
+	for (i = 0; i < TEST_ITEMS && ok; ++i)
+	{
+		thisItem = queueRead (queue, i);
+		if (lastItem != NULL)
+		{
+			ok = lastItem -> key < thisItem -> key ||
+					(lastItem -> key == thisItem -> key && lastItem -> order < thisItem -> order);
+		}
+		lastItem = thisItem;
+	}
+	TEST_CHECK (ok);
+	queueDelete (queue);
+	free (items);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Run the checks.
+ *  \result 0 if all the checks passed.
+ */
+int main (void)
+{
+	testPutGet ();
+	testPush ();
+	testPutSort ();
+	return testResult ("testList");
+}
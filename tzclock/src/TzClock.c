@@ -243,6 +243,7 @@ static int keyPressFaceNum		= -1;
 static int stopwatchActive		=  0;
 static time_t lastTime			= -1;
 static int bounceSec			=  0;
+static int wasHidden			=  0;
 
 /*----------------------------------------------------------------------------------------------------*
  *                                                                                                    *
@@ -277,7 +278,9 @@ CLOCK_INST clockInst =
 		&clockInst.fontName[0],		/* Font name pointer */
 		updateClock,				/* Update func. */
 		dialSave,					/* Save func. */
-		&colourNames[0]				/* Colour details */
+		&colourNames[0],			/* Colour details */
+		FALSE,						/* Hand sprites */
+		TRUE						/* Tile render */
 	}
 };
 
@@ -302,7 +305,7 @@ static void processCommandLine		(int argc, char *argv[], int *posX, int *posY);
 static void howTo					(FILE * outFile, char *format, ...);
 static void checkForAlarm			(FACE_SETTINGS *faceSetting, struct tm *tm);
 
-static gboolean clockTickCallback	(gpointer data);
+static gint64 clockTickCallback		(void);
 static gboolean windowClickCallback (GtkWidget * widget, GdkEventButton * event);
 static gboolean windowKeyCallback	(GtkWidget * widget, GdkEventKey * event);
 static gboolean focusInEvent		(GtkWidget *widget, GdkEventFocus *event, gpointer data);
@@ -527,15 +530,6 @@ copyCallback (guint data)
 	int timeZone = clockInst.faceSettings[clockInst.currentFace] -> currentTZ;
 
 	t = time (NULL);
-	if (timeZones[timeZone].value == 0)
-	{
-		unsetenv ("TZ");
-	}
-	else
-	{
-		setenv ("TZ", timeZones[timeZone].envName, 1);
-	}
-	localtime (&t);
 
 	switch (data)
 	{
@@ -579,6 +573,7 @@ setTimeZoneCallback (guint data)
 	sprintf (value, "timezone_city_%d", clockInst.currentFace + 1);
 	configSetValue (value, clockInst.faceSettings[clockInst.currentFace] -> currentTZCity);
 	lastTime = -1;
+	dialTickWake ();
 }
 
 /**********************************************************************************************************************
@@ -671,18 +666,11 @@ calendarCallback (guint data)
 	GtkWidget *vbox;
 #endif
 
-	int timeZone = clockInst.faceSettings[clockInst.currentFace] -> currentTZ;
+	GtkWidget *calendar;
+	struct tm tm;
 
 	t = time (NULL);
-	if (timeZones[timeZone].value == 0)
-	{
-		unsetenv ("TZ");
-	}
-	else
-	{
-		setenv ("TZ", timeZones[timeZone].envName, 1);
-	}
-	localtime (&t);
+	getTheFaceTime (clockInst.faceSettings[clockInst.currentFace], &t, &tm);
 
 	dialog = gtk_dialog_new_with_buttons (_("Clock calendar"), GTK_WINDOW(clockInst.dialConfig.mainWindow),
 						GTK_DIALOG_MODAL | GTK_DIALOG_DESTROY_WITH_PARENT,
@@ -693,13 +681,20 @@ calendarCallback (guint data)
 #endif
 						GTK_RESPONSE_NONE, NULL);
 
+	/*------------------------------------------------------------------------------------------------*
+	 * Show the date in the face's timezone, not the local one.                                       *
+	 *------------------------------------------------------------------------------------------------*/
+	calendar = gtk_calendar_new ();
+	gtk_calendar_select_month (GTK_CALENDAR (calendar), tm.tm_mon, tm.tm_year + 1900);
+	gtk_calendar_select_day (GTK_CALENDAR (calendar), tm.tm_mday);
+
 #if GTK_MAJOR_VERSION == 2
-	gtk_container_add (GTK_CONTAINER (GTK_DIALOG (dialog)->vbox), gtk_calendar_new ());
+	gtk_container_add (GTK_CONTAINER (GTK_DIALOG (dialog)->vbox), calendar);
 #else
 	contentArea = gtk_dialog_get_content_area (GTK_DIALOG (dialog));
 	vbox = gtk_box_new (GTK_ORIENTATION_VERTICAL, 3);
 	gtk_box_pack_start (GTK_BOX (contentArea), vbox, TRUE, TRUE, 0);
-	gtk_container_add (GTK_CONTAINER (vbox), gtk_calendar_new ());
+	gtk_container_add (GTK_CONTAINER (vbox), calendar);
 #endif
 
 	gtk_window_set_position (GTK_WINDOW (dialog), GTK_WIN_POS_CENTER);
@@ -886,6 +881,7 @@ alarmCallback (guint data)
 		configSetBoolValue (value, clockInst.faceSettings[clockInst.currentFace] -> alarmInfo.onlyWeekdays);
 		alarmSetAngle (clockInst.currentFace);
 		lastTime = -1;
+		dialTickWake ();
 	}
 	gtk_widget_destroy (dialog);
 }
@@ -906,11 +902,14 @@ aboutCallback (guint data)
 {
 	char comment[256];
 	char verString[81];
+	unsigned long textHits, textMisses;
 
+	dialTextCacheStats (&textHits, &textMisses);
 	sprintf (verString, _("Version: %s"), VERSION);
 	sprintf (comment, _("Timezone Clock is a highly configurable analogue clock, capable\n"
 					  "of showing the time in many different countries and cities.\n"
-					  "Loaded time zones: %d"), nTimeZones - FIRST_CITY);
+					  "Loaded time zones: %d\n"
+					  "Labels reused: %lu, shaped: %lu"), nTimeZones - FIRST_CITY, textHits, textMisses);
 
 	/*------------------------------------------------------------------------------------------------*
 	 * Nice dialog that can be used with newer versions of the GTK API.                               *
@@ -986,6 +985,7 @@ windowClickCallback (GtkWidget * widget, GdkEventButton * event)
 	{
 		clockInst.currentFace = ((int)event -> x / clockInst.dialConfig.dialSize) + (((int)event -> y / clockInst.dialConfig.dialSize) * clockInst.dialConfig.dialWidth);
 		lastTime = -1;
+		dialTickWake ();
 
 		switch (event->button)
 		{
@@ -1123,6 +1123,7 @@ windowKeyCallback (GtkWidget * widget, GdkEventKey * event)
 			{
 				clockInst.currentFace = keyPressFaceNum;
 				lastTime = -1;
+				dialTickWake ();
 			}
 		}
 	}
@@ -1311,23 +1312,44 @@ int getHandPositions (int face, FACE_SETTINGS *faceSetting, struct tm *tm, time_
  **********************************************************************************************************************/
 /**
  *  \brief Called on the timer to update the face.
- *  \param data Not used.
- *  \result Always true.
+ *  \result Monotonic time the faces next need updating.
  */
-gboolean
-clockTickCallback (gpointer data)
+static gint64
+clockTickCallback (void)
 {
 	struct tm tm;
 	struct timeval tv;
 	time_t t = time (NULL);
-	int update = 0, i, faceCount = clockInst.dialConfig.dialHeight * clockInst.dialConfig.dialWidth;
+	int update = 0, redrawAll = 0, fast = 0, i, faceCount = clockInst.dialConfig.dialHeight * clockInst.dialConfig.dialWidth;
 
 	if (clockInst.forceTime != -1)
 		t = clockInst.forceTime;
 	if (lastTime == -1)
-		update = 1;
+		redrawAll = 1;
 	lastTime = t;
 
+	/*------------------------------------------------------------------------------------------------*
+     * While the window can not be seen only check the alarms, once a minute, and redraw everything   *
+     * when it is seen again                                                                          *
+     *------------------------------------------------------------------------------------------------*/
+	if (!dialVisible ())
+	{
+		for (i = 0; i < faceCount; ++i)
+		{
+			time_t faceTime = t;
+
+			getTheFaceTime (clockInst.faceSettings[i], &faceTime, &tm);
+			checkForAlarm (clockInst.faceSettings[i], &tm);
+		}
+		wasHidden = 1;
+		return dialTickAlign (60 * G_USEC_PER_SEC);
+	}
+	if (wasHidden)
+	{
+		redrawAll = 1;
+		wasHidden = 0;
+	}
+
 	tv.tv_sec = 0;
 	for (i = 0; i < faceCount; ++i)
 	{
@@ -1344,18 +1366,43 @@ clockTickCallback (gpointer data)
 					gettimeofday(&tv, NULL);
 				bounceSec = tv.tv_usec < 50000 ? 1 : 0;
 			}
-			update += getHandPositions (i, faceSetting, &tm, t);
+			if (getHandPositions (i, faceSetting, &tm, t))
+			{
+				dialFaceDirty (i);
+				++update;
+			}
 			faceSetting -> timeShown = t;
 		}
+		/*--------------------------------------------------------------------------------------------*
+         * Hands that slide to a new time and a running stopwatch need the fast tick                  *
+         *--------------------------------------------------------------------------------------------*/
+		if (faceSetting -> stepping || (faceSetting -> stopwatch && faceSetting -> swStartTime != -1))
+			fast = 1;
+		else if (clockInst.showBounceSec && faceSetting -> showSeconds && bounceSec)
+			fast = 1;
 	}
-	if (update)
+	if (redrawAll)
 	{
-		if (clockInst.dialConfig.drawingArea)
-		{
-			gtk_widget_queue_draw (clockInst.dialConfig.drawingArea);
-		}
+		/*--------------------------------------------------------------------------------------------*
+         * Focus or the current face changed, so redraw everything                                    *
+         *--------------------------------------------------------------------------------------------*/
+		for (i = 0; i < faceCount; ++i)
+			dialFaceDirty (i);
+		dialQueueDirtyFaces ();
 	}
-	return TRUE;
+	else if (update)
+	{
+		/*--------------------------------------------------------------------------------------------*
+         * Only redraw the faces that have changed                                                    *
+         *--------------------------------------------------------------------------------------------*/
+		dialQueueDirtyFaces ();
+	}
+	/*------------------------------------------------------------------------------------------------*
+     * Otherwise nothing changes until the start of the next second                                   *
+     *------------------------------------------------------------------------------------------------*/
+	if (fast)
+		return g_get_monotonic_time () + (50 * 1000);
+	return dialTickAlign (G_USEC_PER_SEC);
 }
 
 /**********************************************************************************************************************
@@ -1375,6 +1422,7 @@ gboolean
 focusInEvent (GtkWidget *widget, GdkEventFocus *event, gpointer data)
 {
 	lastTime = -1;
+	dialTickWake ();
 	clockInst.weHaveFocus = 1;
 	return TRUE;
 }
@@ -1396,6 +1444,7 @@ gboolean
 focusOutEvent (GtkWidget *widget, GdkEventFocus *event, gpointer data)
 {
 	lastTime = -1;
+	dialTickWake ();
 	clockInst.weHaveFocus = 0;
 	return TRUE;
 }
@@ -1425,6 +1474,7 @@ userActive (GtkWidget *widget, GdkEvent* event, gpointer data)
 	{
 		clockInst.toolTipFace = newFace;
 		lastTime = -1;
+		dialTickWake ();
 	}
 	return TRUE;
 }
@@ -1449,6 +1499,7 @@ showSecondsCallback (guint data)
 	sprintf (value, "show_seconds_%d", clockInst.currentFace + 1);
 	configSetBoolValue (value, clockInst.faceSettings[clockInst.currentFace] -> showSeconds);
 	clockInst.faceSettings[clockInst.currentFace] -> updateFace = true;
+	dialTickWake ();
 }
 
 /**********************************************************************************************************************
@@ -1471,6 +1522,7 @@ subSecondCallback (guint data)
 	sprintf (value, "sub_second_%d", clockInst.currentFace + 1);
 	configSetBoolValue (value, clockInst.faceSettings[clockInst.currentFace] -> subSecond);
 	clockInst.faceSettings[clockInst.currentFace] -> updateFace = true;
+	dialTickWake ();
 }
 
 /**********************************************************************************************************************
@@ -1497,6 +1549,7 @@ stopwatchCallback (guint data)
 	clockInst.faceSettings[clockInst.currentFace] -> swRunTime = 0;
 	clockInst.faceSettings[clockInst.currentFace] -> updateFace = true;
 	lastTime = -1;
+	dialTickWake ();
 
 	prepareForPopup ();
 	createMenu (mainMenuDesc, clockInst.accelGroup, FALSE);
@@ -1530,6 +1583,7 @@ swStartCallback (guint data)
 				clockInst.faceSettings[clockInst.currentFace] -> updateFace = true;
 				stopwatchActive ++;
 				lastTime = -1;
+				dialTickWake ();
 			}
 		}
 		else
@@ -1544,6 +1598,7 @@ swStartCallback (guint data)
 				clockInst.faceSettings[clockInst.currentFace] -> updateFace = true;
 				stopwatchActive --;
 				lastTime = -1;
+				dialTickWake ();
 			}
 		}
 	}
@@ -1576,6 +1631,7 @@ swResetCallback (guint data)
 			swStartCallback (data);
 		}
 		lastTime = -1;
+		dialTickWake ();
 	}
 }
 
@@ -1664,7 +1720,7 @@ char *getStringValue (char *addBuffer, int maxSize, int stringNumber, int face,
 	int i = 0, j = 0;
 	struct tm tm;
 
-	localtime_r (&timeNow, &tm);
+	zoneLocalTime (&timeZones[faceSetting -> currentTZ], timeNow, &tm);
 	tempCommand[0] = tempAddStr[0] = addBuffer[0] = 0;
 	strcpy (stringFormat, displayString[stringNumber]);
 
@@ -1860,21 +1916,11 @@ void getTheFaceTime (FACE_SETTINGS *faceSetting, time_t *t, struct tm *tm)
 {
 	int timeZone = faceSetting -> currentTZ;
 
-	if (timeZones[timeZone].value == 0)
-	{
-		unsetenv ("TZ");
-	}
-	else if (timeZones[timeZone].value < FIRST_CITY)
+	if (timeZones[timeZone].value != 0 && timeZones[timeZone].value < FIRST_CITY)
 	{
-		setenv ("TZ", "GMT", 1);
 		*t += 3600 * (timeZones[timeZone].value - GMT_ZERO);
 	}
-	else
-	{
-		setenv ("TZ", timeZones[timeZone].envName, 1);
-	}
-	tzset ();
-	localtime_r (t, tm);
+	zoneLocalTime (&timeZones[timeZone], *t, tm);
 }
 
 #if GTK_MAJOR_VERSION == 2
@@ -2476,6 +2522,7 @@ void updateClock (void)
 	configSetIntValue ("gradient", clockInst.dialConfig.dialGradient);
 	configSetValue ("font_name", clockInst.fontName);
 	lastTime = -1;
+	dialTickWake ();
 }
 
 /**********************************************************************************************************************
@@ -2516,6 +2563,8 @@ void loadConfig (int *posX, int *posY)
 	configGetIntValue ("clock_mark_step", &clockInst.dialConfig.markerStep);
 	configGetIntValue ("opacity", &clockInst.dialConfig.dialOpacity);
 	configGetIntValue ("gradient", &clockInst.dialConfig.dialGradient);
+	configGetBoolValue ("hand_sprites", &clockInst.dialConfig.handSprites);
+	configGetBoolValue ("tile_render", &clockInst.dialConfig.tileRender);
 	configGetIntValue ("clock_x_pos", posX);
 	configGetIntValue ("clock_y_pos", posY);
 	configGetValue ("font_name", clockInst.fontName, 100);
@@ -2687,6 +2736,7 @@ main (int argc, char *argv[])
 
 	g_signal_connect (G_OBJECT (clockInst.dialConfig.mainWindow), "focus-in-event", G_CALLBACK(focusInEvent), NULL);
 	g_signal_connect (G_OBJECT (clockInst.dialConfig.mainWindow), "focus-out-event", G_CALLBACK(focusOutEvent), NULL);
+	dialVisibleInit (clockInst.dialConfig.mainWindow);
 	eventBox = gtk_event_box_new ();
 
 	gtk_container_add (GTK_CONTAINER (eventBox), clockInst.dialConfig.drawingArea);
@@ -2742,7 +2792,7 @@ main (int argc, char *argv[])
 	* OK all ready lets run it!                                                                      *
 	*------------------------------------------------------------------------------------------------*/
 	gtk_widget_show_all (GTK_WIDGET (clockInst.dialConfig.mainWindow));
-	g_timeout_add (50, clockTickCallback, NULL);
+	dialTickStart (clockTickCallback);
 	dialSetOpacity ();
 	{
 		prepareForPopup ();
@@ -2750,6 +2800,8 @@ main (int argc, char *argv[])
 	}
 	i = nice (5);
 	gtk_main ();
+	dialTickStop ();
+	dialTilesFree ();
 	exit (0);
 }
 
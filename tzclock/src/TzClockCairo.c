@@ -50,6 +50,7 @@ char *roman[25] =
  **********************************************************************************************************************/
 /**
  *  \brief .
+ *  \param dialContext Drawing context to use.
  *  \param cr .
  *  \param face .
  *  \param posX .
@@ -58,14 +59,14 @@ char *roman[25] =
  *  \result .
  */
 gboolean
-drawFace (cairo_t *cr, int face, int posX, int posY, char circ)
+drawFace (DIAL_CONTEXT *dialContext, cairo_t *cr, int face, int posX, int posY, char circ)
 {
 	FACE_SETTINGS *faceSetting = clockInst.faceSettings[face];
 	int i, j, col, timeZone = faceSetting -> currentTZ;
 	int centerX = posX + (clockInst.dialConfig.dialSize >> 1), centerY = posY + (clockInst.dialConfig.dialSize >> 1);
 	int showSubSec, markerFlags = 0xFFFFFF;
 	time_t t = faceSetting -> timeShown;
-	char tempString[101];
+	char tempString[101], bottomString[101], cacheKey[301];
 	struct tm tm;
 
 	/*------------------------------------------------------------------------------------------------*
@@ -74,146 +75,158 @@ drawFace (cairo_t *cr, int face, int posX, int posY, char circ)
 	getTheFaceTime (faceSetting, &t, &tm);
 
 	/*------------------------------------------------------------------------------------------------*
-     * Draw the face, it is made up of 3 overlapping circles                                          *
+     * Everything except the hands only changes with these, so it can come from the face cache        *
      *------------------------------------------------------------------------------------------------*/
-	dialDrawStart (cr, posX, posY);
-
 	col = (clockInst.weHaveFocus && face == clockInst.currentFace) ? FACE3_COLOUR : FACE4_COLOUR;
-	if (circ)
+	showSubSec = (faceSetting -> showSeconds && (faceSetting -> stopwatch || faceSetting -> subSecond)) ? 1 : 0;
+
+	getStringValue (tempString, 100, faceSetting -> stopwatch ?
+			(timeZone ? TXT_TOPSW_Z : TXT_TOPSW_L) : (timeZone ? TXT_TOP_Z : TXT_TOP_L), face, t);
+	bottomString[0] = 0;
+	if (!showSubSec)
+		getStringValue (bottomString, 100, timeZone ? TXT_BOTTOM_Z : TXT_BOTTOM_L, face, t);
+
+	snprintf (cacheKey, 300, "%d|%d|%d|%d|%d|%s|%s", col, circ, showSubSec, faceSetting -> stopwatch,
+			faceSetting -> show24Hour, tempString, bottomString);
+
+	dialCtxDrawStart (dialContext, cr, posX, posY);
+	if (dialCtxFaceCacheStart (dialContext, face, cacheKey))
 	{
-		dialCircleGradient (64, col, 1);
+		/*--------------------------------------------------------------------------------------------*
+         * Draw the face, it is made up of 3 overlapping circles                                      *
+         *--------------------------------------------------------------------------------------------*/
+		if (circ)
+		{
+			dialCtxCircleGradient (dialContext, 64, col, 1);
 /*      dialDrawCircle (64, col, -1); */
-	}
-	else
-	{
-		dialSquareGradient (64, col, 1);
+		}
+		else
+		{
+			dialCtxSquareGradient (dialContext, 64, col, 1);
 /*      dialDrawSquare (64, col, -1); */
-	}
+		}
 
-	dialCircleGradient (62, FACE2_COLOUR, 0);
-	dialCircleGradient (58, FACE1_COLOUR, 1);
+		dialCtxCircleGradient (dialContext, 62, FACE2_COLOUR, 0);
+		dialCtxCircleGradient (dialContext, 58, FACE1_COLOUR, 1);
 
 /*  dialDrawCircle (62, FACE3_COLOUR, -1); */
 /*  dialDrawCircle (60, FACE4_COLOUR, -1); */
 
-	/*------------------------------------------------------------------------------------------------*
-     * Add the text, ether the date or the timezone, plus an AM/PM indicator                          *
-     *------------------------------------------------------------------------------------------------*/
-	showSubSec = (faceSetting -> showSeconds && (faceSetting -> stopwatch || faceSetting -> subSecond)) ? 1 : 0;
-
-	getStringValue (tempString, 100, faceSetting -> stopwatch ?
-			(timeZone ? TXT_TOPSW_Z : TXT_TOPSW_L) : (timeZone ? TXT_TOP_Z : TXT_TOP_L), face, t);
-	dialDrawText (0, tempString, TEXT__COLOUR);
+		/*--------------------------------------------------------------------------------------------*
+         * Add the text, ether the date or the timezone, plus an AM/PM indicator                      *
+         *--------------------------------------------------------------------------------------------*/
+		dialCtxDrawText (dialContext, 0, tempString, TEXT__COLOUR);
 
-	if (!showSubSec)
-	{
-		getStringValue (tempString, 100, timeZone ? TXT_BOTTOM_Z : TXT_BOTTOM_L, face, t);
-		dialDrawText (1, tempString, TEXT__COLOUR);
-	}
+		if (!showSubSec)
+		{
+			dialCtxDrawText (dialContext, 1, bottomString, TEXT__COLOUR);
+		}
 
-	/*------------------------------------------------------------------------------------------------*
-     * Calculate which markers to draw                                                                *
-     *------------------------------------------------------------------------------------------------*/
-	if (clockInst.dialConfig.markerType > 2)
-	{
-		if (showSubSec)
+		/*--------------------------------------------------------------------------------------------*
+         * Calculate which markers to draw                                                            *
+         *--------------------------------------------------------------------------------------------*/
+		if (clockInst.dialConfig.markerType > 2)
 		{
-			if (faceSetting -> show24Hour)
+			if (showSubSec)
 			{
-				markerFlags &= ~(1 << 11);
-				markerFlags &= ~(1 << 12);
-				markerFlags &= ~(1 << 13);
+				if (faceSetting -> show24Hour)
+				{
+					markerFlags &= ~(1 << 11);
+					markerFlags &= ~(1 << 12);
+					markerFlags &= ~(1 << 13);
+				}
+				else
+					markerFlags &= ~(1 << 6);
+			}
+			if (faceSetting -> stopwatch)
+			{
+				if (faceSetting -> show24Hour)
+				{
+					markerFlags &= ~(1 << 5);
+					markerFlags &= ~(1 << 6);
+					markerFlags &= ~(1 << 7);
+					markerFlags &= ~(1 << 17);
+					markerFlags &= ~(1 << 18);
+					markerFlags &= ~(1 << 19);
+				}
+				else
+				{
+					markerFlags &= ~(1 << 3);
+					markerFlags &= ~(1 << 9);
+				}
 			}
-			else
-				markerFlags &= ~(1 << 6);
 		}
-		if (faceSetting -> stopwatch)
+
+		/*--------------------------------------------------------------------------------------------*
+         * Draw the hour markers                                                                      *
+         *--------------------------------------------------------------------------------------------*/
+		j = faceSetting -> show24Hour ? 120 : 60;
+
+		for (i = 0; i < j ; i++)
 		{
-			if (faceSetting -> show24Hour)
+			int m = faceSetting -> show24Hour ? i * 10 : i * 20;
+
+			if (clockInst.dialConfig.dialSize > 256)
 			{
-				markerFlags &= ~(1 << 5);
-				markerFlags &= ~(1 << 6);
-				markerFlags &= ~(1 << 7);
-				markerFlags &= ~(1 << 17);
-				markerFlags &= ~(1 << 18);
-				markerFlags &= ~(1 << 19);
+				if (!faceSetting -> show24Hour || !(i % 2))
+					dialCtxDrawMinute (dialContext, 30, 1, m, MMARK_COLOUR);
 			}
-			else
+			if (!(i % 5))
 			{
-				markerFlags &= ~(1 << 3);
-				markerFlags &= ~(1 << 9);
+				dialCtxDrawMinute (dialContext, 29, 1, m, HMARK_COLOUR);
+				if (markerFlags & (1 << (i / 5)))
+				{
+					char buff[11] = "";
+					int hour = i == 0 ? (faceSetting -> show24Hour ? 24 : 12) : i / 5;
+					if (clockInst.dialConfig.markerType == 3)
+						sprintf (buff, "%d", hour);
+					if (clockInst.dialConfig.markerType == 4)
+						strcpy (buff, roman[hour]);
+					dialCtxDrawMark (dialContext, m, 31, QFILL_COLOUR, QMARK_COLOUR, buff);
+				}
 			}
 		}
-	}
-
-	/*------------------------------------------------------------------------------------------------*
-     * Draw the hour markers                                                                          *
-     *------------------------------------------------------------------------------------------------*/
-	j = faceSetting -> show24Hour ? 120 : 60;
-
-	for (i = 0; i < j ; i++)
-	{
-		int m = faceSetting -> show24Hour ? i * 10 : i * 20;
 
-		if (clockInst.dialConfig.dialSize > 256)
+		/*--------------------------------------------------------------------------------------------*
+         * Draw other clock faces                                                                     *
+         *--------------------------------------------------------------------------------------------*/
+		if (showSubSec)
 		{
-			if (!faceSetting -> show24Hour || !(i % 2))
-				dialDrawMinute (30, 1, m, MMARK_COLOUR);
+			dialCtxCircleGradientX (dialContext, centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), 21, FACE2_COLOUR, 1);
+			dialCtxDrawCircleX (dialContext, centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), 19, FACE5_COLOUR, -1);
 		}
-		if (!(i % 5))
+		if (faceSetting -> stopwatch)
 		{
-			dialDrawMinute (29, 1, m, HMARK_COLOUR);
-			if (markerFlags & (1 << (i / 5)))
-			{
-				char buff[11] = "";
-				int hour = i == 0 ? (faceSetting -> show24Hour ? 24 : 12) : i / 5;
-				if (clockInst.dialConfig.markerType == 3)
-					sprintf (buff, "%d", hour);
-				if (clockInst.dialConfig.markerType == 4)
-					strcpy (buff, roman[hour]);
-				dialDrawMark (m, 31, QFILL_COLOUR, QMARK_COLOUR, buff);
-			}
+			dialCtxCircleGradientX (dialContext, posX + (clockInst.dialConfig.dialSize >> 2), centerY, 21, FACE2_COLOUR, 1);
+			dialCtxDrawCircleX (dialContext, posX + (clockInst.dialConfig.dialSize >> 2), centerY, 19, FACE5_COLOUR, -1);
+			dialCtxCircleGradientX (dialContext, posX + (3 * clockInst.dialConfig.dialSize >> 2), centerY, 21, FACE2_COLOUR, 1);
+			dialCtxDrawCircleX (dialContext, posX + (3 * clockInst.dialConfig.dialSize >> 2), centerY, 19, FACE5_COLOUR, -1);
 		}
-	}
 
-	/*------------------------------------------------------------------------------------------------*
-     * Draw other clock faces                                                                         *
-     *------------------------------------------------------------------------------------------------*/
-	if (showSubSec)
-	{
-		dialCircleGradientX (centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), 21, FACE2_COLOUR, 1);
-		dialDrawCircleX (centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), 19, FACE5_COLOUR, -1);
-	}
-	if (faceSetting -> stopwatch)
-	{
-		dialCircleGradientX (posX + (clockInst.dialConfig.dialSize >> 2), centerY, 21, FACE2_COLOUR, 1);
-		dialDrawCircleX (posX + (clockInst.dialConfig.dialSize >> 2), centerY, 19, FACE5_COLOUR, -1);
-		dialCircleGradientX (posX + (3 * clockInst.dialConfig.dialSize >> 2), centerY, 21, FACE2_COLOUR, 1);
-		dialDrawCircleX (posX + (3 * clockInst.dialConfig.dialSize >> 2), centerY, 19, FACE5_COLOUR, -1);
-	}
-
-	if (showSubSec || faceSetting -> stopwatch)
-	{
-		for (i = 0; i < 60 ; i++)
+		if (showSubSec || faceSetting -> stopwatch)
 		{
-			int m = i * 20;
-
-			if (showSubSec)
+			for (i = 0; i < 60 ; i++)
 			{
-				if (!(i % 5))
-					dialDrawMinuteX (centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2),
-							(i % 15) ? 9 : 8, (i % 15) ? 1 : 2, m, WMARK_COLOUR);
-			}
-			if (faceSetting -> stopwatch)
-			{
-				if (!(i % 6))
-					dialDrawMinuteX (posX + (clockInst.dialConfig.dialSize >> 2), centerY,
-							(i % 12) ? 9 : 8, (i % 12) ? 1 : 2, m, WMARK_COLOUR);
-				if (!(i % 4))
-					dialDrawMinuteX (posX + ((3 * clockInst.dialConfig.dialSize) >> 2), centerY,
-							(i % 20) ? 9 : 8, (i % 20) ? 1 : 2, m, WMARK_COLOUR);
+				int m = i * 20;
+
+				if (showSubSec)
+				{
+					if (!(i % 5))
+						dialCtxDrawMinuteX (dialContext, centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2),
+								(i % 15) ? 9 : 8, (i % 15) ? 1 : 2, m, WMARK_COLOUR);
+				}
+				if (faceSetting -> stopwatch)
+				{
+					if (!(i % 6))
+						dialCtxDrawMinuteX (dialContext, posX + (clockInst.dialConfig.dialSize >> 2), centerY,
+								(i % 12) ? 9 : 8, (i % 12) ? 1 : 2, m, WMARK_COLOUR);
+					if (!(i % 4))
+						dialCtxDrawMinuteX (dialContext, posX + ((3 * clockInst.dialConfig.dialSize) >> 2), centerY,
+								(i % 20) ? 9 : 8, (i % 20) ? 1 : 2, m, WMARK_COLOUR);
+				}
 			}
 		}
+		dialCtxFaceCacheFinish (dialContext);
 	}
 
 	/*------------------------------------------------------------------------------------------------*
@@ -221,49 +234,69 @@ drawFace (cairo_t *cr, int face, int posX, int posY, char circ)
      *------------------------------------------------------------------------------------------------*/
 	if (faceSetting -> alarmInfo.showAlarm)
 	{
-		dialDrawHand (faceSetting -> handPosition[HAND_ALARM], &handStyle[HAND_ALARM]);
+		dialCtxDrawHand (dialContext, faceSetting -> handPosition[HAND_ALARM], &handStyle[HAND_ALARM]);
 	}
 	if (showSubSec)
 	{
-		dialDrawHandX (centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), faceSetting -> handPosition[HAND_SECS], &handStyle[HAND_SUBS]);
-		dialDrawCircleX (centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), 2, SFILL_COLOUR, SEC___COLOUR);
+		dialCtxDrawHandX (dialContext, centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), faceSetting -> handPosition[HAND_SECS], &handStyle[HAND_SUBS]);
+		dialCtxDrawCircleX (dialContext, centerX, posY + ((3 * clockInst.dialConfig.dialSize) >> 2), 2, SFILL_COLOUR, SEC___COLOUR);
 	}
 	if (faceSetting -> stopwatch)
 	{
-		dialDrawHandX (posX + (clockInst.dialConfig.dialSize >> 2), centerY, faceSetting -> handPosition[HAND_STOPWT], &handStyle[HAND_STOPWT]);
-		dialDrawHandX (posX + ((3 * clockInst.dialConfig.dialSize) >> 2), centerY, faceSetting -> handPosition[HAND_STOPWM], &handStyle[HAND_STOPWM]);
-		dialDrawCircleX (posX + (clockInst.dialConfig.dialSize >> 2), centerY, 2, WFILL_COLOUR, WATCH_COLOUR);
-		dialDrawCircleX (posX + ((3 * clockInst.dialConfig.dialSize) >> 2), centerY, 2, WFILL_COLOUR, WATCH_COLOUR);
+		dialCtxDrawHandX (dialContext, posX + (clockInst.dialConfig.dialSize >> 2), centerY, faceSetting -> handPosition[HAND_STOPWT], &handStyle[HAND_STOPWT]);
+		dialCtxDrawHandX (dialContext, posX + ((3 * clockInst.dialConfig.dialSize) >> 2), centerY, faceSetting -> handPosition[HAND_STOPWM], &handStyle[HAND_STOPWM]);
+		dialCtxDrawCircleX (dialContext, posX + (clockInst.dialConfig.dialSize >> 2), centerY, 2, WFILL_COLOUR, WATCH_COLOUR);
+		dialCtxDrawCircleX (dialContext, posX + ((3 * clockInst.dialConfig.dialSize) >> 2), centerY, 2, WFILL_COLOUR, WATCH_COLOUR);
 	}
 
-	dialDrawHand (faceSetting -> handPosition[HAND_HOUR], &handStyle[HAND_HOUR]);
-	dialDrawHand (faceSetting -> handPosition[HAND_MINUTE], &handStyle[HAND_MINUTE]);
+	dialCtxDrawHand (dialContext, faceSetting -> handPosition[HAND_HOUR], &handStyle[HAND_HOUR]);
+	dialCtxDrawHand (dialContext, faceSetting -> handPosition[HAND_MINUTE], &handStyle[HAND_MINUTE]);
 
 	if (faceSetting -> showSeconds || faceSetting -> stopwatch)
 	{
 		if (faceSetting -> stopwatch)
 		{
-			dialDrawHandX (centerX, centerY, faceSetting -> handPosition[HAND_STOPWS], &handStyle[HAND_SECS]);
-			dialDrawCircleX (centerX, centerY, 4, WFILL_COLOUR, WATCH_COLOUR);
+			dialCtxDrawHandX (dialContext, centerX, centerY, faceSetting -> handPosition[HAND_STOPWS], &handStyle[HAND_SECS]);
+			dialCtxDrawCircleX (dialContext, centerX, centerY, 4, WFILL_COLOUR, WATCH_COLOUR);
 		}
 		else if (faceSetting -> subSecond)
 		{
-			dialDrawCircleX (centerX, centerY, 4, MFILL_COLOUR, MIN___COLOUR);
+			dialCtxDrawCircleX (dialContext, centerX, centerY, 4, MFILL_COLOUR, MIN___COLOUR);
 		}
 		else
 		{
-			dialDrawHand (faceSetting -> handPosition[HAND_SECS], &handStyle[HAND_SECS]);
-			dialDrawCircle (4, SFILL_COLOUR, SEC___COLOUR);
+			dialCtxDrawHand (dialContext, faceSetting -> handPosition[HAND_SECS], &handStyle[HAND_SECS]);
+			dialCtxDrawCircle (dialContext, 4, SFILL_COLOUR, SEC___COLOUR);
 		}
 	}
 	else
 	{
-		dialDrawCircle (4, MFILL_COLOUR, MIN___COLOUR);
+		dialCtxDrawCircle (dialContext, 4, MFILL_COLOUR, MIN___COLOUR);
 	}
-	dialDrawFinish ();
+	dialCtxDrawFinish (dialContext);
 	return TRUE;
 }
 
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D R A W  G R I D  F A C E                                                                                         *
+ *  =========================                                                                                         *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Draw one face of the window grid, called by dialDrawFaces maybe on a worker thread.
+ *  \param dialContext Drawing context to use.
+ *  \param cr Cairo handle.
+ *  \param face Which face to draw.
+ *  \param posX Corner position X.
+ *  \param posY Corner position Y.
+ *  \result None.
+ */
+static void drawGridFace (DIAL_CONTEXT *dialContext, cairo_t *cr, int face, int posX, int posY)
+{
+	drawFace (dialContext, cr, face, posX, posY, 0);
+}
+
 #if GTK_MAJOR_VERSION == 2
 
 /**********************************************************************************************************************
@@ -279,16 +312,9 @@ drawFace (cairo_t *cr, int face, int posX, int posY, char circ)
  */
 void clockExpose (GtkWidget *widget)
 {
-	int i, j, face = 0;
 	cairo_t *cr = gdk_cairo_create (clockInst.dialConfig.drawingArea -> window);
 
-	for (j = 0; j < clockInst.dialConfig.dialHeight; j++)
-	{
-		for (i = 0; i < clockInst.dialConfig.dialWidth; i++)
-		{
-			drawFace (cr, face++, (i * clockInst.dialConfig.dialSize), (j * clockInst.dialConfig.dialSize), 0);
-		}
-	}
+	dialDrawFaces (cr, drawGridFace);
 
 	/*------------------------------------------------------------------------------------------------*
      * Reset the color and stuff back to the default.                                                 *
@@ -312,15 +338,7 @@ void clockExpose (GtkWidget *widget)
 
 void clockExpose (cairo_t *cr)
 {
-	int i, j, face = 0;
-
-	for (j = 0; j < clockInst.dialConfig.dialHeight; j++)
-	{
-		for (i = 0; i < clockInst.dialConfig.dialWidth; i++)
-		{
-			drawFace (cr, face++, (i * clockInst.dialConfig.dialSize), (j * clockInst.dialConfig.dialSize), 0);
-		}
-	}
+	dialDrawFaces (cr, drawGridFace);
 }
 
 #endif
@@ -349,7 +367,7 @@ void dialSave(char *fileName)
 	{
 		for (i = 0; i < clockInst.dialConfig.dialWidth; i++)
 		{
-			drawFace (cr, face++, (i * clockInst.dialConfig.dialSize), (j * clockInst.dialConfig.dialSize), 1);
+			drawFace (dialDefaultContext (), cr, face++, (i * clockInst.dialConfig.dialSize), (j * clockInst.dialConfig.dialSize), 1);
 		}
 	}
 
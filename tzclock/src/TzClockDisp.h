@@ -214,6 +214,7 @@ typedef struct _tzInfo
 {
 	char *envName;
 	int value;
+	struct _zoneData *zoneData;
 } 
 TZ_INFO;
 
@@ -231,4 +232,5 @@ void dialSave(char *fileName);
 char *getStringValue (char *addBuffer, int maxSize, int stringNumber, int face, time_t timeNow);
 int  xSinCos (int number, int angle, int useCos);
 int  getStopwatchTime (FACE_SETTINGS *faceSetting);
+void zoneLocalTime (TZ_INFO *zone, time_t t, struct tm *tm);
 
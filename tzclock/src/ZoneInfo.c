@@ -0,0 +1,708 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  Z O N E  I N F O . C                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Convert times using cached zoneinfo tables instead of setting TZ.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <ctype.h>
+#include <stdint.h>
+#include <limits.h>
+#include <unistd.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+
+#include "TzClockDisp.h"
+#include "ParseZone.h"
+
+#define ZONE_INFO_DIR		"/usr/share/zoneinfo/"
+#define ZONE_LOCAL_FILE		"/etc/localtime"
+#define ZONE_ABBR_SIZE		16
+
+typedef struct _zoneType
+{
+	int utOffset;
+	int isDst;
+	const char *abbr;
+}
+ZONE_TYPE;
+
+typedef struct _zoneRule
+{
+	char form;					/* 'J' Julian no leap day, 'D' day of year, 'M' month week day */
+	int month;
+	int week;
+	int day;
+	int secs;
+}
+ZONE_RULE;
+
+typedef struct _zoneData
+{
+	int transCount;
+	int64_t *transTimes;
+	unsigned char *transTypes;
+	int typeCount;
+	ZONE_TYPE *types;
+	char *abbrs;
+
+	int hasRule;
+	ZONE_TYPE ruleStd;
+	ZONE_TYPE ruleDst;
+	ZONE_RULE ruleStart;
+	ZONE_RULE ruleEnd;
+	char ruleAbbrs[2][ZONE_ABBR_SIZE];
+}
+ZONE_DATA;
+
+static ZONE_DATA zoneGMT = { .hasRule = 1, .ruleStd = { 0, 0, "GMT" }, .ruleDst = { 0, 0, "GMT" } };
+static ZONE_DATA zoneUTC = { .hasRule = 1, .ruleStd = { 0, 0, "UTC" }, .ruleDst = { 0, 0, "UTC" } };
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  D A Y S  F R O M  C I V I L                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Number of days from 1970-01-01 to a date.
+ *  \param year Full year.
+ *  \param month Month 1 to 12.
+ *  \param day Day of the month from 1.
+ *  \result Days since the epoch, negative before it.
+ */
+static int64_t daysFromCivil (int64_t year, int month, int day)
+{
+	int64_t era, yoe, doy, doe;
+
+	year -= month <= 2;
+	era = (year >= 0 ? year : year - 399) / 400;
+	yoe = year - era * 400;
+	doy = (153 * (month + (month > 2 ? -3 : 9)) + 2) / 5 + day - 1;
+	doe = yoe * 365 + yoe / 4 - yoe / 100 + doy;
+	return era * 146097 + doe - 719468;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  I S  L E A P  Y E A R                                                                                             *
+ *  =====================                                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Is this a leap year.
+ *  \param year Full year.
+ *  \result 1 if it is.
+ */
+static int isLeapYear (int64_t year)
+{
+	return (year % 4 == 0 && (year % 100 != 0 || year % 400 == 0));
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  F I L L  B R O K E N  T I M E                                                                                     *
+ *  =============================                                                                                     *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Split a local time in to its parts, with no help from libc.
+ *  \param local Seconds since the epoch, already moved to local time.
+ *  \param type Local time type, for the offset and name.
+ *  \param tm Save the result here.
+ *  \result None.
+ */
+static void fillBrokenTime (int64_t local, const ZONE_TYPE *type, struct tm *tm)
+{
+	int64_t days = local / 86400, secs = local % 86400, era, doe, yoe, doy, mp, year;
+
+	if (secs < 0)
+	{
+		secs += 86400;
+		--days;
+	}
+	tm -> tm_hour = secs / 3600;
+	tm -> tm_min = (secs / 60) % 60;
+	tm -> tm_sec = secs % 60;
+	tm -> tm_wday = (days + 4) % 7;
+	if (tm -> tm_wday < 0)
+		tm -> tm_wday += 7;
+
+	days += 719468;
+	era = (days >= 0 ? days : days - 146096) / 146097;
+	doe = days - era * 146097;
+	yoe = (doe - doe / 1460 + doe / 36524 - doe / 146096) / 365;
+	doy = doe - (365 * yoe + yoe / 4 - yoe / 100);
+	mp = (5 * doy + 2) / 153;
+	year = yoe + era * 400;
+
+	tm -> tm_mday = doy - (153 * mp + 2) / 5 + 1;
+	tm -> tm_mon = mp < 10 ? mp + 2 : mp - 10;
+	if (tm -> tm_mon <= 1)
+		++year;
+	tm -> tm_year = year - 1900;
+	tm -> tm_yday = daysFromCivil (year, tm -> tm_mon + 1, tm -> tm_mday) - daysFromCivil (year, 1, 1);
+	tm -> tm_isdst = type -> isDst;
+	tm -> tm_gmtoff = type -> utOffset;
+	tm -> tm_zone = type -> abbr;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R E A D  B I G  E N D I A N                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read a signed big endian number from the file.
+ *  \param buffer Where to read from.
+ *  \param bytes Size of the number, 4 or 8.
+ *  \result The number.
+ */
+static int64_t readBigEndian (const unsigned char *buffer, int bytes)
+{
+	uint64_t value = 0;
+	int i;
+
+	for (i = 0; i < bytes; ++i)
+		value = (value << 8) | buffer[i];
+
+	if (bytes == 4)
+		return (int32_t)value;
+	return (int64_t)value;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  P A R S E  R U L E  N A M E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the name part of a POSIX TZ string.
+ *  \param rule Current position in the string.
+ *  \param name Save the name here.
+ *  \result Position after the name, NULL on error.
+ */
+static const char *parseRuleName (const char *rule, char *name)
+{
+	int i = 0;
+
+	if (*rule == '<')
+	{
+		++rule;
+		while (*rule && *rule != '>')
+		{
+			if (i < ZONE_ABBR_SIZE - 1)
+				name[i++] = *rule;
+			++rule;
+		}
+		if (*rule++ != '>')
+			return NULL;
+	}
+	else
+	{
+		while (isalpha ((unsigned char)*rule))
+		{
+			if (i < ZONE_ABBR_SIZE - 1)
+				name[i++] = *rule;
+			++rule;
+		}
+	}
+	name[i] = 0;
+	return i ? rule : NULL;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  P A R S E  R U L E  T I M E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read a [+-]hh[:mm[:ss]] time from a POSIX TZ string.
+ *  \param rule Current position in the string.
+ *  \param secs Save the time in seconds here.
+ *  \result Position after the time, NULL on error.
+ */
+static const char *parseRuleTime (const char *rule, int *secs)
+{
+	int sign = 1, part = 0, value;
+
+	if (*rule == '+' || *rule == '-')
+	{
+		if (*rule++ == '-')
+			sign = -1;
+	}
+	if (!isdigit ((unsigned char)*rule))
+		return NULL;
+
+	*secs = 0;
+	while (part < 3 && isdigit ((unsigned char)*rule))
+	{
+		value = 0;
+		while (isdigit ((unsigned char)*rule))
+			value = (value * 10) + (*rule++ - '0');
+		*secs += value * (part == 0 ? 3600 : part == 1 ? 60 : 1);
+		if (*rule != ':')
+			break;
+		++rule;
+		++part;
+	}
+	*secs *= sign;
+	return rule;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  P A R S E  R U L E  D A T E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read a Jn, n or Mm.w.d date and optional time from a POSIX TZ string.
+ *  \param rule Current position in the string.
+ *  \param date Save the date here.
+ *  \result Position after the date, NULL on error.
+ */
+static const char *parseRuleDate (const char *rule, ZONE_RULE *date)
+{
+	memset (date, 0, sizeof (ZONE_RULE));
+	date -> secs = 7200;
+
+	if (*rule == 'J' || isdigit ((unsigned char)*rule))
+	{
+		date -> form = (*rule == 'J') ? 'J' : 'D';
+		if (*rule == 'J')
+			++rule;
+		if (!isdigit ((unsigned char)*rule))
+			return NULL;
+		while (isdigit ((unsigned char)*rule))
+			date -> day = (date -> day * 10) + (*rule++ - '0');
+	}
+	else if (*rule == 'M')
+	{
+		date -> form = 'M';
+		if (sscanf (rule, "M%d.%d.%d", &date -> month, &date -> week, &date -> day) != 3)
+			return NULL;
+		while (*rule && *rule != '/' && *rule != ',')
+			++rule;
+	}
+	else
+	{
+		return NULL;
+	}
+	if (*rule == '/')
+	{
+		rule = parseRuleTime (rule + 1, &date -> secs);
+	}
+	return rule;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  P A R S E  F O O T E R  R U L E                                                                                   *
+ *  ===============================                                                                                   *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Read the POSIX TZ string used for times after the last transition.
+ *  \param zoneData Zone to fill in.
+ *  \param rule The TZ string.
+ *  \result 1 if it could be used.
+ */
+static int parseFooterRule (ZONE_DATA *zoneData, const char *rule)
+{
+	int stdOffset, dstOffset;
+
+	if ((rule = parseRuleName (rule, zoneData -> ruleAbbrs[0])) == NULL)
+		return 0;
+	if ((rule = parseRuleTime (rule, &stdOffset)) == NULL)
+		return 0;
+
+	zoneData -> ruleStd.utOffset = zoneData -> ruleDst.utOffset = -stdOffset;
+	zoneData -> ruleStd.abbr = zoneData -> ruleDst.abbr = zoneData -> ruleAbbrs[0];
+	zoneData -> ruleDst.isDst = 0;
+
+	if (*rule)
+	{
+		if ((rule = parseRuleName (rule, zoneData -> ruleAbbrs[1])) == NULL)
+			return 0;
+
+		dstOffset = stdOffset - 3600;
+		if (*rule && *rule != ',')
+		{
+			if ((rule = parseRuleTime (rule, &dstOffset)) == NULL)
+				return 0;
+		}
+		if (*rule++ != ',')
+			return 0;
+		if ((rule = parseRuleDate (rule, &zoneData -> ruleStart)) == NULL || *rule++ != ',')
+			return 0;
+		if ((rule = parseRuleDate (rule, &zoneData -> ruleEnd)) == NULL)
+			return 0;
+
+		zoneData -> ruleDst.utOffset = -dstOffset;
+		zoneData -> ruleDst.isDst = 1;
+		zoneData -> ruleDst.abbr = zoneData -> ruleAbbrs[1];
+	}
+	zoneData -> hasRule = 1;
+	return 1;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R U L E  T O  T I M E                                                                                             *
+ *  =====================                                                                                             *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Work out when a rule changes the clocks in a year.
+ *  \param date The rule.
+ *  \param year Full year.
+ *  \result Seconds since the epoch, in the local time the rule is given in.
+ */
+static int64_t ruleToTime (const ZONE_RULE *date, int64_t year)
+{
+	int64_t days = daysFromCivil (year, 1, 1);
+
+	if (date -> form == 'J')
+	{
+		days += date -> day - 1;
+		if (isLeapYear (year) && date -> day >= 60)
+			++days;
+	}
+	else if (date -> form == 'D')
+	{
+		days += date -> day;
+	}
+	else
+	{
+		static const int monthDays[12] = { 31, 28, 31, 30, 31, 30, 31, 31, 30, 31, 30, 31 };
+		int wday, mdays = monthDays[date -> month - 1] + (date -> month == 2 && isLeapYear (year));
+
+		days = daysFromCivil (year, date -> month, 1);
+		wday = (days + 4) % 7;
+		if (wday < 0)
+			wday += 7;
+		days += (date -> day - wday + 7) % 7 + (date -> week - 1) * 7;
+		while (date -> week == 5 && days >= daysFromCivil (year, date -> month, 1) + mdays)
+			days -= 7;
+	}
+	return days * 86400 + date -> secs;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  R U L E  T Y P E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find the local time type from the POSIX rule.
+ *  \param zoneData Zone to look in.
+ *  \param t Time in UTC.
+ *  \result Local time type.
+ */
+static const ZONE_TYPE *ruleType (const ZONE_DATA *zoneData, int64_t t)
+{
+	int64_t year, start, end;
+	struct tm tm;
+
+	if (!zoneData -> ruleDst.isDst)
+		return &zoneData -> ruleStd;
+
+	fillBrokenTime (t + zoneData -> ruleStd.utOffset, &zoneData -> ruleStd, &tm);
+	year = (int64_t)tm.tm_year + 1900;
+
+	/*------------------------------------------------------------------------------------------------*
+     * The start is given in standard time and the end in daylight time.                              *
+     *------------------------------------------------------------------------------------------------*/
+	start = ruleToTime (&zoneData -> ruleStart, year) - zoneData -> ruleStd.utOffset;
+	end = ruleToTime (&zoneData -> ruleEnd, year) - zoneData -> ruleDst.utOffset;
+
+	if (start < end)
+		return (t >= start && t < end) ? &zoneData -> ruleDst : &zoneData -> ruleStd;
+	return (t >= end && t < start) ? &zoneData -> ruleStd : &zoneData -> ruleDst;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  Z O N E  F R E E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Free the tables made by zoneParse.
+ *  \param zoneData Tables to free, the fixed GMT and UTC tables are left alone.
+ *  \result None.
+ */
+static void zoneFree (ZONE_DATA *zoneData)
+{
+	if (zoneData == NULL || zoneData == &zoneGMT || zoneData == &zoneUTC)
+		return;
+
+	free (zoneData -> transTimes);
+	free (zoneData -> transTypes);
+	free (zoneData -> types);
+	free (zoneData -> abbrs);
+	free (zoneData);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  Z O N E  P A R S E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Build the transition tables from a TZif file.
+ *  \param buffer Mapped file.
+ *  \param size Size of the file.
+ *  \result Zone tables, NULL if the file could not be read.
+ */
+static ZONE_DATA *zoneParse (const unsigned char *buffer, size_t size)
+{
+	const unsigned char *data = buffer, *end = buffer + size;
+	int64_t counts[6];
+	size_t blockSize;
+	int timeSize = 4, i;
+	ZONE_DATA *zoneData;
+
+	if (size < 44 || memcmp (buffer, "TZif", 4) != 0)
+		return NULL;
+
+	/*------------------------------------------------------------------------------------------------*
+     * Version 2 files have a second copy with 64 bit times, skip the first one.                      *
+     *------------------------------------------------------------------------------------------------*/
+	for (i = 0; i < 6; ++i)
+		counts[i] = readBigEndian (&data[20 + (i * 4)], 4);
+	if (buffer[4] >= '2')
+	{
+		blockSize = counts[3] * 5 + counts[4] * 6 + counts[5] + counts[2] * 8 + counts[1] + counts[0];
+		data += 44 + blockSize;
+		if (data + 44 > end || memcmp (data, "TZif", 4) != 0)
+			return NULL;
+		for (i = 0; i < 6; ++i)
+			counts[i] = readBigEndian (&data[20 + (i * 4)], 4);
+		timeSize = 8;
+	}
+	data += 44;
+
+	blockSize = counts[3] * (timeSize + 1) + counts[4] * 6 + counts[5] + counts[2] * (timeSize + 4) +
+			counts[1] + counts[0];
+	if (counts[4] < 1 || data + blockSize > end)
+		return NULL;
+
+	if ((zoneData = (ZONE_DATA *)calloc (1, sizeof (ZONE_DATA))) == NULL)
+		return NULL;
+
+	zoneData -> transCount = counts[3];
+	zoneData -> typeCount = counts[4];
+	zoneData -> transTimes = (int64_t *)malloc (sizeof (int64_t) * (counts[3] + 1));
+	zoneData -> transTypes = (unsigned char *)malloc (counts[3] + 1);
+	zoneData -> types = (ZONE_TYPE *)malloc (sizeof (ZONE_TYPE) * counts[4]);
+	zoneData -> abbrs = (char *)malloc (counts[5] + 1);
+	if (!zoneData -> transTimes || !zoneData -> transTypes || !zoneData -> types || !zoneData -> abbrs)
+	{
+		zoneFree (zoneData);
+		return NULL;
+	}
+
+	for (i = 0; i < zoneData -> transCount; ++i)
+	{
+		zoneData -> transTimes[i] = readBigEndian (data, timeSize);
+		data += timeSize;
+	}
+	for (i = 0; i < zoneData -> transCount; ++i)
+	{
+		zoneData -> transTypes[i] = *data < counts[4] ? *data : 0;
+		++data;
+	}
+	memcpy (zoneData -> abbrs, data + (counts[4] * 6), counts[5]);
+	zoneData -> abbrs[counts[5]] = 0;
+	for (i = 0; i < zoneData -> typeCount; ++i)
+	{
+		zoneData -> types[i].utOffset = readBigEndian (data, 4);
+		zoneData -> types[i].isDst = data[4];
+		zoneData -> types[i].abbr = &zoneData -> abbrs[data[5] < counts[5] ? data[5] : counts[5]];
+		data += 6;
+	}
+	data += counts[5] + counts[2] * (timeSize + 4) + counts[1] + counts[0];
+
+	/*------------------------------------------------------------------------------------------------*
+     * The footer has the rule for times after the last transition.                                   *
+     *------------------------------------------------------------------------------------------------*/
+	if (timeSize == 8 && data < end && *data == '\n')
+	{
+		char footer[128];
+		int len = 0;
+
+		++data;
+		while (data < end && *data != '\n' && len < 127)
+			footer[len++] = *data++;
+		footer[len] = 0;
+		if (len)
+			parseFooterRule (zoneData, footer);
+	}
+	return zoneData;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  Z O N E  L O A D                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Map a zoneinfo file and build the tables for it.
+ *  \param fileName File to load.
+ *  \result Zone tables, NULL if the file could not be read.
+ */
+static ZONE_DATA *zoneLoad (const char *fileName)
+{
+	ZONE_DATA *zoneData = NULL;
+	struct stat statBuf;
+	int zoneFile;
+
+	if ((zoneFile = open (fileName, O_RDONLY)) == -1)
+		return NULL;
+
+	if (fstat (zoneFile, &statBuf) == 0 && statBuf.st_size > 0)
+	{
+		void *mapped = mmap (NULL, statBuf.st_size, PROT_READ, MAP_PRIVATE, zoneFile, 0);
+		if (mapped != MAP_FAILED)
+		{
+			zoneData = zoneParse ((const unsigned char *)mapped, statBuf.st_size);
+			munmap (mapped, statBuf.st_size);
+		}
+	}
+	close (zoneFile);
+	return zoneData;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  Z O N E  P R E P A R E                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Load the tables for a timezone if they have not been loaded yet.
+ *  \param zone Timezone to load.
+ *  \result The tables for the zone.
+ */
+static ZONE_DATA *zonePrepare (TZ_INFO *zone)
+{
+	ZONE_DATA *current = (ZONE_DATA *)g_atomic_pointer_get (&zone -> zoneData);
+
+	if (current == NULL)
+	{
+		ZONE_DATA *zoneData = NULL;
+
+		if (zone -> value == 0)
+		{
+			zoneData = zoneLoad (ZONE_LOCAL_FILE);
+		}
+		else if (zone -> value < FIRST_CITY)
+		{
+			zoneData = &zoneGMT;
+		}
+		else
+		{
+			char fileName[PATH_MAX];
+
+			snprintf (fileName, PATH_MAX, "%s%s", ZONE_INFO_DIR, zone -> envName);
+			zoneData = zoneLoad (fileName);
+		}
+		if (zoneData == NULL)
+			zoneData = &zoneUTC;
+
+		/*--------------------------------------------------------------------------------------------*
+         * Faces can be drawn on more than one thread, if another one got here first use its tables.  *
+         *--------------------------------------------------------------------------------------------*/
+		if (g_atomic_pointer_compare_and_exchange (&zone -> zoneData, NULL, zoneData))
+		{
+			current = zoneData;
+		}
+		else
+		{
+			zoneFree (zoneData);
+			current = (ZONE_DATA *)g_atomic_pointer_get (&zone -> zoneData);
+		}
+	}
+	return current;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  Z O N E  L O C A L  T I M E                                                                                       *
+ *  ===========================                                                                                       *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Convert a time to the local time in a timezone, like localtime_r but without TZ.
+ *  \param zone Timezone to use, GMT offsets are assumed to be already added to the time.
+ *  \param t Time in seconds from 1970.
+ *  \param tm Put the time here.
+ *  \result None.
+ */
+void zoneLocalTime (TZ_INFO *zone, time_t t, struct tm *tm)
+{
+	const ZONE_DATA *zoneData;
+	const ZONE_TYPE *type;
+
+	zoneData = zonePrepare (zone);
+
+	if (zoneData -> transCount == 0 || t >= zoneData -> transTimes[zoneData -> transCount - 1])
+	{
+		if (zoneData -> hasRule)
+			type = ruleType (zoneData, t);
+		else if (zoneData -> transCount)
+			type = &zoneData -> types[zoneData -> transTypes[zoneData -> transCount - 1]];
+		else
+			type = &zoneData -> types[0];
+	}
+	else if (t < zoneData -> transTimes[0])
+	{
+		type = &zoneData -> types[0];
+	}
+	else
+	{
+		/*--------------------------------------------------------------------------------------------*
+         * Find the last transition at or before the time.                                            *
+         *--------------------------------------------------------------------------------------------*/
+		int low = 0, high = zoneData -> transCount - 1;
+
+		while (low < high)
+		{
+			int mid = (low + high + 1) >> 1;
+			if (zoneData -> transTimes[mid] <= t)
+				low = mid;
+			else
+				high = mid - 1;
+		}
+		type = &zoneData -> types[zoneData -> transTypes[low]];
+	}
+	fillBrokenTime ((int64_t)t + type -> utOffset, type, tm);
+}
+
@@ -0,0 +1,158 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  B E N C H  Z O N E . C                                                                                            *
+ *  ======================                                                                                            *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Time the face time conversion for 50 faces, the zoneinfo tables against setting TZ.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "TzClockDisp.h"
+#include "ParseZone.h"
+#include "TzClockTest.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * A tick every 50 ms for a minute                                                                    *
+ *----------------------------------------------------------------------------------------------------*/
+#define BENCH_FACES		50
+#define BENCH_TICKS		1200
+
+static TZ_INFO benchZones[BENCH_FACES] =
+{
+	{ "Europe/London", FIRST_CITY, NULL },			{ "Europe/Paris", FIRST_CITY, NULL },
+	{ "Europe/Berlin", FIRST_CITY, NULL },			{ "Europe/Madrid", FIRST_CITY, NULL },
+	{ "Europe/Rome", FIRST_CITY, NULL },			{ "Europe/Athens", FIRST_CITY, NULL },
+	{ "Europe/Helsinki", FIRST_CITY, NULL },		{ "Europe/Moscow", FIRST_CITY, NULL },
+	{ "Europe/Istanbul", FIRST_CITY, NULL },		{ "Europe/Dublin", FIRST_CITY, NULL },
+	{ "Europe/Lisbon", FIRST_CITY, NULL },			{ "Atlantic/Reykjavik", FIRST_CITY, NULL },
+	{ "Atlantic/Azores", FIRST_CITY, NULL },		{ "America/New_York", FIRST_CITY, NULL },
+	{ "America/Chicago", FIRST_CITY, NULL },		{ "America/Denver", FIRST_CITY, NULL },
+	{ "America/Phoenix", FIRST_CITY, NULL },		{ "America/Los_Angeles", FIRST_CITY, NULL },
+	{ "America/Anchorage", FIRST_CITY, NULL },		{ "Pacific/Honolulu", FIRST_CITY, NULL },
+	{ "America/Toronto", FIRST_CITY, NULL },		{ "America/Vancouver", FIRST_CITY, NULL },
+	{ "America/St_Johns", FIRST_CITY, NULL },		{ "America/Halifax", FIRST_CITY, NULL },
+	{ "America/Mexico_City", FIRST_CITY, NULL },	{ "America/Bogota", FIRST_CITY, NULL },
+	{ "America/Lima", FIRST_CITY, NULL },			{ "America/Santiago", FIRST_CITY, NULL },
+	{ "America/Sao_Paulo", FIRST_CITY, NULL },		{ "America/Argentina/Buenos_Aires", FIRST_CITY, NULL },
+	{ "America/Nuuk", FIRST_CITY, NULL },			{ "Africa/Cairo", FIRST_CITY, NULL },
+	{ "Africa/Casablanca", FIRST_CITY, NULL },		{ "Africa/Lagos", FIRST_CITY, NULL },
+	{ "Africa/Johannesburg", FIRST_CITY, NULL },	{ "Africa/Nairobi", FIRST_CITY, NULL },
+	{ "Asia/Jerusalem", FIRST_CITY, NULL },			{ "Asia/Dubai", FIRST_CITY, NULL },
+	{ "Asia/Tehran", FIRST_CITY, NULL },			{ "Asia/Karachi", FIRST_CITY, NULL },
+	{ "Asia/Kolkata", FIRST_CITY, NULL },			{ "Asia/Kathmandu", FIRST_CITY, NULL },
+	{ "Asia/Bangkok", FIRST_CITY, NULL },			{ "Asia/Shanghai", FIRST_CITY, NULL },
+	{ "Asia/Tokyo", FIRST_CITY, NULL },				{ "Asia/Seoul", FIRST_CITY, NULL },
+	{ "Australia/Sydney", FIRST_CITY, NULL },		{ "Australia/Adelaide", FIRST_CITY, NULL },
+	{ "Pacific/Auckland", FIRST_CITY, NULL },		{ "Pacific/Chatham", FIRST_CITY, NULL }
+};
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  O L D  F A C E  T I M E                                                                                           *
+ *  =======================                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief A copy of the old face time, set TZ and have libc read the zone.
+ *  \param zone Zone of the face.
+ *  \param t Time to convert.
+ *  \param tm Save the local time here.
+ *  \result None.
+ */
+static void oldFaceTime (TZ_INFO *zone, time_t t, struct tm *tm)
+{
+	setenv ("TZ", zone -> envName, 1);
+	tzset ();
+	localtime_r (&t, tm);
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Convert the time for every face on each tick, the old way and with the tables.
+ *  \result 0 if both ways gave the same times.
+ */
+int main (void)
+{
+	struct tm oldTm[BENCH_FACES], zoneTm[BENCH_FACES];
+	double start, oldFirst, oldTime, zoneFirst, zoneTime;
+	time_t startTime = 1711846800, t;
+	int i, tick, differ = 0;
+
+	if (access ("/usr/share/zoneinfo/Europe/London", R_OK) != 0)
+	{
+		printf ("benchZone: no zoneinfo, skipped\n");
+		return 0;
+	}
+
+	/*------------------------------------------------------------------------------------------------*
+     * The first tick loads the zones, so time it on its own                                          *
+     *------------------------------------------------------------------------------------------------*/
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_FACES; ++i)
+		oldFaceTime (&benchZones[i], startTime, &oldTm[i]);
+	oldFirst = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (i = 0; i < BENCH_FACES; ++i)
+		zoneLocalTime (&benchZones[i], startTime, &zoneTm[i]);
+	zoneFirst = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (tick = 0; tick < BENCH_TICKS; ++tick)
+	{
+		t = startTime + tick / 20;
+		for (i = 0; i < BENCH_FACES; ++i)
+			oldFaceTime (&benchZones[i], t, &oldTm[i]);
+	}
+	oldTime = testTimeNow () - start;
+
+	start = testTimeNow ();
+	for (tick = 0; tick < BENCH_TICKS; ++tick)
+	{
+		t = startTime + tick / 20;
+		for (i = 0; i < BENCH_FACES; ++i)
+			zoneLocalTime (&benchZones[i], t, &zoneTm[i]);
+	}
+	zoneTime = testTimeNow () - start;
+
+	for (i = 0; i < BENCH_FACES; ++i)
+	{
+		if (oldTm[i].tm_hour != zoneTm[i].tm_hour || oldTm[i].tm_min != zoneTm[i].tm_min ||
+				oldTm[i].tm_mday != zoneTm[i].tm_mday || oldTm[i].tm_gmtoff != zoneTm[i].tm_gmtoff ||
+				strcmp (oldTm[i].tm_zone, zoneTm[i].tm_zone) != 0)
+		{
+			fprintf (stderr, "%s differs\n", benchZones[i].envName);
+			++differ;
+		}
+	}
+	TEST_CHECK (differ == 0);
+
+	printf ("%d faces, %d ticks     setting TZ   zone tables\n", BENCH_FACES, BENCH_TICKS);
+	printf ("first tick          %9.3f ms  %9.3f ms\n", oldFirst * 1000, zoneFirst * 1000);
+	printf ("each tick after     %9.3f ms  %9.3f ms\n", oldTime * 1000 / BENCH_TICKS, zoneTime * 1000 / BENCH_TICKS);
+	return testResult ("benchZone");
+}
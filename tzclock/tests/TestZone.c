@@ -0,0 +1,308 @@
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  Z O N E . C                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ *  This is free software; you can redistribute it and/or modify it under the terms of the GNU General Public         *
+ *  License version 2 as published by the Free Software Foundation.  Note that I am not granting permission to        *
+ *  redistribute or modify this under the terms of any later version of the General Public License.                   *
+ *                                                                                                                    *
+ *  This is distributed in the hope that it will be useful, but WITHOUT ANY WARRANTY; without even the implied        *
+ *  warranty of MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License for more     *
+ *  details.                                                                                                          *
+ *                                                                                                                    *
+ *  You should have received a copy of the GNU General Public License along with this program (in the file            *
+ *  "COPYING"); if not, write to the Free Software Foundation, Inc., 59 Temple Place - Suite 330, Boston, MA 02111,   *
+ *  USA.                                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \file
+ *  \brief Check the zoneinfo tables give the same local times as libc does with TZ set.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+
+#include "config.h"
+#include "TzClockDisp.h"
+#include "ParseZone.h"
+#include "TzClockTest.h"
+
+/*----------------------------------------------------------------------------------------------------*
+ * Sweep from 1900 to 2100 every six hours, no zone changes its clocks twice in that time             *
+ *----------------------------------------------------------------------------------------------------*/
+#define SWEEP_START		((time_t)-2208988800LL)
+#define SWEEP_END		((time_t)4102444800LL)
+#define SWEEP_STEP		(6 * 3600)
+
+typedef struct _testKnown
+{
+	const char *envName;
+	time_t t;
+	int year, mon, mday, hour, min, sec;
+	int isDst;
+	long gmtOff;
+	const char *abbr;
+}
+TEST_KNOWN;
+
+/*----------------------------------------------------------------------------------------------------*
+ * Zones picked for their rules: southern summers, negative and half hour offsets, hours past 24      *
+ *----------------------------------------------------------------------------------------------------*/
+static TZ_INFO testZones[] =
+{
+	{	"Europe/London",		FIRST_CITY,	NULL	},
+	{	"America/New_York",		FIRST_CITY,	NULL	},
+	{	"Australia/Sydney",		FIRST_CITY,	NULL	},
+	{	"Europe/Dublin",		FIRST_CITY,	NULL	},
+	{	"America/Nuuk",			FIRST_CITY,	NULL	},
+	{	"Asia/Jerusalem",		FIRST_CITY,	NULL	},
+	{	"America/Santiago",		FIRST_CITY,	NULL	},
+	{	"Pacific/Chatham",		FIRST_CITY,	NULL	},
+	{	"Africa/Casablanca",	FIRST_CITY,	NULL	},
+	{	"America/St_Johns",		FIRST_CITY,	NULL	},
+	{	"Asia/Kolkata",			FIRST_CITY,	NULL	},
+	{	"Asia/Tehran",			FIRST_CITY,	NULL	},
+	{	"Pacific/Apia",			FIRST_CITY,	NULL	},
+	{	NULL,					0,			NULL	}
+};
+
+/*----------------------------------------------------------------------------------------------------*
+ * Each side of a change from the tables, then after 2037 where only the POSIX rule is left           *
+ *----------------------------------------------------------------------------------------------------*/
+static TEST_KNOWN knownTimes[] =
+{
+	{	"Europe/London",	1711846799,	2024,	3,	31,	0,	59,	59,	0,	0,		"GMT"	},
+	{	"Europe/London",	1711846800,	2024,	3,	31,	2,	0,	0,	1,	3600,	"BST"	},
+	{	"America/New_York",	1730613599,	2024,	11,	3,	1,	59,	59,	1,	-14400,	"EDT"	},
+	{	"America/New_York",	1730613600,	2024,	11,	3,	1,	0,	0,	0,	-18000,	"EST"	},
+	{	"Australia/Sydney",	1712419199,	2024,	4,	7,	2,	59,	59,	1,	39600,	"AEDT"	},
+	{	"Australia/Sydney",	1712419200,	2024,	4,	7,	2,	0,	0,	0,	36000,	"AEST"	},
+	{	"Europe/London",	4109878799,	2100,	3,	28,	0,	59,	59,	0,	0,		"GMT"	},
+	{	"Europe/London",	4109878800,	2100,	3,	28,	2,	0,	0,	1,	3600,	"BST"	},
+	{	"America/New_York",	3792985199,	2090,	3,	12,	1,	59,	59,	0,	-18000,	"EST"	},
+	{	"America/New_York",	3792985200,	2090,	3,	12,	3,	0,	0,	1,	-14400,	"EDT"	},
+	{	"Australia/Sydney",	3810470399,	2090,	10,	1,	1,	59,	59,	0,	36000,	"AEST"	},
+	{	"Australia/Sydney",	3810470400,	2090,	10,	1,	3,	0,	0,	1,	39600,	"AEDT"	},
+	{	NULL,				0,			0,		0,	0,	0,	0,	0,	0,	0,		NULL	}
+};
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  S A M E  T I M E                                                                                                  *
+ *  ================                                                                                                  *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Compare two broken down times, field by field.
+ *  \param tm1 First time.
+ *  \param tm2 Second time.
+ *  \result 1 if they are the same.
+ */
+static int sameTime (const struct tm *tm1, const struct tm *tm2)
+{
+	return tm1 -> tm_sec == tm2 -> tm_sec && tm1 -> tm_min == tm2 -> tm_min && tm1 -> tm_hour == tm2 -> tm_hour &&
+			tm1 -> tm_mday == tm2 -> tm_mday && tm1 -> tm_mon == tm2 -> tm_mon && tm1 -> tm_year == tm2 -> tm_year &&
+			tm1 -> tm_wday == tm2 -> tm_wday && tm1 -> tm_yday == tm2 -> tm_yday &&
+			tm1 -> tm_isdst == tm2 -> tm_isdst && tm1 -> tm_gmtoff == tm2 -> tm_gmtoff &&
+			tm1 -> tm_zone != NULL && tm2 -> tm_zone != NULL && strcmp (tm1 -> tm_zone, tm2 -> tm_zone) == 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  C H E C K  T I M E                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Convert a time both ways and say if they differ.
+ *  \param zone Zone to convert in, TZ is already set to it.
+ *  \param t Time to convert.
+ *  \result 1 if they are the same.
+ */
+static int checkTime (TZ_INFO *zone, time_t t)
+{
+	struct tm zoneTm, libcTm;
+
+	zoneLocalTime (zone, t, &zoneTm);
+	localtime_r (&t, &libcTm);
+	if (sameTime (&zoneTm, &libcTm))
+		return 1;
+
+	fprintf (stderr, "%s at %lld: %04d-%02d-%02d %02d:%02d:%02d %s, libc has %04d-%02d-%02d %02d:%02d:%02d %s\n",
+			zone -> envName, (long long)t,
+			zoneTm.tm_year + 1900, zoneTm.tm_mon + 1, zoneTm.tm_mday, zoneTm.tm_hour, zoneTm.tm_min, zoneTm.tm_sec,
+			zoneTm.tm_zone, libcTm.tm_year + 1900, libcTm.tm_mon + 1, libcTm.tm_mday, libcTm.tm_hour,
+			libcTm.tm_min, libcTm.tm_sec, libcTm.tm_zone);
+	return 0;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  F I N D  C H A N G E                                                                                              *
+ *  ====================                                                                                              *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Find the second libc changes the clocks, somewhere after the first time and by the second.
+ *  \param before Time before the change.
+ *  \param after Time after the change.
+ *  \result First second of the new local time type.
+ */
+static time_t findChange (time_t before, time_t after)
+{
+	struct tm beforeTm, midTm;
+
+	localtime_r (&before, &beforeTm);
+	while (after - before > 1)
+	{
+		time_t mid = before + (after - before) / 2;
+
+		localtime_r (&mid, &midTm);
+		if (midTm.tm_gmtoff == beforeTm.tm_gmtoff && midTm.tm_isdst == beforeTm.tm_isdst &&
+				strcmp (midTm.tm_zone, beforeTm.tm_zone) == 0)
+			before = mid;
+		else
+			after = mid;
+	}
+	return after;
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  K N O W N                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check times worked out by hand, either side of changes from the tables and from the rules.
+ *  \result None.
+ */
+static void testKnown (void)
+{
+	int i, j;
+
+	for (i = 0; knownTimes[i].envName != NULL; ++i)
+	{
+		TEST_KNOWN *known = &knownTimes[i];
+		struct tm tm;
+
+		for (j = 0; testZones[j].envName != NULL; ++j)
+		{
+			if (strcmp (testZones[j].envName, known -> envName) == 0)
+				break;
+		}
+		zoneLocalTime (&testZones[j], known -> t, &tm);
+		TEST_CHECK (tm.tm_year + 1900 == known -> year && tm.tm_mon + 1 == known -> mon &&
+				tm.tm_mday == known -> mday);
+		TEST_CHECK (tm.tm_hour == known -> hour && tm.tm_min == known -> min && tm.tm_sec == known -> sec);
+		TEST_CHECK (tm.tm_isdst == known -> isDst && tm.tm_gmtoff == known -> gmtOff);
+		TEST_CHECK (tm.tm_zone != NULL && strcmp (tm.tm_zone, known -> abbr) == 0);
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  S W E E P                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check each zone against libc from 1900 to 2100, and each side of every change libc finds.
+ *  \result None.
+ */
+static void testSweep (void)
+{
+	int i;
+
+	for (i = 0; testZones[i].envName != NULL; ++i)
+	{
+		TZ_INFO *zone = &testZones[i];
+		int failed = 0, changes = 0;
+		struct tm lastTm, libcTm;
+		time_t t, last = SWEEP_START;
+
+		setenv ("TZ", zone -> envName, 1);
+		tzset ();
+		localtime_r (&last, &lastTm);
+
+		for (t = SWEEP_START; t <= SWEEP_END && failed < 5; t += SWEEP_STEP)
+		{
+			localtime_r (&t, &libcTm);
+			if (libcTm.tm_gmtoff != lastTm.tm_gmtoff || libcTm.tm_isdst != lastTm.tm_isdst ||
+					strcmp (libcTm.tm_zone, lastTm.tm_zone) != 0)
+			{
+				time_t change = findChange (last, t);
+
+				failed += !checkTime (zone, change - 1);
+				failed += !checkTime (zone, change);
+				++changes;
+			}
+			failed += !checkTime (zone, t);
+			lastTm = libcTm;
+			last = t;
+		}
+		TEST_CHECK (failed == 0);
+		TEST_CHECK (changes > 0);
+	}
+	unsetenv ("TZ");
+	tzset ();
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  T E S T  F I X E D                                                                                                *
+ *  ==================                                                                                                *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Check the GMT offset zones and local time.
+ *  \result None.
+ */
+static void testFixed (void)
+{
+	TZ_INFO gmtZone = { "GMT/GMT + 2", GMT_ZERO + 2, NULL };
+	TZ_INFO localZone = { "Local/Time", 0, NULL };
+	time_t t = 1711846800;
+	struct tm zoneTm, libcTm;
+
+	/*------------------------------------------------------------------------------------------------*
+     * The caller adds the offset for a GMT zone, so it should come back unchanged                    *
+     *------------------------------------------------------------------------------------------------*/
+	zoneLocalTime (&gmtZone, t, &zoneTm);
+	gmtime_r (&t, &libcTm);
+	TEST_CHECK (zoneTm.tm_hour == libcTm.tm_hour && zoneTm.tm_mday == libcTm.tm_mday);
+	TEST_CHECK (zoneTm.tm_gmtoff == 0 && strcmp (zoneTm.tm_zone, "GMT") == 0);
+
+	if (access ("/etc/localtime", R_OK) == 0)
+	{
+		unsetenv ("TZ");
+		tzset ();
+		TEST_CHECK (checkTime (&localZone, t));
+	}
+}
+
+/**********************************************************************************************************************
+ *                                                                                                                    *
+ *  M A I N                                                                                                           *
+ *  =======                                                                                                           *
+ *                                                                                                                    *
+ **********************************************************************************************************************/
+/**
+ *  \brief Run the checks.
+ *  \result 0 if they all passed, 77 to skip if there is no zoneinfo.
+ */
+int main (void)
+{
+	if (access ("/usr/share/zoneinfo/Europe/London", R_OK) != 0)
+	{
+		printf ("testZone: no zoneinfo, skipped\n");
+		return 77;
+	}
+	testKnown ();
+	testSweep ();
+	testFixed ();
+	return testResult ("testZone");
+}